@@ -0,0 +1,174 @@
+#include "libunittest/allocations.hpp"
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace unittest {
+namespace core {
+
+namespace {
+
+thread_local allocationcounts* g_thread_counts = nullptr;
+
+thread_local unsigned long long g_thread_generation = 0;
+
+struct ownerentry {
+    allocationcounts* counts;
+    unsigned long long generation;
+    long long freed_elsewhere;
+};
+
+struct ownerregistry {
+    std::mutex mutex;
+    std::vector<ownerentry> entries;
+    unsigned long long generation = 0;
+};
+
+ownerregistry&
+owner_registry()
+{
+    // never destroyed as blocks may still be freed during program exit
+    static ownerregistry* registry = new ownerregistry;
+    return *registry;
+}
+
+// stops the tracking of the calling thread while the registry is accessed
+// so that growing the entries does not reenter it
+class trackingpause {
+public:
+
+    trackingpause()
+        : counts_(g_thread_counts)
+    {
+        g_thread_counts = nullptr;
+    }
+
+    ~trackingpause()
+    {
+        g_thread_counts = counts_;
+    }
+
+    trackingpause(const trackingpause&) = delete;
+
+    trackingpause&
+    operator=(const trackingpause&) = delete;
+
+private:
+    allocationcounts* counts_;
+};
+
+unsigned long long
+find_generation(allocationcounts* counts)
+{
+    trackingpause pause;
+    auto& registry = owner_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (const auto& entry : registry.entries)
+        if (entry.counts==counts)
+            return entry.generation;
+    return 0;
+}
+
+bool
+probe_allocation_tracking()
+{
+    allocationcounts counts;
+    allocationcounts* previous = g_thread_counts;
+    g_thread_counts = &counts;
+    ::operator delete(::operator new(1));
+    g_thread_counts = previous;
+    return counts.count > 0;
+}
+
+}
+
+allocationcounts::allocationcounts()
+    : measured(false), count(0), bytes(0), peak_bytes(0), live_bytes(0)
+{}
+
+bool
+is_allocation_tracking_supported()
+{
+    static const bool supported = probe_allocation_tracking();
+    return supported;
+}
+
+allocationscope::allocationscope(allocationcounts* counts)
+    : previous_(g_thread_counts), previous_generation_(g_thread_generation)
+{
+    if (counts)
+        counts->measured = is_allocation_tracking_supported();
+    g_thread_generation = counts ? find_generation(counts) : 0;
+    g_thread_counts = counts;
+}
+
+allocationscope::~allocationscope()
+{
+    g_thread_counts = previous_;
+    g_thread_generation = previous_generation_;
+}
+
+allocationowner::allocationowner(allocationcounts* counts)
+    : counts_(counts), generation_(0)
+{
+    if (counts_) {
+        trackingpause pause;
+        auto& registry = owner_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        generation_ = ++registry.generation;
+        registry.entries.push_back({counts_, generation_, 0});
+    }
+}
+
+allocationowner::~allocationowner()
+{
+    if (counts_) {
+        trackingpause pause;
+        auto& registry = owner_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (auto entry=registry.entries.begin(); entry!=registry.entries.end(); ++entry) {
+            if (entry->generation==generation_) {
+                counts_->live_bytes -= entry->freed_elsewhere;
+                registry.entries.erase(entry);
+                break;
+            }
+        }
+    }
+}
+
+allocationtag
+note_allocation(long long size) noexcept
+{
+    allocationcounts* counts = g_thread_counts;
+    if (!counts)
+        return {nullptr, 0, size};
+    ++counts->count;
+    counts->bytes += size;
+    counts->live_bytes += size;
+    if (counts->live_bytes > counts->peak_bytes)
+        counts->peak_bytes = counts->live_bytes;
+    return {counts, g_thread_generation, size};
+}
+
+void
+note_deallocation(const allocationtag& tag) noexcept
+{
+    if (!tag.owner)
+        return;
+    if (tag.owner==g_thread_counts && tag.generation==g_thread_generation) {
+        tag.owner->live_bytes -= tag.size;
+    } else if (tag.generation) {
+        trackingpause pause;
+        auto& registry = owner_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (auto& entry : registry.entries) {
+            if (entry.generation==tag.generation) {
+                entry.freed_elsewhere += tag.size;
+                break;
+            }
+        }
+    }
+}
+
+} // core
+} // unittest
@@ -60,6 +60,21 @@ argparser::was_used(char arg)
     return from_registry(arg).is_used;
 }
 
+std::vector<std::string>
+argparser::take_positionals()
+{
+    std::vector<std::string> positionals;
+    std::vector<size_t> del_indices;
+    for (size_t i=0; i<args_.size(); ++i) {
+        if (args_[i].empty() || args_[i][0]!='-') {
+            positionals.push_back(args_[i]);
+            del_indices.push_back(i);
+        }
+    }
+    remove_indices_from_args(del_indices);
+    return positionals;
+}
+
 template<>
 void
 argparser::register_argument<bool>(char arg,
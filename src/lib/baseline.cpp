@@ -0,0 +1,177 @@
+#include "libunittest/baseline.hpp"
+#include "libunittest/utilities.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+namespace unittest {
+namespace core {
+
+namespace {
+
+const std::string g_baseline_header = "# libunittest baseline 1";
+
+double
+median_of(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+    const size_t middle = values.size() / 2;
+    return values.size() % 2 ? values[middle] : (values[middle - 1] + values[middle]) / 2;
+}
+
+}
+
+benchcomparison::benchcomparison()
+    : compared(false), baseline_median(0), ratio(0), p_value(1), regressed(false)
+{}
+
+double
+mann_whitney_p_value(const std::vector<double>& first,
+                     const std::vector<double>& second)
+{
+    if (first.empty() || second.empty())
+        return 1;
+    std::vector<std::pair<double, int>> values;
+    values.reserve(first.size() + second.size());
+    for (auto value : first)
+        values.emplace_back(value, 0);
+    for (auto value : second)
+        values.emplace_back(value, 1);
+    std::sort(values.begin(), values.end());
+    const double n1 = static_cast<double>(first.size());
+    const double n2 = static_cast<double>(second.size());
+    const double n = n1 + n2;
+    // ranks averaged over ties, summed up for the second sample
+    double rank_sum = 0;
+    double ties = 0;
+    for (size_t i=0; i<values.size();) {
+        size_t j = i;
+        while (j < values.size() && values[j].first==values[i].first)
+            ++j;
+        const double rank = (i + 1 + j) / 2.;
+        for (size_t k=i; k<j; ++k)
+            if (values[k].second)
+                rank_sum += rank;
+        const double t = static_cast<double>(j - i);
+        ties += t * t * t - t;
+        i = j;
+    }
+    const double u = rank_sum - n2 * (n2 + 1) / 2;
+    const double variance = n1 * n2 / 12 * ((n + 1) - ties / (n * (n - 1)));
+    if (!(variance > 0))
+        return 1;
+    const double z = (u - n1 * n2 / 2 - 0.5) / std::sqrt(variance);
+    return 0.5 * std::erfc(z / std::sqrt(2.));
+}
+
+benchcomparison
+compare_benchmark(const std::vector<double>& baseline,
+                  const std::vector<double>& samples,
+                  double threshold,
+                  double significance)
+{
+    benchcomparison comparison;
+    if (baseline.empty() || samples.empty())
+        return comparison;
+    comparison.compared = true;
+    comparison.baseline_median = median_of(baseline);
+    comparison.ratio = comparison.baseline_median > 0 ? median_of(samples) / comparison.baseline_median : 1;
+    comparison.p_value = mann_whitney_p_value(baseline, samples);
+    comparison.regressed = comparison.p_value < significance && comparison.ratio > 1 + threshold;
+    return comparison;
+}
+
+struct benchbaseline::impl {
+
+    std::map<std::string, std::vector<double>> samples_;
+
+    impl()
+        : samples_()
+    {}
+
+};
+
+benchbaseline::benchbaseline()
+    : impl_(make_unique<impl>())
+{}
+
+benchbaseline::~benchbaseline()
+{}
+
+void
+benchbaseline::load(const std::string& filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0]=='#')
+            continue;
+        std::istringstream stream(line);
+        std::string name;
+        if (!std::getline(stream, name, '\t'))
+            continue;
+        std::vector<double> samples;
+        double sample;
+        while (stream >> sample)
+            samples.push_back(sample);
+        if (samples.size())
+            impl_->samples_[name] = samples;
+    }
+}
+
+bool
+benchbaseline::save(const std::string& filename) const
+{
+    const std::string tmp_filename = join(filename, ".tmp", now().count());
+    {
+        std::ofstream file(tmp_filename, std::ios::binary);
+        if (!file)
+            return false;
+        file << std::setprecision(9);
+        file << g_baseline_header << "\n";
+        for (const auto& pair : impl_->samples_) {
+            file << pair.first;
+            for (auto sample : pair.second)
+                file << "\t" << sample;
+            file << "\n";
+        }
+        if (!file)
+            return false;
+    }
+#ifdef _MSC_VER
+    std::remove(filename.c_str());
+#endif
+    if (std::rename(tmp_filename.c_str(), filename.c_str())!=0) {
+        std::remove(tmp_filename.c_str());
+        return false;
+    }
+    return true;
+}
+
+void
+benchbaseline::record(const std::string& full_test_name,
+                      const std::vector<double>& samples)
+{
+    if (samples.size())
+        impl_->samples_[full_test_name] = samples;
+}
+
+const std::vector<double>*
+benchbaseline::find(const std::string& full_test_name) const
+{
+    const auto element = impl_->samples_.find(full_test_name);
+    return element!=impl_->samples_.end() ? &element->second : nullptr;
+}
+
+size_t
+benchbaseline::size() const
+{
+    return impl_->samples_.size();
+}
+
+} // core
+} // unittest
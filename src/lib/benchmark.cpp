@@ -0,0 +1,359 @@
+#include "libunittest/benchmark.hpp"
+#include "libunittest/allocations.hpp"
+#include "libunittest/testsuite.hpp"
+#include "libunittest/userargs.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace unittest {
+
+benchstate::benchstate(long long iterations)
+    : benchstate(iterations, 0)
+{}
+
+benchstate::benchstate(long long iterations,
+                       long long range)
+    : iterations_(iterations), range_(range), remaining_(iterations), bytes_per_iteration_(0),
+      is_running_(false), start_(), elapsed_(std::chrono::steady_clock::duration::zero())
+{}
+
+void
+benchstate::pause_timing()
+{
+    if (is_running_) {
+        elapsed_ += std::chrono::steady_clock::now() - start_;
+        is_running_ = false;
+    }
+}
+
+void
+benchstate::resume_timing()
+{
+    if (!is_running_) {
+        is_running_ = true;
+        start_ = std::chrono::steady_clock::now();
+    }
+}
+
+long long
+benchstate::iterations() const
+{
+    return iterations_;
+}
+
+long long
+benchstate::range() const
+{
+    return range_;
+}
+
+void
+benchstate::set_bytes_per_iteration(long long bytes)
+{
+    bytes_per_iteration_ = bytes;
+}
+
+long long
+benchstate::bytes_per_iteration() const
+{
+    return bytes_per_iteration_;
+}
+
+double
+benchstate::elapsed() const
+{
+    auto elapsed = elapsed_;
+    if (is_running_)
+        elapsed += std::chrono::steady_clock::now() - start_;
+    return std::chrono::duration<double>(elapsed).count();
+}
+
+namespace core {
+
+namespace {
+
+thread_local benchresult* g_current_result = nullptr;
+
+thread_local sweepresult* g_current_sweep = nullptr;
+
+const long long g_max_iterations = 1000000000LL;
+
+const long long g_max_range = 1LL << 62;
+
+double
+run_iterations(const std::function<void(benchstate&)>& body,
+               long long iterations,
+               long long range,
+               long long& bytes_per_iteration)
+{
+    benchstate state(iterations, range);
+    body(state);
+    bytes_per_iteration = state.bytes_per_iteration();
+    return state.elapsed();
+}
+
+double
+complexity_function(complexity value,
+                    double n)
+{
+    switch (value) {
+    case complexity::constant: return 1;
+    case complexity::logarithmic: return std::max(std::log2(n), 1.);
+    case complexity::linear: return n;
+    case complexity::linearithmic: return n * std::max(std::log2(n), 1.);
+    case complexity::quadratic: return n * n;
+    }
+    return 0;
+}
+
+const double g_complexity_tolerance = 0.1;
+
+// fits log(time) = log(coefficient) + log(f(n)) and returns the rms of the residuals
+double
+fit_in_log_space(const std::vector<long long>& ranges,
+                 const std::vector<double>& times,
+                 complexity value,
+                 double& coefficient)
+{
+    std::vector<double> residuals;
+    residuals.reserve(times.size());
+    for (size_t k=0; k<times.size(); ++k)
+        if (times[k] > 0)
+            residuals.push_back(std::log(times[k] / complexity_function(value, static_cast<double>(ranges[k]))));
+    if (residuals.empty()) {
+        coefficient = 0;
+        return 0;
+    }
+    const double n = static_cast<double>(residuals.size());
+    const double mean = std::accumulate(residuals.begin(), residuals.end(), 0.) / n;
+    double squares = 0;
+    for (auto residual : residuals)
+        squares += (residual - mean) * (residual - mean);
+    coefficient = std::exp(mean);
+    return std::sqrt(squares / n);
+}
+
+}
+
+benchresult::benchresult()
+    : measured(false), iterations(0), samples(), mean(0), median(0),
+      stddev(0), min(0), throughput(0), bytes_per_second(0)
+{}
+
+benchresult
+make_benchresult(std::vector<double> samples,
+                 long long iterations,
+                 long long bytes_per_iteration)
+{
+    benchresult result;
+    if (samples.empty())
+        return result;
+    result.measured = true;
+    result.iterations = iterations;
+    const double n = static_cast<double>(samples.size());
+    result.mean = std::accumulate(samples.begin(), samples.end(), 0.) / n;
+    double squares = 0;
+    for (auto sample : samples)
+        squares += (sample - result.mean) * (sample - result.mean);
+    result.stddev = samples.size() > 1 ? std::sqrt(squares / (n - 1)) : 0.;
+    result.samples = samples;
+    std::sort(samples.begin(), samples.end());
+    const size_t middle = samples.size() / 2;
+    result.median = samples.size() % 2 ? samples[middle] : (samples[middle - 1] + samples[middle]) / 2;
+    result.min = samples.front();
+    if (result.mean > 0) {
+        result.throughput = 1. / result.mean;
+        result.bytes_per_second = bytes_per_iteration / result.mean;
+    }
+    return result;
+}
+
+sweepresult::sweepresult()
+    : measured(false), ranges(), times(), best_fit(complexity::constant),
+      coefficient(0), rms(0)
+{}
+
+std::string
+complexity_name(complexity value)
+{
+    switch (value) {
+    case complexity::constant: return "O(1)";
+    case complexity::logarithmic: return "O(log n)";
+    case complexity::linear: return "O(n)";
+    case complexity::linearithmic: return "O(n log n)";
+    case complexity::quadratic: return "O(n^2)";
+    }
+    return "";
+}
+
+bool
+complexity_from_name(const std::string& name,
+                     complexity& value)
+{
+    for (unsigned int i=0; i<=static_cast<unsigned int>(complexity::quadratic); ++i) {
+        if (name==complexity_name(static_cast<complexity>(i))) {
+            value = static_cast<complexity>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<long long>
+make_range(long long first,
+           long long last,
+           long long multiplier)
+{
+    first = std::max(first, 1LL);
+    multiplier = std::max(multiplier, 2LL);
+    std::vector<long long> ranges;
+    for (long long range=first; range<last; range*=multiplier) {
+        ranges.push_back(range);
+        if (range > g_max_range / multiplier)
+            break;
+    }
+    if (ranges.empty() || ranges.back() < last)
+        ranges.push_back(std::max(first, last));
+    return ranges;
+}
+
+sweepresult
+fit_complexity(const std::vector<long long>& ranges,
+               const std::vector<double>& times)
+{
+    sweepresult result;
+    const size_t n_points = std::min(ranges.size(), times.size());
+    if (!n_points)
+        return result;
+    result.measured = true;
+    result.ranges.assign(ranges.begin(), ranges.begin() + n_points);
+    result.times.assign(times.begin(), times.begin() + n_points);
+    for (unsigned int i=0; i<=static_cast<unsigned int>(complexity::quadratic); ++i) {
+        const auto value = static_cast<complexity>(i);
+        double coefficient = 0;
+        const double rms = fit_in_log_space(result.ranges, result.times, value, coefficient);
+        if (i==0 || rms < result.rms) {
+            result.best_fit = value;
+            result.coefficient = coefficient;
+            result.rms = rms;
+        }
+    }
+    return result;
+}
+
+double
+complexity_error(const sweepresult& sweep,
+                 complexity value)
+{
+    double coefficient = 0;
+    return fit_in_log_space(sweep.ranges, sweep.times, value, coefficient);
+}
+
+bool
+fits_complexity(const sweepresult& sweep,
+                complexity expected)
+{
+    if (!sweep.measured)
+        return false;
+    return sweep.best_fit==expected || complexity_error(sweep, expected) <= sweep.rms + g_complexity_tolerance;
+}
+
+benchresult
+measure_benchmark(const std::function<void(benchstate&)>& body,
+                  double sample_time,
+                  int n_samples)
+{
+    return measure_benchmark(body, 0, sample_time, n_samples);
+}
+
+benchresult
+measure_benchmark(const std::function<void(benchstate&)>& body,
+                  long long range,
+                  double sample_time,
+                  int n_samples)
+{
+    long long bytes_per_iteration = 0;
+    long long iterations = 1;
+    // grows the iterations until a sample takes the sample time
+    for (;;) {
+        const double elapsed = run_iterations(body, iterations, range, bytes_per_iteration);
+        if (elapsed >= sample_time || iterations >= g_max_iterations)
+            break;
+        double factor = elapsed > 0 ? 1.4 * sample_time / elapsed : 100.;
+        factor = std::min(std::max(factor, 2.), 100.);
+        iterations = std::min(static_cast<long long>(iterations * factor), g_max_iterations);
+    }
+    run_iterations(body, iterations, range, bytes_per_iteration);
+    std::vector<double> samples;
+    samples.reserve(n_samples > 0 ? n_samples : 0);
+    for (int i=0; i<n_samples; ++i)
+        samples.push_back(run_iterations(body, iterations, range, bytes_per_iteration) / iterations);
+    return make_benchresult(samples, iterations, bytes_per_iteration);
+}
+
+void
+run_benchmark(const std::function<void(benchstate&)>& body)
+{
+    const auto& args = testsuite::instance()->get_arguments();
+    record_benchmark(measure_benchmark(body, args.bench_time, args.bench_samples));
+}
+
+sweepresult
+measure_sweep(const std::function<void(benchstate&)>& body,
+              const std::vector<long long>& ranges,
+              double sample_time,
+              int n_samples)
+{
+    std::vector<double> times;
+    times.reserve(ranges.size());
+    for (auto range : ranges)
+        times.push_back(measure_benchmark(body, range, sample_time, n_samples).median);
+    return fit_complexity(ranges, times);
+}
+
+sweepresult
+run_sweep(const std::function<void(benchstate&)>& body,
+          const std::vector<long long>& ranges)
+{
+    const auto& args = testsuite::instance()->get_arguments();
+    const auto result = measure_sweep(body, ranges, args.bench_time, args.bench_samples);
+    record_sweep(result);
+    return result;
+}
+
+void
+record_benchmark(const benchresult& result)
+{
+    if (g_current_result) {
+        // the result belongs to the test log, not to the allocations of the test
+        allocationscope untracked(nullptr);
+        *g_current_result = result;
+    }
+}
+
+void
+record_sweep(const sweepresult& result)
+{
+    if (g_current_sweep) {
+        allocationscope untracked(nullptr);
+        *g_current_sweep = result;
+    }
+}
+
+benchscope::benchscope(benchresult* result,
+                       sweepresult* sweep)
+    : previous_(g_current_result), previous_sweep_(g_current_sweep)
+{
+    g_current_result = result;
+    g_current_sweep = sweep;
+}
+
+benchscope::~benchscope()
+{
+    g_current_result = previous_;
+    g_current_sweep = previous_sweep_;
+}
+
+} // core
+} // unittest
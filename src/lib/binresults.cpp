@@ -0,0 +1,640 @@
+#include "libunittest/binresults.hpp"
+#include "libunittest/teststatus.hpp"
+#include "libunittest/testfailure.hpp"
+#include "libunittest/utilities.hpp"
+#include <algorithm>
+#include <numeric>
+#include <type_traits>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <mutex>
+#include <cstdint>
+#include <cstring>
+#ifndef _MSC_VER
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace unittest {
+namespace core {
+
+namespace {
+
+const char g_magic[8] = {'L', 'U', 'T', 'B', 'R', 'E', 'S', '\0'};
+
+const std::uint32_t g_version = 1;
+
+const std::uint32_t g_byte_order = 0x01020304;
+
+struct binheader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint64_t n_records;
+    std::uint64_t n_ndfailures;
+    std::uint64_t strings_size;
+    std::int64_t timestamp;
+    std::int64_t shuffle_seed;
+    std::int32_t shard_index;
+    std::int32_t shard_count;
+    std::uint32_t suite_name;
+    std::uint32_t successful;
+    std::int64_t n_tests;
+    std::int64_t n_successes;
+    std::int64_t n_failures;
+    std::int64_t n_errors;
+    std::int64_t n_skipped;
+    std::int64_t n_timeouts;
+    double duration;
+};
+
+struct binrecord {
+    std::uint32_t class_name;
+    std::uint32_t test_name;
+    std::uint32_t method_id;
+    std::uint32_t error_type;
+    std::uint32_t message;
+    std::uint32_t assertion;
+    std::uint32_t filename;
+    std::uint32_t callsite;
+    std::uint32_t text;
+    std::int32_t linenumber;
+    std::uint8_t status;
+    std::uint8_t successful;
+    std::uint8_t has_timed_out;
+    std::uint8_t reserved;
+    std::uint32_t nd_count;
+    double duration;
+    double timeout;
+    std::uint64_t nd_first;
+};
+
+struct binfailure {
+    std::uint32_t assertion;
+    std::uint32_t message;
+    std::uint32_t filename;
+    std::uint32_t callsite;
+    std::int32_t linenumber;
+    std::uint32_t reserved;
+};
+
+static_assert(std::is_trivial<binheader>::value && sizeof(binheader)==128, "binheader must be a trivial 128 byte type");
+static_assert(std::is_trivial<binrecord>::value && sizeof(binrecord)==72, "binrecord must be a trivial 72 byte type");
+static_assert(std::is_trivial<binfailure>::value && sizeof(binfailure)==24, "binfailure must be a trivial 24 byte type");
+
+template<typename T>
+void
+write_pod(std::ostream& stream,
+          const T& value)
+{
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+T
+read_pod(const char* data)
+{
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+}
+
+struct binreader::impl {
+
+    const char* data_;
+    size_t size_;
+    std::string buffer_;
+    binheader header_;
+    const char* records_;
+    const char* failures_;
+    const char* strings_;
+
+    impl()
+        : data_(nullptr), size_(0), buffer_(), header_(),
+          records_(nullptr), failures_(nullptr), strings_(nullptr)
+    {}
+
+    ~impl()
+    {
+#ifndef _MSC_VER
+        if (data_ && buffer_.empty())
+            ::munmap(const_cast<char*>(data_), size_);
+#endif
+    }
+
+    impl(const impl&) = delete;
+
+    impl&
+    operator=(const impl&) = delete;
+
+    void
+    load(const std::string& filename)
+    {
+#ifndef _MSC_VER
+        const int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error(join("Cannot open binary results: ", filename, ": ", std::strerror(errno)));
+        struct stat info;
+        if (::fstat(fd, &info)==0 && info.st_size > 0) {
+            void* address = ::mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (address!=MAP_FAILED) {
+                data_ = static_cast<const char*>(address);
+                size_ = info.st_size;
+            }
+        }
+        ::close(fd);
+        if (data_)
+            return;
+#endif
+        std::ifstream file(filename.c_str(), std::ios::binary);
+        if (!file)
+            throw std::runtime_error(join("Cannot open binary results: ", filename));
+        std::ostringstream content;
+        content << file.rdbuf();
+        buffer_ = content.str();
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+    }
+
+    void
+    validate(const std::string& filename)
+    {
+        if (size_ < sizeof(binheader))
+            throw std::runtime_error(join("Not a binary results file: ", filename));
+        header_ = read_pod<binheader>(data_);
+        if (std::memcmp(header_.magic, g_magic, sizeof(g_magic))!=0)
+            throw std::runtime_error(join("Not a binary results file: ", filename));
+        // a stream that cannot seek gets the complete header at its end
+        size_t trailer_size = 0;
+        if (header_.version==0 && size_ >= 2 * sizeof(binheader)) {
+            const auto trailer = read_pod<binheader>(data_ + size_ - sizeof(binheader));
+            if (std::memcmp(trailer.magic, g_magic, sizeof(g_magic))==0 && trailer.version!=0) {
+                header_ = trailer;
+                trailer_size = sizeof(binheader);
+            }
+        }
+        if (header_.version==0)
+            throw std::runtime_error(join("Incomplete binary results file: ", filename));
+        if (header_.version!=g_version || header_.byte_order!=g_byte_order)
+            throw std::runtime_error(join("Unsupported binary results file: ", filename));
+        const std::uint64_t expected = sizeof(binheader) + header_.n_records * sizeof(binrecord) +
+                                       header_.n_ndfailures * sizeof(binfailure) + header_.strings_size +
+                                       trailer_size;
+        if (expected!=size_)
+            throw std::runtime_error(join("Corrupt binary results file: ", filename));
+        records_ = data_ + sizeof(binheader);
+        failures_ = records_ + header_.n_records * sizeof(binrecord);
+        strings_ = failures_ + header_.n_ndfailures * sizeof(binfailure);
+    }
+
+    std::uint32_t
+    length(std::uint32_t offset) const
+    {
+        if (offset + sizeof(std::uint32_t) > header_.strings_size)
+            throw std::runtime_error("Corrupt string table in binary results");
+        const auto length = read_pod<std::uint32_t>(strings_ + offset);
+        if (offset + sizeof(std::uint32_t) + length > header_.strings_size)
+            throw std::runtime_error("Corrupt string table in binary results");
+        return length;
+    }
+
+    std::string
+    string(std::uint32_t offset) const
+    {
+        const auto size = length(offset);
+        return std::string(strings_ + offset + sizeof(std::uint32_t), size);
+    }
+
+    void
+    assign(std::uint32_t offset,
+           std::string& value) const
+    {
+        const auto size = length(offset);
+        value.assign(strings_ + offset + sizeof(std::uint32_t), size);
+    }
+
+    binrecord
+    record(std::uint64_t index) const
+    {
+        const auto record = read_pod<binrecord>(records_ + index * sizeof(binrecord));
+        if (record.nd_first + record.nd_count > header_.n_ndfailures)
+            throw std::runtime_error("Corrupt failure records in binary results");
+        return record;
+    }
+
+    int
+    compare(std::uint32_t first,
+            std::uint32_t second) const
+    {
+        if (first==second)
+            return 0;
+        const auto first_length = length(first);
+        const auto second_length = length(second);
+        const int result = std::memcmp(strings_ + first + sizeof(std::uint32_t),
+                                       strings_ + second + sizeof(std::uint32_t),
+                                       std::min(first_length, second_length));
+        if (result!=0)
+            return result;
+        return first_length < second_length ? -1 : (first_length > second_length ? 1 : 0);
+    }
+
+};
+
+struct binwriter::impl {
+
+    std::shared_ptr<std::ostream> stream_;
+    binheader header_;
+    std::streampos header_position_;
+    std::mutex mutex_;
+    std::string strings_;
+    // an open addressing table of the offsets into the string table and the
+    // hashes of their strings, such that interning does not copy the strings
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> slots_;
+    size_t n_strings_;
+    std::vector<binfailure> failures_;
+    bool finished_;
+
+    impl(std::shared_ptr<std::ostream> stream)
+        : stream_(std::move(stream)), header_(), header_position_(-1),
+          mutex_(), strings_(), slots_(), n_strings_(0), failures_(), finished_(false)
+    {
+        intern("");
+    }
+
+    static std::uint32_t
+    hash(const char* data,
+         size_t size)
+    {
+        std::uint32_t value = 2166136261u;
+        for (size_t i=0; i<size; ++i)
+            value = (value ^ static_cast<unsigned char>(data[i])) * 16777619u;
+        return value;
+    }
+
+    void
+    grow()
+    {
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> slots(std::max<size_t>(2 * slots_.size(), 1024),
+                                                                  std::make_pair(UINT32_MAX, 0u));
+        const size_t mask = slots.size() - 1;
+        for (const auto& slot : slots_) {
+            if (slot.first==UINT32_MAX)
+                continue;
+            size_t i = slot.second & mask;
+            while (slots[i].first!=UINT32_MAX)
+                i = (i + 1) & mask;
+            slots[i] = slot;
+        }
+        slots_.swap(slots);
+    }
+
+    std::uint32_t
+    intern(const char* data,
+           size_t size)
+    {
+        if (2 * (n_strings_ + 1) > slots_.size())
+            grow();
+        const auto value_hash = hash(data, size);
+        const size_t mask = slots_.size() - 1;
+        size_t i = value_hash & mask;
+        for (; slots_[i].first!=UINT32_MAX; i = (i + 1) & mask) {
+            if (slots_[i].second!=value_hash)
+                continue;
+            const char* string = strings_.data() + slots_[i].first;
+            if (read_pod<std::uint32_t>(string)==size && std::memcmp(string + sizeof(std::uint32_t), data, size)==0)
+                return slots_[i].first;
+        }
+        const std::uint64_t offset = strings_.size();
+        if (offset + sizeof(std::uint32_t) + size > UINT32_MAX)
+            throw std::length_error("The string table of the binary results exceeds 4GiB");
+        const auto length = static_cast<std::uint32_t>(size);
+        strings_.append(reinterpret_cast<const char*>(&length), sizeof(length));
+        strings_.append(data, size);
+        slots_[i] = std::make_pair(static_cast<std::uint32_t>(offset), value_hash);
+        ++n_strings_;
+        return static_cast<std::uint32_t>(offset);
+    }
+
+    std::uint32_t
+    intern(const std::string& value)
+    {
+        return intern(value.data(), value.size());
+    }
+
+    // interns a string straight from another string table, where the empty
+    // string is the first one as well
+    std::uint32_t
+    remap(const binreader::impl& source,
+          std::uint32_t offset)
+    {
+        const auto size = source.length(offset);
+        if (!size)
+            return 0;
+        return intern(source.strings_ + offset + sizeof(std::uint32_t), size);
+    }
+
+    void
+    append(const binreader::impl& source,
+           std::uint64_t index)
+    {
+        auto record = source.record(index);
+        for (auto field : {&record.class_name, &record.test_name, &record.method_id,
+                           &record.error_type, &record.message, &record.assertion,
+                           &record.filename, &record.callsite, &record.text})
+            *field = remap(source, *field);
+        const auto nd_first = record.nd_first;
+        record.nd_first = failures_.size();
+        for (std::uint64_t j=nd_first; j<nd_first + record.nd_count; ++j) {
+            auto failure = read_pod<binfailure>(source.failures_ + j * sizeof(binfailure));
+            for (auto field : {&failure.assertion, &failure.message, &failure.filename, &failure.callsite})
+                *field = remap(source, *field);
+            failures_.push_back(failure);
+        }
+        write_pod(*stream_, record);
+        ++header_.n_records;
+    }
+
+};
+
+binwriter::binwriter(std::shared_ptr<std::ostream> stream,
+                     const std::string& suite_name,
+                     long long shuffle_seed,
+                     int shard_index,
+                     int shard_count,
+                     const std::chrono::system_clock::time_point& time_point)
+    : impl_(unittest::core::make_unique<impl>(std::move(stream)))
+{
+    auto& header = impl_->header_;
+    std::memcpy(header.magic, g_magic, sizeof(g_magic));
+    header.version = g_version;
+    header.byte_order = g_byte_order;
+    header.timestamp = std::chrono::system_clock::to_time_t(time_point);
+    header.shuffle_seed = shuffle_seed;
+    header.shard_index = shard_index;
+    header.shard_count = shard_count;
+    header.suite_name = impl_->intern(suite_name);
+    impl_->header_position_ = impl_->stream_->tellp();
+    binheader incomplete = header;
+    incomplete.version = 0;
+    write_pod(*impl_->stream_, incomplete);
+}
+
+binwriter::~binwriter()
+{}
+
+void
+binwriter::report(const testlog& log)
+{
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    if (impl_->finished_)
+        return;
+    binrecord record = binrecord();
+    record.class_name = impl_->intern(log.class_name);
+    record.test_name = impl_->intern(log.test_name);
+    record.method_id = impl_->intern(log.method_id);
+    record.error_type = impl_->intern(log.error_type);
+    record.message = impl_->intern(log.message);
+    record.assertion = impl_->intern(log.assertion);
+    record.filename = impl_->intern(log.filename);
+    record.callsite = impl_->intern(log.callsite);
+    record.text = impl_->intern(log.text);
+    record.linenumber = log.linenumber;
+    record.status = static_cast<std::uint8_t>(log.status);
+    record.successful = log.successful;
+    record.has_timed_out = log.has_timed_out;
+    record.duration = log.duration;
+    record.timeout = log.timeout;
+    record.nd_first = impl_->failures_.size();
+    record.nd_count = static_cast<std::uint32_t>(log.nd_failures.size());
+    for (const auto& failure : log.nd_failures) {
+        binfailure item = binfailure();
+        item.assertion = impl_->intern(failure.assertion());
+        item.message = impl_->intern(failure.what());
+        item.filename = impl_->intern(failure.filename());
+        item.callsite = impl_->intern(failure.callsite());
+        item.linenumber = failure.linenumber();
+        impl_->failures_.push_back(item);
+    }
+    write_pod(*impl_->stream_, record);
+    ++impl_->header_.n_records;
+}
+
+void
+binwriter::append(const binreader& reader)
+{
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    if (impl_->finished_)
+        return;
+    for (std::uint64_t i=0; i<reader.impl_->header_.n_records; ++i)
+        impl_->append(*reader.impl_, i);
+}
+
+void
+binwriter::append(const binreader& reader,
+                  size_t index)
+{
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    if (impl_->finished_)
+        return;
+    if (index >= reader.size())
+        throw std::out_of_range(join("Record index out of range: ", index));
+    impl_->append(*reader.impl_, index);
+}
+
+void
+binwriter::finish(const testresults& results)
+{
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    if (impl_->finished_)
+        return;
+    impl_->finished_ = true;
+    auto& stream = *impl_->stream_;
+    auto& header = impl_->header_;
+    for (const auto& failure : impl_->failures_)
+        write_pod(stream, failure);
+    stream.write(impl_->strings_.data(), impl_->strings_.size());
+    header.n_ndfailures = impl_->failures_.size();
+    header.strings_size = impl_->strings_.size();
+    header.successful = results.successful;
+    header.n_tests = results.n_tests;
+    header.n_successes = results.n_successes;
+    header.n_failures = results.n_failures;
+    header.n_errors = results.n_errors;
+    header.n_skipped = results.n_skipped;
+    header.n_timeouts = results.n_timeouts;
+    header.duration = results.duration;
+    const auto end = stream.tellp();
+    if (impl_->header_position_ >= 0 && end >= 0) {
+        stream.seekp(impl_->header_position_);
+        write_pod(stream, header);
+        stream.seekp(end);
+    } else {
+        write_pod(stream, header);
+    }
+    stream.flush();
+}
+
+binreader::binreader(const std::string& filename)
+    : impl_(unittest::core::make_unique<impl>())
+{
+    impl_->load(filename);
+    impl_->validate(filename);
+}
+
+binreader::~binreader()
+{}
+
+size_t
+binreader::size() const
+{
+    return static_cast<size_t>(impl_->header_.n_records);
+}
+
+testlog
+binreader::log(size_t index) const
+{
+    if (index >= size())
+        throw std::out_of_range(join("Record index out of range: ", index));
+    const auto record = impl_->record(index);
+    testlog log;
+    log.class_name = impl_->string(record.class_name);
+    log.test_name = impl_->string(record.test_name);
+    log.method_id = impl_->string(record.method_id);
+    log.error_type = impl_->string(record.error_type);
+    log.message = impl_->string(record.message);
+    log.assertion = impl_->string(record.assertion);
+    log.filename = impl_->string(record.filename);
+    log.callsite = impl_->string(record.callsite);
+    log.text = impl_->string(record.text);
+    log.linenumber = record.linenumber;
+    log.status = static_cast<teststatus>(record.status);
+    log.successful = record.successful!=0;
+    log.has_timed_out = record.has_timed_out!=0;
+    log.duration = record.duration;
+    log.timeout = record.timeout;
+    for (std::uint64_t i=record.nd_first; i<record.nd_first + record.nd_count; ++i) {
+        const auto failure = read_pod<binfailure>(impl_->failures_ + i * sizeof(binfailure));
+        log.nd_failures.push_back(testfailure(impl_->string(failure.assertion), impl_->string(failure.message),
+                                              impl_->string(failure.filename), failure.linenumber,
+                                              impl_->string(failure.callsite)));
+    }
+    return log;
+}
+
+void
+binreader::peek(size_t index,
+                testlog& log) const
+{
+    if (index >= size())
+        throw std::out_of_range(join("Record index out of range: ", index));
+    const auto record = read_pod<binrecord>(impl_->records_ + index * sizeof(binrecord));
+    impl_->assign(record.class_name, log.class_name);
+    impl_->assign(record.test_name, log.test_name);
+    log.status = static_cast<teststatus>(record.status);
+    log.successful = record.successful!=0;
+    log.has_timed_out = record.has_timed_out!=0;
+}
+
+bool
+binreader::is_same_name(size_t first,
+                        size_t second) const
+{
+    if (first >= size() || second >= size())
+        throw std::out_of_range(join("Record index out of range: ", std::max(first, second)));
+    const auto first_record = read_pod<binrecord>(impl_->records_ + first * sizeof(binrecord));
+    const auto second_record = read_pod<binrecord>(impl_->records_ + second * sizeof(binrecord));
+    return impl_->compare(first_record.class_name, second_record.class_name)==0 &&
+           impl_->compare(first_record.test_name, second_record.test_name)==0;
+}
+
+std::vector<size_t>
+binreader::sorted_by_name() const
+{
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> names(size());
+    for (size_t i=0; i<names.size(); ++i) {
+        const auto record = read_pod<binrecord>(impl_->records_ + i * sizeof(binrecord));
+        names[i] = std::make_pair(record.class_name, record.test_name);
+    }
+    std::vector<size_t> indices(names.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    std::stable_sort(indices.begin(), indices.end(), [&](size_t first, size_t second) {
+        const int result = impl_->compare(names[first].first, names[second].first);
+        if (result!=0)
+            return result < 0;
+        return impl_->compare(names[first].second, names[second].second) < 0;
+    });
+    return indices;
+}
+
+testresults
+binreader::totals() const
+{
+    const auto& header = impl_->header_;
+    testresults results;
+    results.successful = header.successful!=0;
+    results.n_tests = static_cast<long>(header.n_tests);
+    results.n_successes = static_cast<long>(header.n_successes);
+    results.n_failures = static_cast<long>(header.n_failures);
+    results.n_errors = static_cast<long>(header.n_errors);
+    results.n_skipped = static_cast<long>(header.n_skipped);
+    results.n_timeouts = static_cast<long>(header.n_timeouts);
+    results.duration = header.duration;
+    return results;
+}
+
+testresults
+binreader::results() const
+{
+    auto results = totals();
+    results.testlogs.reserve(size());
+    for (size_t i=0; i<size(); ++i)
+        results.testlogs.push_back(log(i));
+    return results;
+}
+
+std::string
+binreader::suite_name() const
+{
+    return impl_->string(impl_->header_.suite_name);
+}
+
+long long
+binreader::shuffle_seed() const
+{
+    return impl_->header_.shuffle_seed;
+}
+
+int
+binreader::shard_index() const
+{
+    return impl_->header_.shard_index;
+}
+
+int
+binreader::shard_count() const
+{
+    return impl_->header_.shard_count;
+}
+
+std::chrono::system_clock::time_point
+binreader::time_point() const
+{
+    return std::chrono::system_clock::from_time_t(static_cast<std::time_t>(impl_->header_.timestamp));
+}
+
+bool
+is_binresults(const std::string& filename)
+{
+    std::ifstream file(filename.c_str(), std::ios::binary);
+    char magic[sizeof(g_magic)];
+    return file.read(magic, sizeof(magic)) && std::memcmp(magic, g_magic, sizeof(g_magic))==0;
+}
+
+} // core
+} // unittest
@@ -0,0 +1,239 @@
+#include "libunittest/consolewriter.hpp"
+#include "libunittest/testfailure.hpp"
+#include "libunittest/utilities.hpp"
+#include <sstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <atomic>
+#include <map>
+#include <algorithm>
+#include <array>
+#include <utility>
+
+namespace unittest {
+namespace core {
+
+namespace {
+
+typedef std::chrono::steady_clock writerclock;
+
+struct heldmessage {
+    size_t class_index_;
+    std::string class_name_;
+    long sequence_;
+    std::string text_;
+};
+
+struct workerbuffer {
+    std::mutex mutex_;
+    std::string text_;
+    std::vector<heldmessage> held_;
+};
+
+std::atomic<unsigned long> g_writer_count(0);
+
+typedef std::pair<unsigned long, std::weak_ptr<workerbuffer>> bufferslot;
+
+// the buffers of the calling thread keyed by the writer they belong to. A
+// fixed number of slots so that the cache itself never allocates
+thread_local std::array<bufferslot, 4> g_thread_buffers;
+
+}
+
+struct consolewriter::impl {
+    std::ostream* stream_;
+    const bool verbose_;
+    const consolemode mode_;
+    const writerclock::duration interval_;
+    std::map<std::string, size_t> class_indices_;
+    const unsigned long id_;
+    std::mutex mutex_;
+    std::vector<std::shared_ptr<workerbuffer>> buffers_;
+    writerclock::time_point last_write_;
+    bool is_done_;
+    std::condition_variable cond_;
+    std::mutex write_mutex_;
+    std::thread thread_;
+
+    impl(std::ostream& stream,
+         bool verbose,
+         consolemode mode,
+         double interval,
+         const std::vector<std::string>& class_names)
+        : stream_(&stream), verbose_(verbose), mode_(mode),
+          interval_(std::chrono::duration_cast<writerclock::duration>(std::chrono::duration<double>(interval > 0 ? interval : 0))),
+          class_indices_(), id_(++g_writer_count), mutex_(), buffers_(),
+          last_write_(writerclock::now()), is_done_(false), cond_(),
+          write_mutex_(), thread_()
+    {
+        for (size_t i=0; i<class_names.size(); ++i)
+            class_indices_.insert(std::make_pair(class_names[i], i));
+    }
+
+    workerbuffer&
+    get_buffer()
+    {
+        bufferslot* free_slot = nullptr;
+        for (auto& slot : g_thread_buffers) {
+            if (slot.first==id_) {
+                const auto buffer = slot.second.lock();
+                if (buffer)
+                    return *buffer;
+            }
+            if (!free_slot && slot.second.expired())
+                free_slot = &slot;
+        }
+        // evicts the buffer of another writer which then gets a new one
+        if (!free_slot)
+            free_slot = &g_thread_buffers[id_ % g_thread_buffers.size()];
+        auto buffer = std::make_shared<workerbuffer>();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            buffers_.push_back(buffer);
+        }
+        *free_slot = std::make_pair(id_, buffer);
+        return *buffer;
+    }
+
+    size_t
+    class_index(const std::string& class_name) const
+    {
+        const auto iter = class_indices_.find(class_name);
+        return iter!=class_indices_.end() ? iter->second : class_indices_.size();
+    }
+
+    bool
+    is_due()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return writerclock::now() - last_write_ >= interval_;
+    }
+
+    void
+    append(const testlog& log,
+           std::string text)
+    {
+        auto& buffer = get_buffer();
+        {
+            std::lock_guard<std::mutex> lock(buffer.mutex_);
+            if (mode_==consolemode::ordered)
+                buffer.held_.push_back({class_index(log.class_name), log.class_name, log.sequence, std::move(text)});
+            else
+                buffer.text_ += text;
+        }
+        if (mode_==consolemode::buffered && !thread_.joinable() && is_due())
+            drain(false);
+    }
+
+    std::vector<std::shared_ptr<workerbuffer>>
+    get_buffers()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return buffers_;
+    }
+
+    void
+    drain(bool with_held)
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        std::string block;
+        std::vector<heldmessage> held;
+        for (const auto& buffer : get_buffers()) {
+            std::lock_guard<std::mutex> buffer_lock(buffer->mutex_);
+            block += buffer->text_;
+            buffer->text_.clear();
+            if (with_held) {
+                std::move(buffer->held_.begin(), buffer->held_.end(), std::back_inserter(held));
+                buffer->held_.clear();
+            }
+        }
+        std::stable_sort(held.begin(), held.end(), [](const heldmessage& a, const heldmessage& b) {
+            if (a.class_index_!=b.class_index_)
+                return a.class_index_ < b.class_index_;
+            if (a.class_name_!=b.class_name_)
+                return a.class_name_ < b.class_name_;
+            return a.sequence_ < b.sequence_;
+        });
+        for (const auto& message : held)
+            block += message.text_;
+        if (block.size())
+            *stream_ << block << std::flush;
+        std::lock_guard<std::mutex> time_lock(mutex_);
+        last_write_ = writerclock::now();
+    }
+
+    void
+    run()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!is_done_) {
+            cond_.wait_for(lock, interval_, [this]() { return is_done_; });
+            lock.unlock();
+            drain(false);
+            lock.lock();
+        }
+    }
+
+};
+
+consolewriter::consolewriter(std::ostream& stream,
+                             bool verbose,
+                             consolemode mode,
+                             double interval,
+                             const std::vector<std::string>& class_names,
+                             bool threaded)
+    : impl_(unittest::core::make_unique<impl>(stream, verbose, mode, interval, class_names))
+{
+    if (threaded && mode==consolemode::buffered && interval > 0)
+        impl_->thread_ = std::thread(&impl::run, impl_.get());
+}
+
+consolewriter::~consolewriter()
+{
+    if (impl_->thread_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(impl_->mutex_);
+            impl_->is_done_ = true;
+        }
+        impl_->cond_.notify_all();
+        impl_->thread_.join();
+    }
+    impl_->drain(true);
+    // releases the buffer of the calling thread instead of leaving it to the next writer
+    for (auto& slot : g_thread_buffers)
+        if (slot.first==impl_->id_)
+            slot = bufferslot();
+}
+
+void
+consolewriter::write_end(const testlog& log)
+{
+    if (impl_->mode_==consolemode::silent || log.has_timed_out)
+        return;
+    std::ostringstream stream;
+    write_test_start_message(stream, log, impl_->verbose_);
+    write_test_end_message(stream, log, impl_->verbose_);
+    impl_->append(log, stream.str());
+}
+
+void
+consolewriter::write_timeout(const testlog& log)
+{
+    if (impl_->mode_==consolemode::silent)
+        return;
+    std::ostringstream stream;
+    write_test_start_message(stream, log, impl_->verbose_);
+    write_test_timeout_message(stream, impl_->verbose_);
+    impl_->append(log, stream.str());
+}
+
+void
+consolewriter::flush()
+{
+    impl_->drain(true);
+}
+
+} // core
+} // unittest
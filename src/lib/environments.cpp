@@ -3,11 +3,23 @@
 #include "libunittest/testsuite.hpp"
 #include "libunittest/testresults.hpp"
 #include "libunittest/utilities.hpp"
+#include "libunittest/threadpool.hpp"
+#include "libunittest/testhistory.hpp"
+#include "libunittest/baseline.hpp"
+#include "libunittest/sharding.hpp"
+#include "libunittest/isolation.hpp"
 #include "libunittest/testfailure.hpp"
 #include "libunittest/quote.hpp"
+#include "libunittest/xmlreporter.hpp"
+#include "libunittest/jsonreporter.hpp"
+#include "libunittest/binresults.hpp"
+#include "libunittest/consolewriter.hpp"
+#include "libunittest/perfcounters.hpp"
+#include "libunittest/allocations.hpp"
 #include <iostream>
 #include <fstream>
 #include <random>
+#include <numeric>
 
 namespace unittest {
 
@@ -34,36 +46,157 @@ process(int argc, char **argv)
     auto suite = core::testsuite::instance();
     suite->set_arguments(arguments);
 
-    auto class_runs = suite->get_class_runs();
+    // loaded before running a worker process since it compares the benchmarks it runs
+    std::shared_ptr<core::benchbaseline> baseline;
+    if (!arguments.baseline_filename.empty()) {
+        baseline = std::make_shared<core::benchbaseline>();
+        baseline->load(arguments.baseline_filename);
+        suite->set_baseline(baseline);
+    }
+
+    if (core::is_worker_process())
+        std::exit(core::run_worker(suite->get_class_runs()));
+
+    std::shared_ptr<core::xmlreporter> xml_reporter;
+    if (arguments.generate_xml) {
+        auto file = std::make_shared<std::ofstream>(arguments.xml_filename, std::ios::binary);
+        xml_reporter = std::make_shared<core::xmlreporter>(file, arguments.suite_name, arguments.shuffle_seed,
+                                                           arguments.shard_index, arguments.shard_count);
+        suite->add_reporter(xml_reporter);
+    }
+    std::shared_ptr<core::jsonreporter> json_reporter;
+    if (!arguments.json_filename.empty()) {
+        auto file = std::make_shared<std::ofstream>(arguments.json_filename, std::ios::binary);
+        json_reporter = std::make_shared<core::jsonreporter>(file, arguments.suite_name, arguments.shuffle_seed,
+                                                             arguments.shard_index, arguments.shard_count);
+        suite->add_reporter(json_reporter);
+    }
+    std::shared_ptr<core::binwriter> binary_writer;
+    if (!arguments.binary_filename.empty()) {
+        auto file = std::make_shared<std::ofstream>(arguments.binary_filename, std::ios::binary);
+        binary_writer = std::make_shared<core::binwriter>(file, arguments.suite_name, arguments.shuffle_seed,
+                                                          arguments.shard_index, arguments.shard_count);
+        suite->add_reporter(binary_writer);
+    }
+
+    std::string reason;
+    if (arguments.perf_counters && !core::probe_perf_counters(&reason))
+        std::cout << "Warning: No hardware event counts. " << reason << std::endl;
+    if (arguments.track_allocations && !core::is_allocation_tracking_supported())
+        std::cout << "Warning: No allocation tracking, link the libunittest_allocs library" << std::endl;
+    if (baseline && !baseline->size())
+        std::cout << "Warning: No benchmarks in baseline file " << arguments.baseline_filename << std::endl;
+
+    core::testhistory history;
+    if (!arguments.history_filename.empty())
+        history.load(arguments.history_filename);
+
+    const auto& all_class_runs = suite->get_class_runs();
+    const auto& class_names = suite->get_class_names();
+    std::vector<size_t> schedule(all_class_runs.size());
+    std::iota(schedule.begin(), schedule.end(), 0);
+    if (arguments.shard_count > 1) {
+        if (arguments.verbose)
+            std::cout << "shard = " << arguments.shard_index << "/" << arguments.shard_count << std::endl;
+        // shards reading a history that other shards append to could
+        // disagree on the split, so they are only balanced by a snapshot
+        bool balanced = !arguments.balance_filename.empty();
+        if (balanced && arguments.balance_filename==arguments.history_filename) {
+            std::cout << "Warning: The history file to balance by is written by the shards, hashing the class names instead" << std::endl;
+            balanced = false;
+        }
+        core::testhistory snapshot;
+        if (balanced)
+            snapshot.load(arguments.balance_filename);
+        core::select_shard(schedule, class_names, snapshot, arguments.shard_index,
+                           arguments.shard_count, balanced, arguments.default_estimate);
+    }
     if (arguments.shuffle_seed >= 0) {
         if (arguments.verbose)
             std::cout << "shuffseed = " << arguments.shuffle_seed << std::endl;
         std::mt19937 gen(static_cast<unsigned int>(arguments.shuffle_seed));
-        std::shuffle(class_runs.begin(), class_runs.end(), gen);
+        std::shuffle(schedule.begin(), schedule.end(), gen);
+    }
+    if (arguments.concurrent_threads > 1) {
+        const auto estimates = core::order_longest_first(schedule, class_names, history, arguments.default_estimate);
+        if (arguments.verbose) {
+            std::cout << "schedule = ";
+            for (size_t i=0; i<schedule.size(); ++i) {
+                std::cout << (i ? ", " : "") << class_names[schedule[i]];
+                std::cout << " [" << estimates[i] << "s]";
+            }
+            std::cout << std::endl;
+        }
+    }
+    std::vector<std::function<void()>> class_runs;
+    std::vector<std::string> scheduled_names;
+    class_runs.reserve(schedule.size());
+    for (auto index : schedule) {
+        class_runs.push_back(all_class_runs[index]);
+        scheduled_names.push_back(class_names[index]);
     }
-    core::call_functions(class_runs, arguments.concurrent_threads);
+    auto console_mode = core::consolemode::buffered;
+    if (arguments.silent_output)
+        console_mode = core::consolemode::silent;
+    else if (arguments.ordered_output)
+        console_mode = core::consolemode::ordered;
+    // child processes are forked from the calling thread which must be the only one writing
+    const bool is_forking = arguments.worker_processes > 0 || arguments.isolate_classes;
+    auto console = std::make_shared<core::consolewriter>(std::cout, arguments.verbose, console_mode,
+                                                         arguments.console_interval, class_names, !is_forking);
+    suite->set_consolewriter(console);
 
-    const auto results = suite->get_results();
+    if (arguments.worker_processes > 0) {
+        core::call_workers(schedule, class_names, arguments.worker_processes, argv);
+    } else if (arguments.isolate_classes) {
+        core::call_isolated(class_runs, scheduled_names, arguments.concurrent_threads);
+    } else if (arguments.concurrent_threads > 1) {
+        core::threadpool pool(arguments.concurrent_threads);
+        core::call_functions(class_runs, pool);
+    } else {
+        core::call_functions(class_runs);
+    }
+
+    console->flush();
+    const auto& results = suite->update_results();
     write_error_info(std::cout, results.testlogs, results.successful);
+    const auto n_finished = results.testlogs.size();
     auto& threads = suite->get_lonely_threads();
     core::make_threads_happy(std::cout, threads, arguments.verbose);
-    const auto full_results = suite->get_results();
-
-    std::vector<core::testlog> delta_testlogs;
-    bool successful = true;
-    for (auto i=results.testlogs.size(); i<full_results.testlogs.size(); ++i) {
-        delta_testlogs.push_back(full_results.testlogs[i]);
-        if (!delta_testlogs.back().successful)
-            successful = false;
+    suite->set_consolewriter(nullptr);
+    console.reset();
+    const auto& full_results = suite->update_results();
+
+    const auto delta_testlogs = core::make_testlogview(full_results, n_finished);
+    write_error_info(std::cout, delta_testlogs, delta_testlogs.successful());
+
+    if (!arguments.history_filename.empty() && !arguments.dry_run) {
+        for (const auto& log : full_results.testlogs)
+            history.record(log);
+        history.save(arguments.history_filename);
     }
-    write_error_info(std::cout, delta_testlogs, successful);
 
-    write_summary(std::cout, full_results, arguments.shuffle_seed);
-    if (arguments.generate_xml) {
-        std::ofstream file(arguments.xml_filename);
-        write_xml(file, full_results, arguments.suite_name, arguments.shuffle_seed);
+    if (!arguments.save_baseline_filename.empty() && !arguments.dry_run) {
+        core::benchbaseline baseline;
+        baseline.load(arguments.save_baseline_filename);
+        for (const auto& log : full_results.testlogs)
+            if (log.benchmark.measured && log.successful)
+                baseline.record(core::make_full_test_name(log.class_name, log.test_name), log.benchmark.samples);
+        if (!baseline.save(arguments.save_baseline_filename))
+            std::cout << "Warning: Could not write baseline file " << arguments.save_baseline_filename << std::endl;
     }
 
+    if (arguments.track_allocations)
+        write_leak_info(std::cout, full_results.testlogs);
+    write_bench_info(std::cout, full_results.testlogs);
+    write_summary(std::cout, full_results, arguments.shuffle_seed);
+    if (xml_reporter)
+        xml_reporter->finish(full_results);
+    if (json_reporter)
+        json_reporter->finish(full_results);
+    if (binary_writer)
+        binary_writer->finish(full_results);
+
     return full_results.successful ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 
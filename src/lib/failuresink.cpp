@@ -0,0 +1,104 @@
+#include "libunittest/failuresink.hpp"
+#include "libunittest/utilities.hpp"
+#include <atomic>
+#include <algorithm>
+
+namespace unittest {
+namespace core {
+
+namespace {
+
+thread_local const std::shared_ptr<failuresink>* g_current_sink = nullptr;
+
+}
+
+struct failuresink::impl {
+
+    struct node {
+        testfailure failure_;
+        node* next_;
+    };
+
+    std::string method_id_;
+    std::atomic<node*> head_;
+
+    explicit
+    impl(const std::string& method_id)
+        : method_id_(method_id), head_(nullptr)
+    {}
+
+    node*
+    release()
+    {
+        return head_.exchange(nullptr);
+    }
+
+};
+
+failuresink::failuresink(const std::string& method_id)
+    : impl_(unittest::core::make_unique<impl>(method_id))
+{}
+
+failuresink::~failuresink()
+{
+    auto head = impl_->release();
+    while (head) {
+        auto next = head->next_;
+        delete head;
+        head = next;
+    }
+}
+
+const std::string&
+failuresink::method_id() const
+{
+    return impl_->method_id_;
+}
+
+void
+failuresink::push(const testfailure& failure)
+{
+    auto item = new impl::node{failure, impl_->head_.load()};
+    while (!impl_->head_.compare_exchange_weak(item->next_, item));
+}
+
+std::vector<testfailure>
+failuresink::take()
+{
+    std::vector<testfailure> failures;
+    auto head = impl_->release();
+    while (head) {
+        failures.push_back(head->failure_);
+        auto next = head->next_;
+        delete head;
+        head = next;
+    }
+    std::reverse(failures.begin(), failures.end());
+    return failures;
+}
+
+failuresink*
+failuresink::current()
+{
+    return g_current_sink ? g_current_sink->get() : nullptr;
+}
+
+std::shared_ptr<failuresink>
+failuresink::acquire()
+{
+    return g_current_sink ? *g_current_sink : nullptr;
+}
+
+failurescope::failurescope(std::shared_ptr<failuresink> sink)
+    : sink_(std::move(sink)), previous_(g_current_sink)
+{
+    g_current_sink = &sink_;
+}
+
+failurescope::~failurescope()
+{
+    g_current_sink = previous_;
+}
+
+} // core
+} // unittest
@@ -0,0 +1,766 @@
+#include "libunittest/isolation.hpp"
+#include "libunittest/testsuite.hpp"
+#include "libunittest/testlog.hpp"
+#include "libunittest/testfailure.hpp"
+#include "libunittest/teststatus.hpp"
+#include "libunittest/utilities.hpp"
+#include <iostream>
+#include <sstream>
+#include <deque>
+#include <map>
+#include <set>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <stdexcept>
+#ifndef _MSC_VER
+#include <cerrno>
+#include <csignal>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#endif
+
+namespace unittest {
+namespace core {
+
+namespace {
+
+bool g_isolated_child = false;
+
+const char* const g_worker_variable = "UNITTEST_WORKER";
+
+#ifndef _MSC_VER
+
+const size_t g_record_header_size = 1 + sizeof(std::uint32_t);
+
+void
+write_all(int fd,
+          const char* data,
+          size_t size)
+{
+    while (size) {
+        const ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno==EINTR)
+                continue;
+            return;
+        }
+        data += written;
+        size -= written;
+    }
+}
+
+bool
+read_all(int fd,
+         char* data,
+         size_t size)
+{
+    while (size) {
+        const ssize_t received = ::read(fd, data, size);
+        if (received < 0 && errno==EINTR)
+            continue;
+        if (received <= 0)
+            return false;
+        data += received;
+        size -= received;
+    }
+    return true;
+}
+
+void
+send_record(int fd,
+            char kind,
+            const std::string& payload)
+{
+    const std::uint32_t size = static_cast<std::uint32_t>(payload.size());
+    std::string record(1, kind);
+    record.append(reinterpret_cast<const char*>(&size), sizeof(size));
+    record += payload;
+    write_all(fd, record.data(), record.size());
+}
+
+bool
+receive_record(int fd,
+               char& kind,
+               std::string& payload)
+{
+    char header[g_record_header_size];
+    if (!read_all(fd, header, sizeof(header)))
+        return false;
+    kind = header[0];
+    std::uint32_t size;
+    std::memcpy(&size, header + 1, sizeof(size));
+    payload.resize(size);
+    return size==0 || read_all(fd, &payload[0], size);
+}
+
+char
+record_kind(testevent event)
+{
+    switch (event) {
+    case testevent::started: return 'S';
+    case testevent::timed_out: return 'T';
+    case testevent::finished: return 'E';
+    }
+    return 'E';
+}
+
+// with -K a test exceeding its timeout keeps running as in a single process,
+// so its log has to be sent before the class run is reported as done
+void
+join_lonely_threads(testsuite* suite)
+{
+    for (auto& thread : suite->get_lonely_threads())
+        if (thread.first.joinable())
+            thread.first.join();
+}
+
+bool
+next_record(std::string& buffer,
+            char& kind,
+            std::string& payload)
+{
+    if (buffer.size() < g_record_header_size)
+        return false;
+    std::uint32_t size;
+    std::memcpy(&size, buffer.data() + 1, sizeof(size));
+    if (buffer.size() < g_record_header_size + size)
+        return false;
+    kind = buffer[0];
+    payload = buffer.substr(g_record_header_size, size);
+    buffer.erase(0, g_record_header_size + size);
+    return true;
+}
+
+std::string
+describe_exit_status(int status)
+{
+    if (WIFSIGNALED(status)) {
+        const int signal = WTERMSIG(status);
+        return join("Test process terminated by signal ", signal, " (", strsignal(signal), ")");
+    } else {
+        return join("Test process exited with status ", WEXITSTATUS(status));
+    }
+}
+
+void
+flush_all()
+{
+    std::cout << std::flush;
+    std::cerr << std::flush;
+    std::fflush(nullptr);
+}
+
+#endif
+
+#ifdef __linux__
+
+// room for the stacks of threads and the arenas of malloc created by a test
+const long long g_address_space_headroom = 64LL << 20;
+
+long long
+current_address_space()
+{
+    std::FILE* file = std::fopen("/proc/self/statm", "r");
+    if (!file)
+        return -1;
+    long long pages = -1;
+    if (std::fscanf(file, "%lld", &pages)!=1)
+        pages = -1;
+    std::fclose(file);
+    return pages < 0 ? -1 : pages * ::sysconf(_SC_PAGESIZE);
+}
+
+#endif
+
+}
+
+#ifndef _MSC_VER
+
+/**
+ * @brief Runs test classes in child processes and collects their test logs.
+ *  Children are either forked per class run or long-lived workers which
+ *  re-execute the test application and receive class indices as commands.
+ *  Both report back through the same record protocol: 'S' (test started),
+ *  'T' (test timed out) and 'E' (test finished) carrying serialized test
+ *  logs, and 'D' (class run done). The logs of a class are collected once
+ *  the class is done and in the order the classes were given, as in a
+ *  single process
+ */
+class processrunner {
+public:
+
+    processrunner(const std::vector<std::function<void()>>* class_runs,
+                  char** argv,
+                  const std::vector<std::string>& class_names,
+                  int n_processes)
+        : suite_(testsuite::instance()),
+          class_runs_(class_runs),
+          argv_(argv),
+          class_names_(class_names),
+          n_processes_(n_processes > 0 ? n_processes : 1),
+          kill_timeouts_(!suite_->get_arguments().keep_timeouts),
+          pending_(),
+          children_(),
+          done_(class_names.size()),
+          order_(),
+          n_released_(0),
+          is_complete_(class_names.size(), false),
+          held_(class_names.size())
+    {}
+
+    void
+    run(const std::vector<size_t>& class_indices)
+    {
+        pending_.assign(class_indices.begin(), class_indices.end());
+        order_ = class_indices;
+        const auto previous_handler = std::signal(SIGPIPE, SIG_IGN);
+        while (!pending_.empty() || is_busy()) {
+            dispatch();
+            poll_children();
+        }
+        for (auto& child : children_) {
+            if (child.command_fd >= 0)
+                ::close(child.command_fd);
+            child.command_fd = -1;
+        }
+        while (!children_.empty())
+            poll_children();
+        std::signal(SIGPIPE, previous_handler);
+        for (auto index : order_)
+            is_complete_[index] = true;
+        release();
+    }
+
+    static int
+    serve(const std::vector<std::function<void()>>& class_runs,
+          int command_fd,
+          int record_fd)
+    {
+        g_isolated_child = true;
+        auto suite = testsuite::instance();
+        suite->remove_reporters();
+        suite->silence_console();
+        set_record_listener(suite, record_fd);
+        char kind;
+        std::string payload;
+        while (receive_record(command_fd, kind, payload)) {
+            std::istringstream stream(payload);
+            size_t index = 0;
+            int keep_running = 1;
+            stream >> index >> keep_running;
+            std::set<std::string> excluded;
+            std::string method_id;
+            while (stream >> method_id)
+                excluded.insert(method_id);
+            if (index >= class_runs.size())
+                break;
+            if (!keep_running) {
+                // a failing log stops running tests given failure_stop is set
+                testlog log;
+                log.status = teststatus::error;
+                suite->make_keep_running(log);
+            }
+            suite->set_excluded_tests(excluded);
+            try {
+                class_runs[index]();
+            } catch (...) {
+                flush_all();
+                ::_exit(EXIT_FAILURE);
+            }
+            join_lonely_threads(suite);
+            flush_all();
+            send_record(record_fd, 'D', "");
+        }
+        flush_all();
+        return EXIT_SUCCESS;
+    }
+
+private:
+
+    struct runningtest {
+        testlog log;
+        std::chrono::microseconds started;
+    };
+
+    struct childprocess {
+        pid_t pid;
+        int record_fd;
+        int command_fd;
+        bool is_busy;
+        size_t class_index;
+        std::string buffer;
+        std::map<std::string, runningtest> running;
+        bool is_killed;
+    };
+
+    static void
+    set_record_listener(testsuite* suite,
+                        int fd)
+    {
+        suite->set_listener([fd](const testlog& log, testevent event) {
+            send_record(fd, record_kind(event), serialize_testlog(log));
+        });
+    }
+
+    bool
+    is_busy() const
+    {
+        for (const auto& child : children_)
+            if (child.is_busy)
+                return true;
+        return false;
+    }
+
+    void
+    dispatch()
+    {
+        if (argv_) {
+            while (!pending_.empty() && static_cast<int>(children_.size()) < n_processes_)
+                spawn_worker();
+            for (auto& child : children_) {
+                if (!child.is_busy && !pending_.empty()) {
+                    assign(child, pending_.front());
+                    pending_.pop_front();
+                    std::ostringstream command;
+                    command << child.class_index << " " << suite_->is_keep_running();
+                    for (const auto& method_id : done_[child.class_index])
+                        command << " " << method_id;
+                    send_record(child.command_fd, 'R', command.str());
+                }
+            }
+        } else {
+            while (!pending_.empty() && static_cast<int>(children_.size()) < n_processes_) {
+                fork_child(pending_.front());
+                pending_.pop_front();
+            }
+        }
+    }
+
+    void
+    assign(childprocess& child,
+           size_t class_index)
+    {
+        child.is_busy = true;
+        child.class_index = class_index;
+        child.running.clear();
+        child.is_killed = false;
+    }
+
+    void
+    add_child(pid_t pid,
+              int record_fd,
+              int command_fd)
+    {
+        childprocess child;
+        child.pid = pid;
+        child.record_fd = record_fd;
+        child.command_fd = command_fd;
+        child.is_busy = false;
+        child.class_index = 0;
+        child.is_killed = false;
+        children_.push_back(std::move(child));
+    }
+
+    void
+    close_inherited_fds()
+    {
+        for (const auto& child : children_) {
+            ::close(child.record_fd);
+            if (child.command_fd >= 0)
+                ::close(child.command_fd);
+        }
+    }
+
+    void
+    fork_child(size_t class_index)
+    {
+        int records[2];
+        if (::pipe(records)!=0)
+            throw std::runtime_error(join("pipe() failed: ", std::strerror(errno)));
+        flush_all();
+        suite_->set_excluded_tests(done_[class_index]);
+        const pid_t pid = ::fork();
+        if (pid < 0) {
+            ::close(records[0]);
+            ::close(records[1]);
+            throw std::runtime_error(join("fork() failed: ", std::strerror(errno)));
+        }
+        if (pid==0) {
+            ::close(records[0]);
+            close_inherited_fds();
+            g_isolated_child = true;
+            const int fd = records[1];
+            suite_->remove_reporters();
+            suite_->silence_console();
+            set_record_listener(suite_, fd);
+            try {
+                (*class_runs_)[class_index]();
+            } catch (...) {
+                flush_all();
+                ::_exit(EXIT_FAILURE);
+            }
+            join_lonely_threads(suite_);
+            flush_all();
+            send_record(fd, 'D', "");
+            ::_exit(EXIT_SUCCESS);
+        }
+        ::close(records[1]);
+        add_child(pid, records[0], -1);
+        assign(children_.back(), class_index);
+    }
+
+    void
+    spawn_worker()
+    {
+        int commands[2];
+        int records[2];
+        if (::pipe(commands)!=0)
+            throw std::runtime_error(join("pipe() failed: ", std::strerror(errno)));
+        if (::pipe(records)!=0) {
+            ::close(commands[0]);
+            ::close(commands[1]);
+            throw std::runtime_error(join("pipe() failed: ", std::strerror(errno)));
+        }
+        flush_all();
+        const pid_t pid = ::fork();
+        if (pid < 0) {
+            for (int fd : {commands[0], commands[1], records[0], records[1]})
+                ::close(fd);
+            throw std::runtime_error(join("fork() failed: ", std::strerror(errno)));
+        }
+        if (pid==0) {
+            ::close(commands[1]);
+            ::close(records[0]);
+            close_inherited_fds();
+            const std::string value = join(commands[0], ",", records[1]);
+            ::setenv(g_worker_variable, value.c_str(), 1);
+            ::execv("/proc/self/exe", argv_);
+            ::execvp(argv_[0], argv_);
+            ::_exit(127);
+        }
+        ::close(commands[0]);
+        ::close(records[1]);
+        add_child(pid, records[0], commands[1]);
+    }
+
+    void
+    finish(size_t class_index,
+           const testlog& log)
+    {
+        if (!done_[class_index].insert(log.method_id).second)
+            return;
+        if (log.status!=teststatus::skipped) {
+            suite_->stop_timing();
+            suite_->make_keep_running(log);
+        }
+        held_[class_index].push_back(log);
+    }
+
+    void
+    complete(size_t class_index)
+    {
+        is_complete_[class_index] = true;
+        release();
+    }
+
+    void
+    release()
+    {
+        while (n_released_ < order_.size() && is_complete_[order_[n_released_]]) {
+            auto& logs = held_[order_[n_released_]];
+            for (auto& log : logs)
+                suite_->collect(std::move(log));
+            logs.clear();
+            ++n_released_;
+        }
+    }
+
+    void
+    handle_record(childprocess& child,
+                  char kind,
+                  const std::string& payload)
+    {
+        if (kind=='D') {
+            child.is_busy = false;
+            child.running.clear();
+            complete(child.class_index);
+            return;
+        }
+        testlog log;
+        if (!deserialize_testlog(payload, log))
+            return;
+        if (kind=='S') {
+            suite_->start_timing();
+            child.running[log.method_id] = {log, now()};
+            suite_->notify_start(log);
+        } else if (kind=='T') {
+            suite_->write_test_timeout(log);
+        } else if (kind=='E') {
+            if (child.running.erase(log.method_id))
+                suite_->write_test_end(log);
+            finish(child.class_index, log);
+        }
+    }
+
+    bool
+    has_exceeded_timeout(const runningtest& test,
+                         std::chrono::microseconds current) const
+    {
+        return test.log.timeout > 0 && duration_in_seconds(current - test.started) > test.log.timeout;
+    }
+
+    void
+    reap(childprocess& child)
+    {
+        ::close(child.record_fd);
+        if (child.command_fd >= 0)
+            ::close(child.command_fd);
+        int status = 0;
+        while (::waitpid(child.pid, &status, 0) < 0 && errno==EINTR);
+        if (!child.is_busy)
+            return;
+        if (!child.running.empty()) {
+            const auto current = now();
+            for (const auto& element : child.running) {
+                testlog log = element.second.log;
+                log.duration = duration_in_seconds(current - element.second.started);
+                if (child.is_killed) {
+                    // a test killed for its timeout counts as a timeout like
+                    // in a single process, tests killed along are run again
+                    if (!has_exceeded_timeout(element.second, current))
+                        continue;
+                    log.status = teststatus::success;
+                    log.successful = true;
+                    log.has_timed_out = true;
+                    log.message = join("Test process killed after exceeding the timeout of ", log.timeout, "s");
+                    suite_->write_test_timeout(log);
+                } else {
+                    log.status = teststatus::error;
+                    log.successful = false;
+                    log.error_type = "crash";
+                    log.message = describe_exit_status(status);
+                    suite_->write_test_end(log);
+                }
+                finish(child.class_index, log);
+            }
+            pending_.push_front(child.class_index);
+        } else {
+            testlog log;
+            log.class_name = class_names_[child.class_index];
+            log.test_name = "(process)";
+            log.method_id = join(log.class_name, "::", log.test_name);
+            log.status = teststatus::error;
+            log.successful = false;
+            log.error_type = "crash";
+            log.message = describe_exit_status(status);
+            suite_->write_test_end(log);
+            finish(child.class_index, log);
+            complete(child.class_index);
+        }
+    }
+
+    int
+    poll_timeout() const
+    {
+        if (!kill_timeouts_)
+            return -1;
+        double remaining = -1;
+        const auto current = now();
+        for (const auto& child : children_) {
+            if (child.is_killed)
+                continue;
+            for (const auto& element : child.running) {
+                const auto& test = element.second;
+                if (test.log.timeout > 0) {
+                    const double left = test.log.timeout - duration_in_seconds(current - test.started);
+                    if (remaining < 0 || left < remaining)
+                        remaining = left;
+                }
+            }
+        }
+        if (remaining < 0)
+            return -1;
+        return static_cast<int>(remaining * 1000) + 1;
+    }
+
+    void
+    poll_children()
+    {
+        std::vector<pollfd> pollfds;
+        for (const auto& child : children_)
+            pollfds.push_back({child.record_fd, POLLIN, 0});
+        if (::poll(pollfds.data(), pollfds.size(), poll_timeout()) < 0 && errno!=EINTR)
+            throw std::runtime_error(join("poll() failed: ", std::strerror(errno)));
+        for (size_t i=children_.size(); i-->0;) {
+            auto& child = children_[i];
+            bool is_closed = false;
+            if (pollfds[i].revents) {
+                char buffer[65536];
+                const ssize_t size = ::read(child.record_fd, buffer, sizeof(buffer));
+                if (size > 0) {
+                    child.buffer.append(buffer, size);
+                    char kind;
+                    std::string payload;
+                    while (next_record(child.buffer, kind, payload))
+                        handle_record(child, kind, payload);
+                } else if (size==0 || errno!=EINTR) {
+                    is_closed = true;
+                }
+            }
+            if (!is_closed && kill_timeouts_ && !child.is_killed) {
+                const auto current = now();
+                for (const auto& element : child.running) {
+                    if (has_exceeded_timeout(element.second, current)) {
+                        ::kill(child.pid, SIGKILL);
+                        child.is_killed = true;
+                        break;
+                    }
+                }
+            }
+            if (is_closed) {
+                reap(child);
+                children_.erase(children_.begin() + i);
+            }
+        }
+    }
+
+    testsuite* suite_;
+    const std::vector<std::function<void()>>* class_runs_;
+    char** argv_;
+    const std::vector<std::string>& class_names_;
+    int n_processes_;
+    bool kill_timeouts_;
+    std::deque<size_t> pending_;
+    std::vector<childprocess> children_;
+    std::vector<std::set<std::string>> done_;
+    std::vector<size_t> order_;
+    size_t n_released_;
+    std::vector<bool> is_complete_;
+    std::vector<std::vector<testlog>> held_;
+};
+
+#endif
+
+bool
+is_isolated_child()
+{
+    return g_isolated_child;
+}
+
+bool
+is_killed_on_timeout()
+{
+    return g_isolated_child && !testsuite::instance()->get_arguments().keep_timeouts;
+}
+
+#ifdef __linux__
+
+addressspacelimit::addressspacelimit(long long memory_budget)
+    : is_set_(false), previous_(0)
+{
+    // concurrent tests would replace each other's limit
+    if (memory_budget <= 0 || !is_isolated_child() || testsuite::instance()->get_arguments().parallel_methods)
+        return;
+    const long long size = current_address_space();
+    struct rlimit limit;
+    if (size < 0 || ::getrlimit(RLIMIT_AS, &limit)!=0)
+        return;
+    const rlim_t wanted = static_cast<rlim_t>(size + memory_budget + g_address_space_headroom);
+    if (limit.rlim_cur!=RLIM_INFINITY && limit.rlim_cur <= wanted)
+        return;
+    previous_ = static_cast<unsigned long long>(limit.rlim_cur);
+    limit.rlim_cur = limit.rlim_max!=RLIM_INFINITY && limit.rlim_max < wanted ? limit.rlim_max : wanted;
+    is_set_ = ::setrlimit(RLIMIT_AS, &limit)==0;
+}
+
+addressspacelimit::~addressspacelimit()
+{
+    if (!is_set_)
+        return;
+    struct rlimit limit;
+    if (::getrlimit(RLIMIT_AS, &limit)==0) {
+        limit.rlim_cur = static_cast<rlim_t>(previous_);
+        ::setrlimit(RLIMIT_AS, &limit);
+    }
+}
+
+#else
+
+addressspacelimit::addressspacelimit(long long memory_budget)
+    : is_set_(false), previous_(0)
+{
+    (void)memory_budget;
+}
+
+addressspacelimit::~addressspacelimit()
+{}
+
+#endif
+
+void
+call_isolated(const std::vector<std::function<void()>>& class_runs,
+              const std::vector<std::string>& class_names,
+              int n_children)
+{
+#ifdef _MSC_VER
+    (void)class_names;
+    (void)n_children;
+    call_functions(class_runs);
+#else
+    std::vector<size_t> class_indices(class_runs.size());
+    for (size_t i=0; i<class_indices.size(); ++i)
+        class_indices[i] = i;
+    processrunner runner(&class_runs, nullptr, class_names, n_children);
+    runner.run(class_indices);
+#endif
+}
+
+void
+call_workers(const std::vector<size_t>& class_indices,
+             const std::vector<std::string>& class_names,
+             int n_workers,
+             char** argv)
+{
+#ifdef _MSC_VER
+    (void)class_indices;
+    (void)class_names;
+    (void)n_workers;
+    (void)argv;
+    throw std::runtime_error("Worker processes are not supported on this platform");
+#else
+    processrunner runner(nullptr, argv, class_names, n_workers);
+    runner.run(class_indices);
+#endif
+}
+
+bool
+is_worker_process()
+{
+    return std::getenv(g_worker_variable)!=nullptr;
+}
+
+int
+run_worker(const std::vector<std::function<void()>>& class_runs)
+{
+#ifdef _MSC_VER
+    (void)class_runs;
+    return EXIT_FAILURE;
+#else
+    const char* value = std::getenv(g_worker_variable);
+    int command_fd = -1;
+    int record_fd = -1;
+    if (!value || std::sscanf(value, "%d,%d", &command_fd, &record_fd)!=2)
+        return EXIT_FAILURE;
+    ::unsetenv(g_worker_variable);
+    return processrunner::serve(class_runs, command_fd, record_fd);
+#endif
+}
+
+} // core
+} // unittest
@@ -0,0 +1,190 @@
+#include "libunittest/jsonreporter.hpp"
+#include "libunittest/teststatus.hpp"
+#include "libunittest/testfailure.hpp"
+#include "libunittest/utilities.hpp"
+#include <sstream>
+#include <mutex>
+
+namespace unittest {
+namespace core {
+
+namespace {
+
+const std::streamoff g_max_buffer_size = 1 << 16;
+
+const std::chrono::microseconds g_flush_interval = std::chrono::seconds(1);
+
+const char*
+status_name(teststatus status)
+{
+    switch (status) {
+    case teststatus::success: return "success";
+    case teststatus::failure: return "failure";
+    case teststatus::error: return "error";
+    default: return "skipped";
+    }
+}
+
+void
+write_test_names(std::ostream& stream,
+                 const testlog& log)
+{
+    stream << "\"class\":\"" << json_escape(log.class_name);
+    stream << "\",\"test\":\"" << json_escape(log.test_name) << "\"";
+}
+
+void
+write_failure_event(std::ostream& stream,
+                    const testlog& log,
+                    const std::string& type,
+                    const std::string& message,
+                    const std::string& assertion,
+                    const std::string& filename,
+                    int linenumber,
+                    const std::string& callsite)
+{
+    stream << "{\"event\":\"failure\",";
+    write_test_names(stream, log);
+    stream << ",\"type\":\"" << json_escape(type);
+    stream << "\",\"message\":\"" << json_escape(trim(message)) << "\"";
+    if (!assertion.empty())
+        stream << ",\"assertion\":\"" << json_escape(trim(assertion)) << "\"";
+    if (!filename.empty())
+        stream << ",\"file\":\"" << json_escape(trim(filename)) << "\"";
+    if (linenumber > -1)
+        stream << ",\"line\":" << linenumber;
+    if (!callsite.empty())
+        stream << ",\"callsite\":\"" << json_escape(trim(callsite)) << "\"";
+    stream << "}\n";
+}
+
+}
+
+struct jsonreporter::impl {
+
+    std::shared_ptr<std::ostream> stream_;
+    std::mutex mutex_;
+    std::ostringstream buffer_;
+    std::chrono::microseconds last_flush_;
+    bool finished_;
+
+    explicit
+    impl(std::shared_ptr<std::ostream> stream)
+        : stream_(std::move(stream)), mutex_(), buffer_(),
+          last_flush_(now()), finished_(false)
+    {
+        buffer_.setf(std::ios_base::fixed);
+    }
+
+    void
+    flush()
+    {
+        const auto data = buffer_.str();
+        stream_->write(data.data(), data.size());
+        stream_->flush();
+        buffer_.str("");
+        last_flush_ = now();
+    }
+
+    void
+    flush_if_due()
+    {
+        if (buffer_.tellp() > g_max_buffer_size || now() - last_flush_ >= g_flush_interval)
+            flush();
+    }
+
+};
+
+jsonreporter::jsonreporter(std::shared_ptr<std::ostream> stream,
+                           const std::string& suite_name,
+                           long long shuffle_seed,
+                           int shard_index,
+                           int shard_count,
+                           const std::chrono::system_clock::time_point& time_point,
+                           bool local_time)
+    : impl_(unittest::core::make_unique<impl>(std::move(stream)))
+{
+    auto& buffer = impl_->buffer_;
+    buffer << "{\"event\":\"suite_start\",\"suite\":\"" << json_escape(trim(suite_name));
+    buffer << "\",\"timestamp\":\"" << make_iso_timestamp(time_point, local_time) << "\"";
+    if (shuffle_seed >= 0)
+        buffer << ",\"shuffseed\":" << shuffle_seed;
+    if (shard_count > 1)
+        buffer << ",\"shard\":" << shard_index << ",\"shards\":" << shard_count;
+    buffer << "}\n";
+    impl_->flush();
+}
+
+jsonreporter::~jsonreporter()
+{
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    impl_->flush();
+}
+
+void
+jsonreporter::start(const testlog& log)
+{
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    if (impl_->finished_)
+        return;
+    auto& buffer = impl_->buffer_;
+    buffer << "{\"event\":\"test_start\",";
+    write_test_names(buffer, log);
+    if (log.timeout > 0)
+        buffer << ",\"timeout\":" << log.timeout;
+    buffer << "}\n";
+    impl_->flush_if_due();
+}
+
+void
+jsonreporter::report(const testlog& log)
+{
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    if (impl_->finished_)
+        return;
+    auto& buffer = impl_->buffer_;
+    for (const auto& failure : log.nd_failures)
+        write_failure_event(buffer, log, "testfailure (non-deadly)", failure.what(), failure.assertion(),
+                            failure.filename(), failure.linenumber(), failure.callsite());
+    if (!log.error_type.empty()) {
+        const bool is_failure = log.error_type=="testfailure";
+        write_failure_event(buffer, log, log.error_type, log.message, is_failure ? log.assertion : "",
+                            is_failure ? log.filename : "", is_failure ? log.linenumber : -1,
+                            is_failure ? log.callsite : "");
+    }
+    if (log.has_timed_out) {
+        buffer << "{\"event\":\"timeout\",";
+        write_test_names(buffer, log);
+        buffer << ",\"timeout\":" << log.timeout << "}\n";
+    }
+    buffer << "{\"event\":\"test_end\",";
+    write_test_names(buffer, log);
+    buffer << ",\"status\":\"" << status_name(log.status) << "\"";
+    buffer << ",\"duration\":" << log.duration;
+    if (!log.text.empty())
+        buffer << ",\"text\":\"" << json_escape(trim(log.text)) << "\"";
+    buffer << "}\n";
+    impl_->flush_if_due();
+}
+
+void
+jsonreporter::finish(const testresults& results)
+{
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    if (impl_->finished_)
+        return;
+    impl_->finished_ = true;
+    auto& buffer = impl_->buffer_;
+    buffer << "{\"event\":\"suite_end\"";
+    buffer << ",\"successful\":" << (results.successful ? "true" : "false");
+    buffer << ",\"tests\":" << results.n_tests + results.n_skipped;
+    buffer << ",\"errors\":" << results.n_errors;
+    buffer << ",\"failures\":" << results.n_failures;
+    buffer << ",\"timeouts\":" << results.n_timeouts;
+    buffer << ",\"skipped\":" << results.n_skipped;
+    buffer << ",\"time\":" << results.duration << "}\n";
+    impl_->flush();
+}
+
+} // core
+} // unittest
@@ -0,0 +1,161 @@
+/**
+ * @brief Tracking the heap allocations of tests
+ * @file allocations.hpp
+ */
+#pragma once
+/**
+ * @brief Unit testing in C++
+ */
+namespace unittest {
+/**
+ * @brief Internal functionality, not relevant for most users
+ */
+namespace core {
+/**
+ * @brief Stores the heap allocations done through the global operator new
+ *  by a single thread. Sizes are the requested sizes of the allocated blocks
+ */
+struct allocationcounts {
+    /**
+     * @brief Constructor
+     */
+    allocationcounts();
+    /**
+     * @brief Whether the allocations were tracked
+     */
+    bool measured;
+    /**
+     * @brief The number of allocations
+     */
+    long long count;
+    /**
+     * @brief The number of bytes allocated
+     */
+    long long bytes;
+    /**
+     * @brief The maximum of the live bytes at any time
+     */
+    long long peak_bytes;
+    /**
+     * @brief The number of bytes allocated minus the number of bytes freed.
+     *  Blocks freed by another thread count as freed while an
+     *  allocationowner of the counts exists and stay live afterwards
+     */
+    long long live_bytes;
+};
+/**
+ * @brief Identifies the owner of an allocated block. Stored in front of
+ *  each block by the replaced global operator new
+ */
+struct allocationtag {
+    /**
+     * @brief The counts the block was allocated into, a nullptr if the block
+     *  was not tracked. Only dereferenced by the allocating thread
+     */
+    unittest::core::allocationcounts* owner;
+    /**
+     * @brief The generation of the allocationowner of the counts, zero if
+     *  there was none
+     */
+    unsigned long long generation;
+    /**
+     * @brief The requested size of the block
+     */
+    long long size;
+};
+/**
+ * @brief Whether allocations can be tracked. This needs the replaced global
+ *  operator new of the libunittest_allocs library to be linked into the
+ *  program
+ * @returns Whether allocations can be tracked
+ */
+bool
+is_allocation_tracking_supported();
+/**
+ * @brief Counts the allocations of the calling thread into the given counts
+ *  for the lifetime of the scope. Scopes can be nested, the innermost one
+ *  counts
+ */
+class allocationscope {
+public:
+    /**
+     * @brief Constructor
+     * @param counts The counts to add to, nothing is counted if a nullptr
+     */
+    explicit
+    allocationscope(unittest::core::allocationcounts* counts);
+    /**
+     * @brief Destructor. Restores the counting of the enclosing scope
+     */
+    ~allocationscope();
+    /**
+     * @brief Copy constructor. Deleted
+     * @param other An instance of allocationscope
+     */
+    allocationscope(const allocationscope& other) = delete;
+    /**
+     * @brief Copy assignment operator. Deleted
+     * @param other An instance of allocationscope
+     * @returns An allocationscope instance
+     */
+    allocationscope&
+    operator=(const allocationscope& other) = delete;
+
+private:
+    unittest::core::allocationcounts* previous_;
+    unsigned long long previous_generation_;
+};
+/**
+ * @brief Registers counts as the owner of the blocks allocated into them
+ *  for the lifetime of the instance. Blocks freed by another thread in the
+ *  meantime are subtracted from the live bytes on destruction
+ */
+class allocationowner {
+public:
+    /**
+     * @brief Constructor
+     * @param counts The counts to register, nothing is registered if a nullptr
+     */
+    explicit
+    allocationowner(unittest::core::allocationcounts* counts);
+    /**
+     * @brief Destructor. Unregisters the counts
+     */
+    ~allocationowner();
+    /**
+     * @brief Copy constructor. Deleted
+     * @param other An instance of allocationowner
+     */
+    allocationowner(const allocationowner& other) = delete;
+    /**
+     * @brief Copy assignment operator. Deleted
+     * @param other An instance of allocationowner
+     * @returns An allocationowner instance
+     */
+    allocationowner&
+    operator=(const allocationowner& other) = delete;
+
+private:
+    unittest::core::allocationcounts* counts_;
+    unsigned long long generation_;
+};
+/**
+ * @brief Records an allocation of the calling thread. Called by the
+ *  replaced global operator new
+ * @param size The requested size of the block
+ * @returns The tag to store with the block
+ */
+unittest::core::allocationtag
+note_allocation(long long size) noexcept;
+/**
+ * @brief Records a deallocation. Called by the replaced global operator
+ *  delete. A block freed by another thread than the allocating one, or
+ *  after its counts went out of scope, is credited to the registered owner
+ *  of the block if there is one
+ * @param tag The tag stored with the block
+ */
+void
+note_deallocation(const unittest::core::allocationtag& tag) noexcept;
+
+} // core
+} // unittest
@@ -188,6 +188,13 @@ protected:
      */
     bool
     was_used(char arg);
+    /**
+     * @brief Removes the remaining arguments not starting with a dash.
+     *  To be called from assign_values() after assigning all flags
+     * @returns The positional arguments in the given order
+     */
+    std::vector<std::string>
+    take_positionals();
     /**
      * @brief Writes help to screen and throws an exit_error
      * @param message The exception message
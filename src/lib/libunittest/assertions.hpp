@@ -9,6 +9,7 @@
 #include "testfailure.hpp"
 #include "checkers.hpp"
 #include "func.hpp"
+#include "benchmark.hpp"
 #include <string>
 #include <regex>
 #include <typeinfo>
@@ -864,6 +865,29 @@ assert_no_throw(Functor functor,
         functor();
     }
 }
+/**
+ * @brief Asserts that the times of a parameter sweep fit a complexity class,
+ *  e.g. unittest::complexity::linear. The class needs not fit best but
+ *  within a tolerance of the best fit (see unittest::core::fits_complexity)
+ * @param expected The expected complexity class
+ * @param sweep The sweep result, e.g. from unittest::core::run_sweep
+ * @param message If given, is appended to the default fail message
+ */
+template<typename... Args>
+void
+assert_complexity(unittest::complexity expected,
+                  const unittest::core::sweepresult& sweep,
+                  const Args&... message)
+{
+    if (!sweep.measured) {
+        unittest::fail(UNITTEST_FUNC, "no sweep was measured", message...);
+    } else if (!unittest::core::fits_complexity(sweep, expected)) {
+        const std::string text = unittest::join(unittest::core::complexity_name(sweep.best_fit), " fits better than ",
+                                                unittest::core::complexity_name(expected), " (rms=", sweep.rms,
+                                                " vs ", unittest::core::complexity_error(sweep, expected), ")");
+        unittest::fail(UNITTEST_FUNC, text, message...);
+    }
+}
 
 } // assertions
 } // unittest
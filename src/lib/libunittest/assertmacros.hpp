@@ -15,7 +15,7 @@ unittest::assertions::assert_true(value, UNITTEST_SPOT, UNITTEST_CALL(value));
  * @param ... A user defined message
  */
 #define UNITTEST_ASSERT_TRUE_MSG(value, ...) \
-unittest::assertions::assert_true(value, UNITTEST_SPOT, UNITTEST_CALL(value), static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_true(value, UNITTEST_SPOT, UNITTEST_CALL(value), UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that a value is true (non-deadly assertion).
  * @param value A value
@@ -28,7 +28,7 @@ unittest::assertions::assert_true(value, UNITTEST_SPOT, UNITTEST_CALL(value), UN
  * @param ... A user defined message
  */
 #define UNITTEST_NDASSERT_TRUE_MSG(value, ...) \
-unittest::assertions::assert_true(value, UNITTEST_SPOT, UNITTEST_CALL(value), UNITTEST_NDAS, static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_true(value, UNITTEST_SPOT, UNITTEST_CALL(value), UNITTEST_NDAS, UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that a value is false.
  * @param value A value
@@ -41,7 +41,7 @@ unittest::assertions::assert_false(value, UNITTEST_SPOT, UNITTEST_CALL(value));
  * @param ... A user defined message
  */
 #define UNITTEST_ASSERT_FALSE_MSG(value, ...) \
-unittest::assertions::assert_false(value, UNITTEST_SPOT, UNITTEST_CALL(value), static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_false(value, UNITTEST_SPOT, UNITTEST_CALL(value), UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that a value is false (non-deadly assertion).
  * @param value A value
@@ -54,7 +54,7 @@ unittest::assertions::assert_false(value, UNITTEST_SPOT, UNITTEST_CALL(value), U
  * @param ... A user defined message
  */
 #define UNITTEST_NDASSERT_FALSE_MSG(value, ...) \
-unittest::assertions::assert_false(value, UNITTEST_SPOT, UNITTEST_CALL(value), UNITTEST_NDAS, static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_false(value, UNITTEST_SPOT, UNITTEST_CALL(value), UNITTEST_NDAS, UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that two values are equal.
  *  Required operators: ==, <<
@@ -71,7 +71,7 @@ unittest::assertions::assert_equal(expected, actual, UNITTEST_SPOT, UNITTEST_CAL
  * @param ... A user defined message
  */
 #define UNITTEST_ASSERT_EQUAL_MSG(expected, actual, ...) \
-unittest::assertions::assert_equal(expected, actual, UNITTEST_SPOT, UNITTEST_CALL(expected, actual), static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_equal(expected, actual, UNITTEST_SPOT, UNITTEST_CALL(expected, actual), UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that two values are equal (non-deadly assertion).
  *  Required operators: ==, <<
@@ -88,7 +88,7 @@ unittest::assertions::assert_equal(expected, actual, UNITTEST_SPOT, UNITTEST_CAL
  * @param ... A user defined message
  */
 #define UNITTEST_NDASSERT_EQUAL_MSG(expected, actual, ...) \
-unittest::assertions::assert_equal(expected, actual, UNITTEST_SPOT, UNITTEST_CALL(expected, actual), UNITTEST_NDAS, static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_equal(expected, actual, UNITTEST_SPOT, UNITTEST_CALL(expected, actual), UNITTEST_NDAS, UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that two values are not equal.
  *  Required operators: ==, <<
@@ -105,7 +105,7 @@ unittest::assertions::assert_not_equal(first, second, UNITTEST_SPOT, UNITTEST_CA
  * @param ... A user defined message
  */
 #define UNITTEST_ASSERT_NOT_EQUAL_MSG(first, second, ...) \
-unittest::assertions::assert_not_equal(first, second, UNITTEST_SPOT, UNITTEST_CALL(first, second), static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_not_equal(first, second, UNITTEST_SPOT, UNITTEST_CALL(first, second), UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that two values are not equal (non-deadly assertion).
  *  Required operators: ==, <<
@@ -122,7 +122,7 @@ unittest::assertions::assert_not_equal(first, second, UNITTEST_SPOT, UNITTEST_CA
  * @param ... A user defined message
  */
 #define UNITTEST_NDASSERT_NOT_EQUAL_MSG(first, second, ...) \
-unittest::assertions::assert_not_equal(first, second, UNITTEST_SPOT, UNITTEST_CALL(first, second), UNITTEST_NDAS, static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_not_equal(first, second, UNITTEST_SPOT, UNITTEST_CALL(first, second), UNITTEST_NDAS, UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that two values are approximately equal up to some
  *  epsilon. The assertion succeeds if |a - b| < epsilon.
@@ -143,7 +143,7 @@ unittest::assertions::assert_approx_equal(expected, actual, epsilon, UNITTEST_SP
  * @param ... A user defined message
  */
 #define UNITTEST_ASSERT_APPROX_EQUAL_MSG(expected, actual, epsilon, ...) \
-unittest::assertions::assert_approx_equal(expected, actual, epsilon, UNITTEST_SPOT, UNITTEST_CALL(expected, actual, epsilon), static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_approx_equal(expected, actual, epsilon, UNITTEST_SPOT, UNITTEST_CALL(expected, actual, epsilon), UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that two values are approximately equal up to some
  *  epsilon. The assertion succeeds if |a - b| < epsilon (non-deadly assertions).
@@ -164,7 +164,7 @@ unittest::assertions::assert_approx_equal(expected, actual, epsilon, UNITTEST_SP
  * @param ... A user defined message
  */
 #define UNITTEST_NDASSERT_APPROX_EQUAL_MSG(expected, actual, epsilon, ...) \
-unittest::assertions::assert_approx_equal(expected, actual, epsilon, UNITTEST_SPOT, UNITTEST_CALL(expected, actual, epsilon), UNITTEST_NDAS, static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_approx_equal(expected, actual, epsilon, UNITTEST_SPOT, UNITTEST_CALL(expected, actual, epsilon), UNITTEST_NDAS, UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that two values are not approximately equal up to some
  *  epsilon. The assertion succeeds if |a - b| < epsilon is false.
@@ -185,7 +185,7 @@ unittest::assertions::assert_approx_equal(first, second, epsilon, UNITTEST_SPOT,
  * @param ... A user defined message
  */
 #define UNITTEST_ASSERT_APPROX_NOT_EQUAL_MSG(first, second, epsilon, ...) \
-unittest::assertions::assert_approx_not_equal(first, second, epsilon, UNITTEST_SPOT, UNITTEST_CALL(first, second, epsilon), static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_approx_not_equal(first, second, epsilon, UNITTEST_SPOT, UNITTEST_CALL(first, second, epsilon), UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that two values are not approximately equal up to some
  *  epsilon. The assertion succeeds if |a - b| < epsilon is false
@@ -208,7 +208,7 @@ unittest::assertions::assert_approx_not_equal(first, second, epsilon, UNITTEST_S
  * @param ... A user defined message
  */
 #define UNITTEST_NDASSERT_APPROX_NOT_EQUAL_MSG(first, second, epsilon, ...) \
-unittest::assertions::assert_approx_not_equal(first, second, epsilon, UNITTEST_SPOT, UNITTEST_CALL(first, second, epsilon), UNITTEST_NDAS, static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_approx_not_equal(first, second, epsilon, UNITTEST_SPOT, UNITTEST_CALL(first, second, epsilon), UNITTEST_NDAS, UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that two values are relatively approx. equal up to some
  *  epsilon. The assertion succeeds if |a - b| < |a| * epsilon.
@@ -229,7 +229,7 @@ unittest::assertions::assert_approxrel_equal(expected, actual, epsilon, UNITTEST
  * @param ... A user defined message
  */
 #define UNITTEST_ASSERT_APPROXREL_EQUAL_MSG(expected, actual, epsilon, ...) \
-unittest::assertions::assert_approxrel_equal(expected, actual, epsilon, UNITTEST_SPOT, UNITTEST_CALL(expected, actual, epsilon), static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_approxrel_equal(expected, actual, epsilon, UNITTEST_SPOT, UNITTEST_CALL(expected, actual, epsilon), UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that two values are relatively approx. equal up to some
  *  epsilon. The assertion succeeds if |a - b| < |a| * epsilon
@@ -252,7 +252,7 @@ unittest::assertions::assert_approxrel_equal(expected, actual, epsilon, UNITTEST
  * @param ... A user defined message
  */
 #define UNITTEST_NDASSERT_APPROXREL_EQUAL_MSG(expected, actual, epsilon, ...) \
-unittest::assertions::assert_approxrel_equal(expected, actual, epsilon, UNITTEST_SPOT, UNITTEST_CALL(expected, actual, epsilon), UNITTEST_NDAS, static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_approxrel_equal(expected, actual, epsilon, UNITTEST_SPOT, UNITTEST_CALL(expected, actual, epsilon), UNITTEST_NDAS, UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that two values are not relatively approx. equal up to some
  *  epsilon. The assertion succeeds if |a - b| < |a| * epsilon is false
@@ -273,7 +273,7 @@ unittest::assertions::assert_approxrel_not_equal(first, second, epsilon, UNITTES
  * @param ... A user defined message
  */
 #define UNITTEST_ASSERT_APPROXREL_NOT_EQUAL_MSG(first, second, epsilon, ...) \
-unittest::assertions::assert_approxrel_not_equal(first, second, epsilon, UNITTEST_SPOT, UNITTEST_CALL(first, second, epsilon), static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_approxrel_not_equal(first, second, epsilon, UNITTEST_SPOT, UNITTEST_CALL(first, second, epsilon), UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that two values are not relatively approx. equal up to some
  *  epsilon. The assertion succeeds if |a - b| < |a| * epsilon is false
@@ -296,7 +296,7 @@ unittest::assertions::assert_approxrel_not_equal(first, second, epsilon, UNITTES
  * @param ... A user defined message
  */
 #define UNITTEST_NDASSERT_APPROXREL_NOT_EQUAL_MSG(first, second, epsilon, ...) \
-unittest::assertions::assert_approxrel_not_equal(first, second, epsilon, UNITTEST_SPOT, UNITTEST_CALL(first, second, epsilon), UNITTEST_NDAS, static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_approxrel_not_equal(first, second, epsilon, UNITTEST_SPOT, UNITTEST_CALL(first, second, epsilon), UNITTEST_NDAS, UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that the first value is greater than the second.
  *  Required operators: >, <<
@@ -313,7 +313,7 @@ unittest::assertions::assert_greater(first, second, UNITTEST_SPOT, UNITTEST_CALL
  * @param ... A user defined message
  */
 #define UNITTEST_ASSERT_GREATER_MSG(first, second, ...) \
-unittest::assertions::assert_greater(first, second, UNITTEST_SPOT, UNITTEST_CALL(first, second), static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_greater(first, second, UNITTEST_SPOT, UNITTEST_CALL(first, second), UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that the first value is greater than the second
  *  (non-deadly assertion).
@@ -332,7 +332,7 @@ unittest::assertions::assert_greater(first, second, UNITTEST_SPOT, UNITTEST_CALL
  * @param ... A user defined message
  */
 #define UNITTEST_NDASSERT_GREATER_MSG(first, second, ...) \
-unittest::assertions::assert_greater(first, second, UNITTEST_SPOT, UNITTEST_CALL(first, second), UNITTEST_NDAS, static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_greater(first, second, UNITTEST_SPOT, UNITTEST_CALL(first, second), UNITTEST_NDAS, UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that the first value is greater than or equal to the second.
  *  Required operators: <, <<
@@ -349,7 +349,7 @@ unittest::assertions::assert_greater_equal(first, second, UNITTEST_SPOT, UNITTES
  * @param ... A user defined message
  */
 #define UNITTEST_ASSERT_GREATER_EQUAL_MSG(first, second, ...) \
-unittest::assertions::assert_greater_equal(first, second, UNITTEST_SPOT, UNITTEST_CALL(first, second), static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_greater_equal(first, second, UNITTEST_SPOT, UNITTEST_CALL(first, second), UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that the first value is greater than or equal
  *  to the second (non-deadly assertion).
@@ -368,7 +368,7 @@ unittest::assertions::assert_greater_equal(first, second, UNITTEST_SPOT, UNITTES
  * @param ... A user defined message
  */
 #define UNITTEST_NDASSERT_GREATER_EQUAL_MSG(first, second, ...) \
-unittest::assertions::assert_greater_equal(first, second, UNITTEST_SPOT, UNITTEST_CALL(first, second), UNITTEST_NDAS, static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_greater_equal(first, second, UNITTEST_SPOT, UNITTEST_CALL(first, second), UNITTEST_NDAS, UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that the first value is lesser than the second.
  *  Required operators: <, <<
@@ -385,7 +385,7 @@ unittest::assertions::assert_lesser(first, second, UNITTEST_SPOT, UNITTEST_CALL(
  * @param ... A user defined message
  */
 #define UNITTEST_ASSERT_LESSER_MSG(first, second, ...) \
-unittest::assertions::assert_lesser(first, second, UNITTEST_SPOT, UNITTEST_CALL(first, second), static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_lesser(first, second, UNITTEST_SPOT, UNITTEST_CALL(first, second), UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that the first value is lesser than the second
  *  (non-deadly assertion).
@@ -404,7 +404,7 @@ unittest::assertions::assert_lesser(first, second, UNITTEST_SPOT, UNITTEST_CALL(
  * @param ... A user defined message
  */
 #define UNITTEST_NDASSERT_LESSER_MSG(first, second, ...) \
-unittest::assertions::assert_lesser(first, second, UNITTEST_SPOT, UNITTEST_CALL(first, second), UNITTEST_NDAS, static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_lesser(first, second, UNITTEST_SPOT, UNITTEST_CALL(first, second), UNITTEST_NDAS, UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that the first value is lesser than or equal to the second.
  *  Required operators: >, <<
@@ -421,7 +421,7 @@ unittest::assertions::assert_lesser_equal(first, second, UNITTEST_SPOT, UNITTEST
  * @param ... A user defined message
  */
 #define UNITTEST_ASSERT_LESSER_EQUAL_MSG(first, second, ...) \
-unittest::assertions::assert_lesser_equal(first, second, UNITTEST_SPOT, UNITTEST_CALL(first, second), static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_lesser_equal(first, second, UNITTEST_SPOT, UNITTEST_CALL(first, second), UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that the first value is lesser than or equal
  *  to the second (non-deadly assertion).
@@ -440,7 +440,7 @@ unittest::assertions::assert_lesser_equal(first, second, UNITTEST_SPOT, UNITTEST
  * @param ... A user defined message
  */
 #define UNITTEST_NDASSERT_LESSER_EQUAL_MSG(first, second, ...) \
-unittest::assertions::assert_lesser_equal(first, second, UNITTEST_SPOT, UNITTEST_CALL(first, second), UNITTEST_NDAS, static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_lesser_equal(first, second, UNITTEST_SPOT, UNITTEST_CALL(first, second), UNITTEST_NDAS, UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that a value is in a given range with included bounds.
  *  Required operators: <, >, <<
@@ -459,7 +459,7 @@ unittest::assertions::assert_in_range(value, lower, upper, UNITTEST_SPOT, UNITTE
  * @param ... A user defined message
  */
 #define UNITTEST_ASSERT_IN_RANGE_MSG(value, lower, upper, ...) \
-unittest::assertions::assert_in_range(value, lower, upper, UNITTEST_SPOT, UNITTEST_CALL(value, lower, upper), static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_in_range(value, lower, upper, UNITTEST_SPOT, UNITTEST_CALL(value, lower, upper), UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that a value is in a given range with included bounds
  *  (non-deadly assertion).
@@ -480,7 +480,7 @@ unittest::assertions::assert_in_range(value, lower, upper, UNITTEST_SPOT, UNITTE
  * @param ... A user defined message
  */
 #define UNITTEST_NDASSERT_IN_RANGE_MSG(value, lower, upper, ...) \
-unittest::assertions::assert_in_range(value, lower, upper, UNITTEST_SPOT, UNITTEST_CALL(value, lower, upper), UNITTEST_NDAS, static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_in_range(value, lower, upper, UNITTEST_SPOT, UNITTEST_CALL(value, lower, upper), UNITTEST_NDAS, UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that a value is not in a given range with included bounds.
  *  Required operators: <, >, <<
@@ -499,7 +499,7 @@ unittest::assertions::assert_not_in_range(value, lower, upper, UNITTEST_SPOT, UN
  * @param ... A user defined message
  */
 #define UNITTEST_ASSERT_NOT_IN_RANGE_MSG(value, lower, upper, ...) \
-unittest::assertions::assert_not_in_range(value, lower, upper, UNITTEST_SPOT, UNITTEST_CALL(value, lower, upper), static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_not_in_range(value, lower, upper, UNITTEST_SPOT, UNITTEST_CALL(value, lower, upper), UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that a value is not in a given range with included bounds
  *  (non-deadly assertion).
@@ -520,7 +520,7 @@ unittest::assertions::assert_not_in_range(value, lower, upper, UNITTEST_SPOT, UN
  * @param ... A user defined message
  */
 #define UNITTEST_NDASSERT_NOT_IN_RANGE_MSG(value, lower, upper, ...) \
-unittest::assertions::assert_not_in_range(value, lower, upper, UNITTEST_SPOT, UNITTEST_CALL(value, lower, upper), UNITTEST_NDAS, static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_not_in_range(value, lower, upper, UNITTEST_SPOT, UNITTEST_CALL(value, lower, upper), UNITTEST_NDAS, UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that a value is in a container.
  *  Required operators: ==
@@ -537,7 +537,7 @@ unittest::assertions::assert_in_container(value, container, UNITTEST_SPOT, UNITT
  * @param ... A user defined message
  */
 #define UNITTEST_ASSERT_IN_CONTAINER_MSG(value, container, ...) \
-unittest::assertions::assert_in_container(value, container, UNITTEST_SPOT, UNITTEST_CALL(value, container), static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_in_container(value, container, UNITTEST_SPOT, UNITTEST_CALL(value, container), UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that a value is in a container (non-deadly assertion).
  *  Required operators: ==
@@ -554,7 +554,7 @@ unittest::assertions::assert_in_container(value, container, UNITTEST_SPOT, UNITT
  * @param ... A user defined message
  */
 #define UNITTEST_NDASSERT_IN_CONTAINER_MSG(value, container, ...) \
-unittest::assertions::assert_in_container(value, container, UNITTEST_SPOT, UNITTEST_CALL(value, container), UNITTEST_NDAS, static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_in_container(value, container, UNITTEST_SPOT, UNITTEST_CALL(value, container), UNITTEST_NDAS, UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that a value is not in a container.
  *  Required operators: ==
@@ -571,7 +571,7 @@ unittest::assertions::assert_not_in_container(value, container, UNITTEST_SPOT, U
  * @param ... A user defined message
  */
 #define UNITTEST_ASSERT_NOT_IN_CONTAINER_MSG(value, container, ...) \
-unittest::assertions::assert_not_in_container(value, container, UNITTEST_SPOT, UNITTEST_CALL(value, container), static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_not_in_container(value, container, UNITTEST_SPOT, UNITTEST_CALL(value, container), UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that a value is not in a container (non-deadly assertion).
  *  Required operators: ==
@@ -588,7 +588,7 @@ unittest::assertions::assert_not_in_container(value, container, UNITTEST_SPOT, U
  * @param ... A user defined message
  */
 #define UNITTEST_NDASSERT_NOT_IN_CONTAINER_MSG(value, container, ...) \
-unittest::assertions::assert_not_in_container(value, container, UNITTEST_SPOT, UNITTEST_CALL(value, container), UNITTEST_NDAS, static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_not_in_container(value, container, UNITTEST_SPOT, UNITTEST_CALL(value, container), UNITTEST_NDAS, UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that a value is approx. in a container up to some epsilon.
  *  The assertion succeeds if |a - b| < epsilon for at least one element.
@@ -609,7 +609,7 @@ unittest::assertions::assert_approx_in_container(value, container, epsilon, UNIT
  * @param ... A user defined message
  */
 #define UNITTEST_ASSERT_APPROX_IN_CONTAINER_MSG(value, container, epsilon, ...) \
-unittest::assertions::assert_approx_in_container(value, container, epsilon, UNITTEST_SPOT, UNITTEST_CALL(value, container, epsilon), static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_approx_in_container(value, container, epsilon, UNITTEST_SPOT, UNITTEST_CALL(value, container, epsilon), UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that a value is approx. in a container up to some epsilon.
  *  The assertion succeeds if |a - b| < epsilon for at least one element (non-deadly assertion).
@@ -630,7 +630,7 @@ unittest::assertions::assert_approx_in_container(value, container, epsilon, UNIT
  * @param ... A user defined message
  */
 #define UNITTEST_NDASSERT_APPROX_IN_CONTAINER_MSG(value, container, epsilon, ...) \
-unittest::assertions::assert_approx_in_container(value, container, epsilon, UNITTEST_SPOT, UNITTEST_CALL(value, container, epsilon), UNITTEST_NDAS, static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_approx_in_container(value, container, epsilon, UNITTEST_SPOT, UNITTEST_CALL(value, container, epsilon), UNITTEST_NDAS, UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that a value is not approx. in a container up to some epsilon.
  *  The assertion succeeds if |a - b| < epsilon is false for all elements.
@@ -651,7 +651,7 @@ unittest::assertions::assert_approx_not_in_container(value, container, epsilon,
  * @param ... A user defined message
  */
 #define UNITTEST_ASSERT_APPROX_NOT_IN_CONTAINER_MSG(value, container, epsilon, ...) \
-unittest::assertions::assert_approx_not_in_container(value, container, epsilon, UNITTEST_SPOT, UNITTEST_CALL(value, container, epsilon), static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_approx_not_in_container(value, container, epsilon, UNITTEST_SPOT, UNITTEST_CALL(value, container, epsilon), UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that a value is not approx. in a container up to some epsilon.
  *  The assertion succeeds if |a - b| < epsilon is false for all elements (non-deadly assertion).
@@ -672,7 +672,7 @@ unittest::assertions::assert_approx_not_in_container(value, container, epsilon,
  * @param ... A user defined message
  */
 #define UNITTEST_NDASSERT_APPROX_NOT_IN_CONTAINER_MSG(value, container, epsilon, ...) \
-unittest::assertions::assert_approx_not_in_container(value, container, epsilon, UNITTEST_SPOT, UNITTEST_CALL(value, container, epsilon), UNITTEST_NDAS, static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_approx_not_in_container(value, container, epsilon, UNITTEST_SPOT, UNITTEST_CALL(value, container, epsilon), UNITTEST_NDAS, UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that a value is relatively approx. in a container up to some
  *  epsilon. The assertion succeeds if |a - b| < |a| * epsilon for at least one
@@ -693,7 +693,7 @@ unittest::assertions::assert_approxrel_in_container(value, container, epsilon, U
  * @param ... A user defined message
  */
 #define UNITTEST_ASSERT_APPROXREL_IN_CONTAINER_MSG(value, container, epsilon, ...) \
-unittest::assertions::assert_approxrel_in_container(value, container, epsilon, UNITTEST_SPOT, UNITTEST_CALL(value, container, epsilon), static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_approxrel_in_container(value, container, epsilon, UNITTEST_SPOT, UNITTEST_CALL(value, container, epsilon), UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that a value is relatively approx. in a container up to some
  *  epsilon. The assertion succeeds if |a - b| < |a| * epsilon for at least one
@@ -714,7 +714,7 @@ unittest::assertions::assert_approxrel_in_container(value, container, epsilon, U
  * @param ... A user defined message
  */
 #define UNITTEST_NDASSERT_APPROXREL_IN_CONTAINER_MSG(value, container, epsilon, ...) \
-unittest::assertions::assert_approxrel_in_container(value, container, epsilon, UNITTEST_SPOT, UNITTEST_CALL(value, container, epsilon), UNITTEST_NDAS, static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_approxrel_in_container(value, container, epsilon, UNITTEST_SPOT, UNITTEST_CALL(value, container, epsilon), UNITTEST_NDAS, UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that a value is not relatively approx. in a container up to
  *  some epsilon. The assertion succeeds if |a - b| < |a| * epsilon is false for
@@ -735,7 +735,7 @@ unittest::assertions::assert_approxrel_not_in_container(value, container, epsilo
  * @param ... A user defined message
  */
 #define UNITTEST_ASSERT_APPROXREL_NOT_IN_CONTAINER_MSG(value, container, epsilon, ...) \
-unittest::assertions::assert_approxrel_not_in_container(value, container, epsilon, UNITTEST_SPOT, UNITTEST_CALL(value, container, epsilon), static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_approxrel_not_in_container(value, container, epsilon, UNITTEST_SPOT, UNITTEST_CALL(value, container, epsilon), UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that a value is not relatively approx. in a container up to
  *  some epsilon. The assertion succeeds if |a - b| < |a| * epsilon is false for
@@ -756,7 +756,7 @@ unittest::assertions::assert_approxrel_not_in_container(value, container, epsilo
  * @param ... A user defined message
  */
 #define UNITTEST_NDASSERT_APPROXREL_NOT_IN_CONTAINER_MSG(value, container, epsilon, ...) \
-unittest::assertions::assert_approxrel_not_in_container(value, container, epsilon, UNITTEST_SPOT, UNITTEST_CALL(value, container, epsilon), UNITTEST_NDAS, static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_approxrel_not_in_container(value, container, epsilon, UNITTEST_SPOT, UNITTEST_CALL(value, container, epsilon), UNITTEST_NDAS, UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that two containers are equal.
  *  Required operators: ==
@@ -773,7 +773,7 @@ unittest::assertions::assert_equal_containers(expected, actual, UNITTEST_SPOT, U
  * @param ... A user defined message
  */
 #define UNITTEST_ASSERT_EQUAL_CONTAINERS_MSG(expected, actual, ...) \
-unittest::assertions::assert_equal_containers(expected, actual, UNITTEST_SPOT, UNITTEST_CALL(expected, actual), static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_equal_containers(expected, actual, UNITTEST_SPOT, UNITTEST_CALL(expected, actual), UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that two containers are equal (non-deadly assertion).
  *  Required operators: ==
@@ -790,7 +790,7 @@ unittest::assertions::assert_equal_containers(expected, actual, UNITTEST_SPOT, U
  * @param ... A user defined message
  */
 #define UNITTEST_NDASSERT_EQUAL_CONTAINERS_MSG(expected, actual, ...) \
-unittest::assertions::assert_equal_containers(expected, actual, UNITTEST_SPOT, UNITTEST_CALL(expected, actual), UNITTEST_NDAS, static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_equal_containers(expected, actual, UNITTEST_SPOT, UNITTEST_CALL(expected, actual), UNITTEST_NDAS, UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that two containers are not equal.
  *  Required operators: ==
@@ -807,7 +807,7 @@ unittest::assertions::assert_not_equal_containers(first, second, UNITTEST_SPOT,
  * @param ... A user defined message
  */
 #define UNITTEST_ASSERT_NOT_EQUAL_CONTAINERS_MSG(first, second, ...) \
-unittest::assertions::assert_not_equal_containers(first, second, UNITTEST_SPOT, UNITTEST_CALL(first, second), static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_not_equal_containers(first, second, UNITTEST_SPOT, UNITTEST_CALL(first, second), UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that two containers are not equal (non-deadly assertion).
  *  Required operators: ==
@@ -824,7 +824,7 @@ unittest::assertions::assert_not_equal_containers(first, second, UNITTEST_SPOT,
  * @param ... A user defined message
  */
 #define UNITTEST_NDASSERT_NOT_EQUAL_CONTAINERS_MSG(first, second, ...) \
-unittest::assertions::assert_not_equal_containers(first, second, UNITTEST_SPOT, UNITTEST_CALL(first, second), UNITTEST_NDAS, static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_not_equal_containers(first, second, UNITTEST_SPOT, UNITTEST_CALL(first, second), UNITTEST_NDAS, UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that two containers are approx. equal up to some epsilon.
  *  The assertion succeeds if |a - b| < epsilon for all pairs of elements.
@@ -845,7 +845,7 @@ unittest::assertions::assert_approx_equal_containers(expected, actual, epsilon,
  * @param ... A user defined message
  */
 #define UNITTEST_ASSERT_APPROX_EQUAL_CONTAINERS_MSG(expected, actual, epsilon, ...) \
-unittest::assertions::assert_approx_equal_containers(expected, actual, epsilon, UNITTEST_SPOT, UNITTEST_CALL(expected, actual, epsilon), static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_approx_equal_containers(expected, actual, epsilon, UNITTEST_SPOT, UNITTEST_CALL(expected, actual, epsilon), UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that two containers are approx. equal up to some epsilon.
  *  The assertion succeeds if |a - b| < epsilon for all pairs of elements (non-deadly assertion).
@@ -866,7 +866,7 @@ unittest::assertions::assert_approx_equal_containers(expected, actual, epsilon,
  * @param ... A user defined message
  */
 #define UNITTEST_NDASSERT_APPROX_EQUAL_CONTAINERS_MSG(expected, actual, epsilon, ...) \
-unittest::assertions::assert_approx_equal_containers(expected, actual, epsilon, UNITTEST_SPOT, UNITTEST_CALL(expected, actual, epsilon), UNITTEST_NDAS, static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_approx_equal_containers(expected, actual, epsilon, UNITTEST_SPOT, UNITTEST_CALL(expected, actual, epsilon), UNITTEST_NDAS, UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that two containers are not approx. equal up to some
  *  epsilon. The assertion succeeds if |a - b| < epsilon is false for at
@@ -889,7 +889,7 @@ unittest::assertions::assert_approx_not_equal_containers(first, second, epsilon,
  * @param ... A user defined message
  */
 #define UNITTEST_ASSERT_APPROX_NOT_EQUAL_CONTAINERS_MSG(first, second, epsilon, ...) \
-unittest::assertions::assert_approx_not_equal_containers(first, second, epsilon, UNITTEST_SPOT, UNITTEST_CALL(first, second, epsilon), static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_approx_not_equal_containers(first, second, epsilon, UNITTEST_SPOT, UNITTEST_CALL(first, second, epsilon), UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that two containers are not approx. equal up to some
  *  epsilon. The assertion succeeds if |a - b| < epsilon is false for at
@@ -912,7 +912,7 @@ unittest::assertions::assert_approx_not_equal_containers(first, second, epsilon,
  * @param ... A user defined message
  */
 #define UNITTEST_NDASSERT_APPROX_NOT_EQUAL_CONTAINERS_MSG(first, second, epsilon, ...) \
-unittest::assertions::assert_approx_not_equal_containers(first, second, epsilon, UNITTEST_SPOT, UNITTEST_CALL(first, second, epsilon), UNITTEST_NDAS, static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_approx_not_equal_containers(first, second, epsilon, UNITTEST_SPOT, UNITTEST_CALL(first, second, epsilon), UNITTEST_NDAS, UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that two containers are relatively approx. equal up to some
  *  epsilon. The assertion succeeds if |a - b| < |a| * epsilon for all pairs of
@@ -935,7 +935,7 @@ unittest::assertions::assert_approxrel_equal_containers(expected, actual, epsilo
  * @param ... A user defined message
  */
 #define UNITTEST_ASSERT_APPROXREL_EQUAL_CONTAINERS_MSG(expected, actual, epsilon, ...) \
-unittest::assertions::assert_approxrel_equal_containers(expected, actual, epsilon, UNITTEST_SPOT, UNITTEST_CALL(expected, actual, epsilon), static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_approxrel_equal_containers(expected, actual, epsilon, UNITTEST_SPOT, UNITTEST_CALL(expected, actual, epsilon), UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that two containers are relatively approx. equal up to some
  *  epsilon. The assertion succeeds if |a - b| < |a| * epsilon for all pairs of
@@ -958,7 +958,7 @@ unittest::assertions::assert_approxrel_equal_containers(expected, actual, epsilo
  * @param ... A user defined message
  */
 #define UNITTEST_NDASSERT_APPROXREL_EQUAL_CONTAINERS_MSG(expected, actual, epsilon, ...) \
-unittest::assertions::assert_approxrel_equal_containers(expected, actual, epsilon, UNITTEST_SPOT, UNITTEST_CALL(expected, actual, epsilon), UNITTEST_NDAS, static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_approxrel_equal_containers(expected, actual, epsilon, UNITTEST_SPOT, UNITTEST_CALL(expected, actual, epsilon), UNITTEST_NDAS, UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that two containers are not relatively approx. equal up to
  *  some epsilon. The assertion succeeds if |a - b| < |a| * epsilon is false for
@@ -981,7 +981,7 @@ unittest::assertions::assert_approxrel_not_equal_containers(first, second, epsil
  * @param ... A user defined message
  */
 #define UNITTEST_ASSERT_APPROXREL_NOT_EQUAL_CONTAINERS_MSG(first, second, epsilon, ...) \
-unittest::assertions::assert_approxrel_not_equal_containers(first, second, epsilon, UNITTEST_SPOT, UNITTEST_CALL(first, second, epsilon), static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_approxrel_not_equal_containers(first, second, epsilon, UNITTEST_SPOT, UNITTEST_CALL(first, second, epsilon), UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that two containers are not relatively approx. equal up to
  *  some epsilon. The assertion succeeds if |a - b| < |a| * epsilon is false for
@@ -1004,7 +1004,7 @@ unittest::assertions::assert_approxrel_not_equal_containers(first, second, epsil
  * @param ... A user defined message
  */
 #define UNITTEST_NDASSERT_APPROXREL_NOT_EQUAL_CONTAINERS_MSG(first, second, epsilon, ...) \
-unittest::assertions::assert_approxrel_not_equal_containers(first, second, epsilon, UNITTEST_SPOT, UNITTEST_CALL(first, second, epsilon), UNITTEST_NDAS, static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_approxrel_not_equal_containers(first, second, epsilon, UNITTEST_SPOT, UNITTEST_CALL(first, second, epsilon), UNITTEST_NDAS, UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that all container elements match a given condition.
  * @param container A container
@@ -1021,7 +1021,7 @@ unittest::assertions::assert_all_of(container, condition, UNITTEST_SPOT, UNITTES
  * @param ... A user defined message
  */
 #define UNITTEST_ASSERT_ALL_OF_MSG(container, condition, ...) \
-unittest::assertions::assert_all_of(container, condition, UNITTEST_SPOT, UNITTEST_CALL(container, condition), static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_all_of(container, condition, UNITTEST_SPOT, UNITTEST_CALL(container, condition), UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that all container elements match a given condition (non-deadly assertion).
  * @param container A container
@@ -1038,7 +1038,7 @@ unittest::assertions::assert_all_of(container, condition, UNITTEST_SPOT, UNITTES
  * @param ... A user defined message
  */
 #define UNITTEST_NDASSERT_ALL_OF_MSG(container, condition, ...) \
-unittest::assertions::assert_all_of(container, condition, UNITTEST_SPOT, UNITTEST_CALL(container, condition), UNITTEST_NDAS, static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_all_of(container, condition, UNITTEST_SPOT, UNITTEST_CALL(container, condition), UNITTEST_NDAS, UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that not all container elements match a given condition.
  * @param container A container
@@ -1055,7 +1055,7 @@ unittest::assertions::assert_not_all_of(container, condition, UNITTEST_SPOT, UNI
  * @param ... A user defined message
  */
 #define UNITTEST_ASSERT_NOT_ALL_OF_MSG(container, condition, ...) \
-unittest::assertions::assert_not_all_of(container, condition, UNITTEST_SPOT, UNITTEST_CALL(container, condition), static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_not_all_of(container, condition, UNITTEST_SPOT, UNITTEST_CALL(container, condition), UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that not all container elements match a given condition (non-deadly assertion).
  * @param container A container
@@ -1072,7 +1072,7 @@ unittest::assertions::assert_not_all_of(container, condition, UNITTEST_SPOT, UNI
  * @param ... A user defined message
  */
 #define UNITTEST_NDASSERT_NOT_ALL_OF_MSG(container, condition, ...) \
-unittest::assertions::assert_not_all_of(container, condition, UNITTEST_SPOT, UNITTEST_CALL(container, condition), UNITTEST_NDAS, static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_not_all_of(container, condition, UNITTEST_SPOT, UNITTEST_CALL(container, condition), UNITTEST_NDAS, UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that any container elements match a given condition.
  * @param container A container
@@ -1089,7 +1089,7 @@ unittest::assertions::assert_any_of(container, condition, UNITTEST_SPOT, UNITTES
  * @param ... A user defined message
  */
 #define UNITTEST_ASSERT_ANY_OF_MSG(container, condition, ...) \
-unittest::assertions::assert_any_of(container, condition, UNITTEST_SPOT, UNITTEST_CALL(container, condition), static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_any_of(container, condition, UNITTEST_SPOT, UNITTEST_CALL(container, condition), UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that any container elements match a given condition (non-deadly assertion).
  * @param container A container
@@ -1106,7 +1106,7 @@ unittest::assertions::assert_any_of(container, condition, UNITTEST_SPOT, UNITTES
  * @param ... A user defined message
  */
 #define UNITTEST_NDASSERT_ANY_OF_MSG(container, condition, ...) \
-unittest::assertions::assert_any_of(container, condition, UNITTEST_SPOT, UNITTEST_CALL(container, condition), UNITTEST_NDAS, static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_any_of(container, condition, UNITTEST_SPOT, UNITTEST_CALL(container, condition), UNITTEST_NDAS, UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that none of the container elements match a given condition.
  * @param container A container
@@ -1123,7 +1123,7 @@ unittest::assertions::assert_none_of(container, condition, UNITTEST_SPOT, UNITTE
  * @param ... A user defined message
  */
 #define UNITTEST_ASSERT_NONE_OF_MSG(container, condition, ...) \
-unittest::assertions::assert_none_of(container, condition, UNITTEST_SPOT, UNITTEST_CALL(container, condition), static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_none_of(container, condition, UNITTEST_SPOT, UNITTEST_CALL(container, condition), UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that none of the container elements match a given condition (non-deadly assertion).
  * @param container A container
@@ -1140,7 +1140,7 @@ unittest::assertions::assert_none_of(container, condition, UNITTEST_SPOT, UNITTE
  * @param ... A user defined message
  */
 #define UNITTEST_NDASSERT_NONE_OF_MSG(container, condition, ...) \
-unittest::assertions::assert_none_of(container, condition, UNITTEST_SPOT, UNITTEST_CALL(container, condition), UNITTEST_NDAS, static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_none_of(container, condition, UNITTEST_SPOT, UNITTEST_CALL(container, condition), UNITTEST_NDAS, UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that a string matches a regular expression.
  * @param string A string
@@ -1155,7 +1155,7 @@ unittest::assertions::assert_regex_match(string, regex, UNITTEST_SPOT, UNITTEST_
  * @param ... A user defined message
  */
 #define UNITTEST_ASSERT_REGEX_MATCH_MSG(string, regex, ...) \
-unittest::assertions::assert_regex_match(string, regex, UNITTEST_SPOT, UNITTEST_CALL(string, regex), static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_regex_match(string, regex, UNITTEST_SPOT, UNITTEST_CALL(string, regex), UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that a string matches a regular expression (non-deadly assertion).
  * @param string A string
@@ -1170,7 +1170,7 @@ unittest::assertions::assert_regex_match(string, regex, UNITTEST_SPOT, UNITTEST_
  * @param ... A user defined message
  */
 #define UNITTEST_NDASSERT_REGEX_MATCH_MSG(string, regex, ...) \
-unittest::assertions::assert_regex_match(string, regex, UNITTEST_SPOT, UNITTEST_CALL(string, regex), UNITTEST_NDAS, static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_regex_match(string, regex, UNITTEST_SPOT, UNITTEST_CALL(string, regex), UNITTEST_NDAS, UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that a string does not match a regular expression.
  * @param string A string
@@ -1185,7 +1185,7 @@ unittest::assertions::assert_not_regex_match(string, regex, UNITTEST_SPOT, UNITT
  * @param ... A user defined message
  */
 #define UNITTEST_ASSERT_NOT_REGEX_MATCH_MSG(string, regex, ...) \
-unittest::assertions::assert_not_regex_match(string, regex, UNITTEST_SPOT, UNITTEST_CALL(string, regex), static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_not_regex_match(string, regex, UNITTEST_SPOT, UNITTEST_CALL(string, regex), UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that a string does not match a regular expression (non-deadly assertion).
  * @param string A string
@@ -1200,7 +1200,7 @@ unittest::assertions::assert_not_regex_match(string, regex, UNITTEST_SPOT, UNITT
  * @param ... A user defined message
  */
 #define UNITTEST_NDASSERT_NOT_REGEX_MATCH_MSG(string, regex, ...) \
-unittest::assertions::assert_not_regex_match(string, regex, UNITTEST_SPOT, UNITTEST_CALL(string, regex), UNITTEST_NDAS, static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_not_regex_match(string, regex, UNITTEST_SPOT, UNITTEST_CALL(string, regex), UNITTEST_NDAS, UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that a functor throws exception.
  *  Required operators: ()
@@ -1217,7 +1217,7 @@ unittest::assertions::assert_throw<exception>(functor, UNITTEST_SPOT, UNITTEST_C
  * @param ... A user defined message
  */
 #define UNITTEST_ASSERT_THROW_MSG(exception, functor, ...) \
-unittest::assertions::assert_throw<exception>(functor, UNITTEST_SPOT, UNITTEST_CALL(exception, functor), static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_throw<exception>(functor, UNITTEST_SPOT, UNITTEST_CALL(exception, functor), UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that a functor throws exception (non-deadly assertion).
  *  Required operators: ()
@@ -1234,7 +1234,7 @@ unittest::assertions::assert_throw<exception>(functor, UNITTEST_SPOT, UNITTEST_C
  * @param ... A user defined message
  */
 #define UNITTEST_NDASSERT_THROW_MSG(exception, functor, ...) \
-unittest::assertions::assert_throw<exception>(functor, UNITTEST_SPOT, UNITTEST_CALL(exception, functor), UNITTEST_NDAS, static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_throw<exception>(functor, UNITTEST_SPOT, UNITTEST_CALL(exception, functor), UNITTEST_NDAS, UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that a functor does not throw any exception.
  *  Required operators: ()
@@ -1249,7 +1249,7 @@ unittest::assertions::assert_no_throw(functor, UNITTEST_SPOT, UNITTEST_CALL(func
  * @param ... A user defined message
  */
 #define UNITTEST_ASSERT_NO_THROW_MSG(functor, ...) \
-unittest::assertions::assert_no_throw(functor, UNITTEST_SPOT, UNITTEST_CALL(functor), static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_no_throw(functor, UNITTEST_SPOT, UNITTEST_CALL(functor), UNITTEST_MSG(__VA_ARGS__));
 /**
  * @brief Asserts that a functor does not throw any exception (non-deadly assertion).
  *  Required operators: ()
@@ -1264,4 +1264,36 @@ unittest::assertions::assert_no_throw(functor, UNITTEST_SPOT, UNITTEST_CALL(func
  * @param ... A user defined message
  */
 #define UNITTEST_NDASSERT_NO_THROW_MSG(functor, ...) \
-unittest::assertions::assert_no_throw(functor, UNITTEST_SPOT, UNITTEST_CALL(functor), UNITTEST_NDAS, static_cast<const std::ostringstream&>(std::ostringstream{} << __VA_ARGS__).str());
+unittest::assertions::assert_no_throw(functor, UNITTEST_SPOT, UNITTEST_CALL(functor), UNITTEST_NDAS, UNITTEST_MSG(__VA_ARGS__));
+/**
+ * @brief Asserts that the times of a parameter sweep fit a complexity class best
+ * @param expected The expected complexity class
+ * @param sweep The sweep result
+ */
+#define UNITTEST_ASSERT_COMPLEXITY(expected, sweep) \
+unittest::assertions::assert_complexity(expected, sweep, UNITTEST_SPOT, UNITTEST_CALL(expected, sweep));
+/**
+ * @brief Asserts that the times of a parameter sweep fit a complexity class best
+ * @param expected The expected complexity class
+ * @param sweep The sweep result
+ * @param ... A user defined message
+ */
+#define UNITTEST_ASSERT_COMPLEXITY_MSG(expected, sweep, ...) \
+unittest::assertions::assert_complexity(expected, sweep, UNITTEST_SPOT, UNITTEST_CALL(expected, sweep), UNITTEST_MSG(__VA_ARGS__));
+/**
+ * @brief Asserts that the times of a parameter sweep fit a complexity class best
+ *  (non-deadly assertion)
+ * @param expected The expected complexity class
+ * @param sweep The sweep result
+ */
+#define UNITTEST_NDASSERT_COMPLEXITY(expected, sweep) \
+unittest::assertions::assert_complexity(expected, sweep, UNITTEST_SPOT, UNITTEST_CALL(expected, sweep), UNITTEST_NDAS);
+/**
+ * @brief Asserts that the times of a parameter sweep fit a complexity class best
+ *  (non-deadly assertion)
+ * @param expected The expected complexity class
+ * @param sweep The sweep result
+ * @param ... A user defined message
+ */
+#define UNITTEST_NDASSERT_COMPLEXITY_MSG(expected, sweep, ...) \
+unittest::assertions::assert_complexity(expected, sweep, UNITTEST_SPOT, UNITTEST_CALL(expected, sweep), UNITTEST_NDAS, UNITTEST_MSG(__VA_ARGS__));
@@ -1265,3 +1265,35 @@ UNITTEST_NDASSERT_NO_THROW(functor)
  */
 #define NDASSERT_NO_THROW_MSG(functor, ...) \
 UNITTEST_NDASSERT_NO_THROW_MSG(functor, __VA_ARGS__)
+/**
+ * @brief Asserts that the times of a parameter sweep fit a complexity class best
+ * @param expected The expected complexity class
+ * @param sweep The sweep result
+ */
+#define ASSERT_COMPLEXITY(expected, sweep) \
+UNITTEST_ASSERT_COMPLEXITY(expected, sweep)
+/**
+ * @brief Asserts that the times of a parameter sweep fit a complexity class best
+ * @param expected The expected complexity class
+ * @param sweep The sweep result
+ * @param ... A user defined message
+ */
+#define ASSERT_COMPLEXITY_MSG(expected, sweep, ...) \
+UNITTEST_ASSERT_COMPLEXITY_MSG(expected, sweep, __VA_ARGS__)
+/**
+ * @brief Asserts that the times of a parameter sweep fit a complexity class best
+ *  (non-deadly assertion)
+ * @param expected The expected complexity class
+ * @param sweep The sweep result
+ */
+#define NDASSERT_COMPLEXITY(expected, sweep) \
+UNITTEST_NDASSERT_COMPLEXITY(expected, sweep)
+/**
+ * @brief Asserts that the times of a parameter sweep fit a complexity class best
+ *  (non-deadly assertion)
+ * @param expected The expected complexity class
+ * @param sweep The sweep result
+ * @param ... A user defined message
+ */
+#define NDASSERT_COMPLEXITY_MSG(expected, sweep, ...) \
+UNITTEST_NDASSERT_COMPLEXITY_MSG(expected, sweep, __VA_ARGS__)
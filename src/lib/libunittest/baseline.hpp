@@ -0,0 +1,157 @@
+/**
+ * @brief Comparing benchmarks against a baseline
+ * @file baseline.hpp
+ */
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+/**
+ * @brief Unit testing in C++
+ */
+namespace unittest {
+/**
+ * @brief Internal functionality, not relevant for most users
+ */
+namespace core {
+/**
+ * @brief Stores the comparison of a benchmark against its baseline
+ */
+struct benchcomparison {
+    /**
+     * @brief Constructor
+     */
+    benchcomparison();
+    /**
+     * @brief Whether the benchmark was compared
+     */
+    bool compared;
+    /**
+     * @brief The median time per iteration of the baseline in seconds
+     */
+    double baseline_median;
+    /**
+     * @brief The median of the benchmark divided by the median of the
+     *  baseline, greater than one if the benchmark got slower
+     */
+    double ratio;
+    /**
+     * @brief The one-sided p-value of the Mann-Whitney U test that the
+     *  benchmark got slower
+     */
+    double p_value;
+    /**
+     * @brief Whether the benchmark is significantly slower than the baseline
+     *  by more than the threshold
+     */
+    bool regressed;
+};
+/**
+ * @brief Computes the one-sided p-value of the Mann-Whitney U test that
+ *  the values of the second sample tend to be greater than the ones of the
+ *  first sample. Uses the normal approximation with tie and continuity
+ *  corrections, which needs about eight values per sample to become small
+ * @param first The first sample
+ * @param second The second sample
+ * @returns The p-value, one if any sample is empty
+ */
+double
+mann_whitney_p_value(const std::vector<double>& first,
+                     const std::vector<double>& second);
+/**
+ * @brief Compares the samples of a benchmark against the ones of its
+ *  baseline. A regression needs both a p-value below the significance
+ *  level and a ratio of the medians above one plus the threshold
+ * @param baseline The times per iteration of the baseline
+ * @param samples The times per iteration of the benchmark
+ * @param threshold The relative slowdown tolerated, e.g. 0.05
+ * @param significance The significance level, e.g. 0.01
+ * @returns The comparison, not compared if any sample is empty
+ */
+unittest::core::benchcomparison
+compare_benchmark(const std::vector<double>& baseline,
+                  const std::vector<double>& samples,
+                  double threshold,
+                  double significance);
+/**
+ * @brief The samples of benchmarks stored in a baseline file. Each line
+ *  of the file holds the full name of a benchmark and its times per
+ *  iteration separated by tabs
+ */
+class benchbaseline {
+public:
+    /**
+     * @brief Constructor
+     */
+    benchbaseline();
+    /**
+     * @brief Destructor
+     */
+    virtual
+    ~benchbaseline();
+    /**
+     * @brief Copy constructor. Deleted
+     * @param other An instance of benchbaseline
+     */
+    benchbaseline(const benchbaseline& other) = delete;
+    /**
+     * @brief Copy assignment operator. Deleted
+     * @param other An instance of benchbaseline
+     * @returns A benchbaseline instance
+     */
+    benchbaseline&
+    operator=(const benchbaseline& other) = delete;
+    /**
+     * @brief Move constructor. Deleted
+     * @param other An instance of benchbaseline
+     */
+    benchbaseline(benchbaseline&& other) = delete;
+    /**
+     * @brief Move assignment operator. Deleted
+     * @param other An instance of benchbaseline
+     * @returns A benchbaseline instance
+     */
+    benchbaseline&
+    operator=(benchbaseline&& other) = delete;
+    /**
+     * @brief Loads the baseline file. Does nothing if it does not exist
+     * @param filename The file name
+     */
+    void
+    load(const std::string& filename);
+    /**
+     * @brief Writes the baseline file, replacing it as a whole
+     * @param filename The file name
+     * @returns Whether the file was written
+     */
+    bool
+    save(const std::string& filename) const;
+    /**
+     * @brief Sets the samples of a benchmark, replacing earlier ones
+     * @param full_test_name The full name of the benchmark
+     * @param samples The times per iteration
+     */
+    void
+    record(const std::string& full_test_name,
+           const std::vector<double>& samples);
+    /**
+     * @brief Looks up the samples of a benchmark
+     * @param full_test_name The full name of the benchmark
+     * @returns The times per iteration, nullptr if not in the baseline
+     */
+    const std::vector<double>*
+    find(const std::string& full_test_name) const;
+    /**
+     * @brief Returns the number of benchmarks in the baseline
+     * @returns The number of benchmarks
+     */
+    size_t
+    size() const;
+
+private:
+    struct impl;
+    std::unique_ptr<impl> impl_;
+};
+
+} // core
+} // unittest
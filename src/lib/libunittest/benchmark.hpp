@@ -0,0 +1,416 @@
+/**
+ * @brief A harness for micro-benchmarks
+ * @file benchmark.hpp
+ */
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+/**
+ * @brief Unit testing in C++
+ */
+namespace unittest {
+/**
+ * @brief The complexity classes the times of a parameter sweep are fitted to
+ */
+enum class complexity : unsigned int {
+    constant = 0,
+    logarithmic = 1,
+    linear = 2,
+    linearithmic = 3,
+    quadratic = 4
+};
+/**
+ * @brief The state of a running benchmark. The benchmark body runs the
+ *  code to be measured in a loop of the form while (state.keep_running())
+ */
+class benchstate {
+public:
+    /**
+     * @brief Constructor
+     * @param iterations The number of iterations to run
+     */
+    explicit
+    benchstate(long long iterations);
+    /**
+     * @brief Constructor
+     * @param iterations The number of iterations to run
+     * @param range The input size of a parameter sweep
+     */
+    benchstate(long long iterations,
+               long long range);
+    /**
+     * @brief Starts the timing on the first call and stops it once all
+     *  iterations are done
+     * @returns Whether to run another iteration
+     */
+    bool
+    keep_running()
+    {
+        if (remaining_ > 0) {
+            if (remaining_==iterations_ && !is_running_)
+                resume_timing();
+            --remaining_;
+            return true;
+        }
+        if (is_running_)
+            pause_timing();
+        return false;
+    }
+    /**
+     * @brief Pauses the timing, e.g. for setting up the next iteration
+     */
+    void
+    pause_timing();
+    /**
+     * @brief Resumes the timing paused by pause_timing()
+     */
+    void
+    resume_timing();
+    /**
+     * @brief Returns the number of iterations to run
+     * @returns The number of iterations
+     */
+    long long
+    iterations() const;
+    /**
+     * @brief Returns the input size the benchmark is run with as part of a
+     *  parameter sweep
+     * @returns The input size, zero if not part of a sweep
+     */
+    long long
+    range() const;
+    /**
+     * @brief Sets the number of bytes processed per iteration to report
+     *  the throughput in bytes per second
+     * @param bytes The number of bytes per iteration
+     */
+    void
+    set_bytes_per_iteration(long long bytes);
+    /**
+     * @brief Returns the number of bytes processed per iteration
+     * @returns The number of bytes per iteration, zero if not set
+     */
+    long long
+    bytes_per_iteration() const;
+    /**
+     * @brief Returns the time measured so far in seconds
+     * @returns The time measured
+     */
+    double
+    elapsed() const;
+
+private:
+    long long iterations_;
+    long long range_;
+    long long remaining_;
+    long long bytes_per_iteration_;
+    bool is_running_;
+    std::chrono::steady_clock::time_point start_;
+    std::chrono::steady_clock::duration elapsed_;
+};
+/**
+ * @brief Prevents the compiler from optimizing away the computation of a
+ *  value, e.g. the result of the code to be benchmarked
+ * @param value The value
+ */
+template<typename T>
+inline void
+do_not_optimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = static_cast<const void*>(&value);
+#endif
+}
+/**
+ * @brief Prevents the compiler from optimizing away or reordering writes
+ *  to memory across this call
+ */
+inline void
+clobber_memory()
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#else
+    std::atomic_signal_fence(std::memory_order_acq_rel);
+#endif
+}
+/**
+ * @brief Internal functionality, not relevant for most users
+ */
+namespace core {
+/**
+ * @brief Stores the statistics of a benchmark. Times are in seconds per
+ *  iteration
+ */
+struct benchresult {
+    /**
+     * @brief Constructor
+     */
+    benchresult();
+    /**
+     * @brief Whether the benchmark was measured
+     */
+    bool measured;
+    /**
+     * @brief The number of iterations per sample
+     */
+    long long iterations;
+    /**
+     * @brief The time per iteration of every sample
+     */
+    std::vector<double> samples;
+    /**
+     * @brief The mean of the samples
+     */
+    double mean;
+    /**
+     * @brief The median of the samples
+     */
+    double median;
+    /**
+     * @brief The standard deviation of the samples
+     */
+    double stddev;
+    /**
+     * @brief The minimum of the samples
+     */
+    double min;
+    /**
+     * @brief The number of iterations per second given the mean
+     */
+    double throughput;
+    /**
+     * @brief The number of bytes per second given the mean, zero if the
+     *  benchmark does not set the bytes per iteration
+     */
+    double bytes_per_second;
+};
+/**
+ * @brief Stores the times of a parameter sweep and their best fitting
+ *  complexity class. Times are in seconds per iteration
+ */
+struct sweepresult {
+    /**
+     * @brief Constructor
+     */
+    sweepresult();
+    /**
+     * @brief Whether the sweep was measured
+     */
+    bool measured;
+    /**
+     * @brief The input sizes
+     */
+    std::vector<long long> ranges;
+    /**
+     * @brief The median time per iteration for every input size
+     */
+    std::vector<double> times;
+    /**
+     * @brief The complexity class fitting the times best
+     */
+    unittest::complexity best_fit;
+    /**
+     * @brief The coefficient of the best fit, i.e., the time per iteration
+     *  is about coefficient * f(n)
+     */
+    double coefficient;
+    /**
+     * @brief The root mean square of the residuals of the best fit in log
+     *  space, i.e., about the typical relative error of the fit
+     */
+    double rms;
+};
+/**
+ * @brief Returns the name of a complexity class, e.g. O(n log n)
+ * @param value The complexity class
+ * @returns The name
+ */
+std::string
+complexity_name(unittest::complexity value);
+/**
+ * @brief Looks up a complexity class by its name
+ * @param name The name as returned by complexity_name()
+ * @param value The complexity class found
+ * @returns Whether the name is known
+ */
+bool
+complexity_from_name(const std::string& name,
+                     unittest::complexity& value);
+/**
+ * @brief Returns the input sizes of a parameter sweep, i.e., first and its
+ *  multiples by powers of the multiplier up to and including last
+ * @param first The first input size, at least one
+ * @param last The last input size
+ * @param multiplier The factor between input sizes, at least two
+ * @returns The input sizes
+ */
+std::vector<long long>
+make_range(long long first,
+           long long last,
+           long long multiplier);
+/**
+ * @brief Fits the times of a parameter sweep to every complexity class and
+ *  picks the one with the smallest error. Every class is fitted by least
+ *  squares in log space, i.e., log(time) = log(coefficient) + log(f(n)),
+ *  such that all input sizes weigh the same. The logarithm in f(n) is taken
+ *  to be at least one. Simpler classes win ties
+ * @param ranges The input sizes
+ * @param times The time per iteration for every input size
+ * @returns The sweep result, not measured if no times are given
+ */
+unittest::core::sweepresult
+fit_complexity(const std::vector<long long>& ranges,
+               const std::vector<double>& times);
+/**
+ * @brief Returns the error of fitting the times of a sweep to a given
+ *  complexity class, in the same units as sweepresult::rms
+ * @param sweep The sweep result
+ * @param value The complexity class
+ * @returns The root mean square of the residuals in log space
+ */
+double
+complexity_error(const unittest::core::sweepresult& sweep,
+                 unittest::complexity value);
+/**
+ * @brief Whether the times of a sweep fit a complexity class. Apart from
+ *  the best fit, any class whose error is at most 0.1 (about ten percent)
+ *  above the one of the best fit is accepted since neighboring classes,
+ *  e.g. O(n) and O(n log n), are hard to tell apart on real timings
+ * @param sweep The sweep result
+ * @param expected The expected complexity class
+ * @returns Whether the class fits, false if the sweep was not measured
+ */
+bool
+fits_complexity(const unittest::core::sweepresult& sweep,
+                unittest::complexity expected);
+/**
+ * @brief Measures a benchmark for every input size and fits the median
+ *  times to the complexity classes
+ * @param body The benchmark body
+ * @param ranges The input sizes
+ * @param sample_time The target time per sample in seconds
+ * @param n_samples The number of samples per input size
+ * @returns The sweep result
+ */
+unittest::core::sweepresult
+measure_sweep(const std::function<void(unittest::benchstate&)>& body,
+              const std::vector<long long>& ranges,
+              double sample_time,
+              int n_samples);
+/**
+ * @brief Measures a parameter sweep with the sample time and the number of
+ *  samples given by the user arguments and records the result in the log
+ *  of the running test
+ * @param body The benchmark body
+ * @param ranges The input sizes
+ * @returns The sweep result
+ */
+unittest::core::sweepresult
+run_sweep(const std::function<void(unittest::benchstate&)>& body,
+          const std::vector<long long>& ranges);
+/**
+ * @brief Computes the statistics of the given samples
+ * @param samples The times per iteration
+ * @param iterations The number of iterations per sample
+ * @param bytes_per_iteration The number of bytes per iteration, zero if
+ *  not known
+ * @returns The benchmark result
+ */
+unittest::core::benchresult
+make_benchresult(std::vector<double> samples,
+                 long long iterations,
+                 long long bytes_per_iteration);
+/**
+ * @brief Measures a benchmark. Calibrates the number of iterations such
+ *  that a sample takes at least the sample time, runs one sample as warmup,
+ *  and then takes the samples
+ * @param body The benchmark body
+ * @param sample_time The target time per sample in seconds
+ * @param n_samples The number of samples
+ * @returns The benchmark result
+ */
+unittest::core::benchresult
+measure_benchmark(const std::function<void(unittest::benchstate&)>& body,
+                  double sample_time,
+                  int n_samples);
+/**
+ * @brief Measures a benchmark run with the given input size. Calibrates
+ *  the number of iterations such that a sample takes at least the sample
+ *  time, runs one sample as warmup, and then takes the samples
+ * @param body The benchmark body
+ * @param range The input size passed to the body through its state
+ * @param sample_time The target time per sample in seconds
+ * @param n_samples The number of samples
+ * @returns The benchmark result
+ */
+unittest::core::benchresult
+measure_benchmark(const std::function<void(unittest::benchstate&)>& body,
+                  long long range,
+                  double sample_time,
+                  int n_samples);
+/**
+ * @brief Measures a benchmark with the sample time and the number of
+ *  samples given by the user arguments and records the result in the log
+ *  of the running test
+ * @param body The benchmark body
+ */
+void
+run_benchmark(const std::function<void(unittest::benchstate&)>& body);
+/**
+ * @brief Records a benchmark result in the log of the test running on the
+ *  calling thread. Does nothing if no test is running
+ * @param result The benchmark result
+ */
+void
+record_benchmark(const unittest::core::benchresult& result);
+/**
+ * @brief Records a sweep result in the log of the test running on the
+ *  calling thread. Does nothing if no test is running
+ * @param result The sweep result
+ */
+void
+record_sweep(const unittest::core::sweepresult& result);
+/**
+ * @brief Directs the benchmark and sweep results recorded by the calling
+ *  thread to the given results for the lifetime of the scope
+ */
+class benchscope {
+public:
+    /**
+     * @brief Constructor
+     * @param result The benchmark result to record to, can be a nullptr
+     * @param sweep The sweep result to record to, can be a nullptr
+     */
+    benchscope(unittest::core::benchresult* result,
+               unittest::core::sweepresult* sweep);
+    /**
+     * @brief Destructor. Restores the previous results
+     */
+    ~benchscope();
+    /**
+     * @brief Copy constructor. Deleted
+     * @param other An instance of benchscope
+     */
+    benchscope(const benchscope& other) = delete;
+    /**
+     * @brief Copy assignment operator. Deleted
+     * @param other An instance of benchscope
+     * @returns A benchscope instance
+     */
+    benchscope&
+    operator=(const benchscope& other) = delete;
+
+private:
+    unittest::core::benchresult* previous_;
+    unittest::core::sweepresult* previous_sweep_;
+};
+
+} // core
+} // unittest
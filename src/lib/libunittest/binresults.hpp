@@ -0,0 +1,256 @@
+/**
+ * @brief The compact binary results format
+ * @file binresults.hpp
+ */
+#pragma once
+#include "testreporter.hpp"
+#include "testlog.hpp"
+#include "testresults.hpp"
+#include <ostream>
+#include <string>
+#include <chrono>
+#include <memory>
+#include <vector>
+/**
+ * @brief Unit testing in C++
+ */
+namespace unittest {
+/**
+ * @brief Internal functionality, not relevant for most users
+ */
+namespace core {
+
+class binreader;
+/**
+ * @brief Writes test results in the compact binary format. The file holds
+ *  a header with the suite info and the totals, followed by a fixed-size
+ *  record per test, a fixed-size record per non-deadly failure, and a
+ *  string table holding every distinct name, message, and file path once.
+ *  Records are written as tests are reported, the remainder on finishing.
+ *  The header is filled in on finishing, or repeated at the end of the file
+ *  if the stream cannot seek, e.g. a pipe. Values are stored in the byte
+ *  order of the writing machine
+ */
+class binwriter : public unittest::core::testreporter {
+public:
+    /**
+     * @brief Constructor. Reserves the header
+     * @param stream The output stream
+     * @param suite_name the name of the test suite
+     * @param shuffle_seed The shuffle seed
+     * @param shard_index The index of the shard
+     * @param shard_count The number of shards
+     * @param time_point The time point of the suite start (defaults to now)
+     */
+    binwriter(std::shared_ptr<std::ostream> stream,
+              const std::string& suite_name,
+              long long shuffle_seed,
+              int shard_index,
+              int shard_count,
+              const std::chrono::system_clock::time_point& time_point=std::chrono::system_clock::now());
+    /**
+     * @brief Destructor
+     */
+    virtual
+    ~binwriter();
+    /**
+     * @brief Copy constructor. Deleted
+     * @param other An instance of binwriter
+     */
+    binwriter(const binwriter& other) = delete;
+    /**
+     * @brief Copy assignment operator. Deleted
+     * @param other An instance of binwriter
+     * @returns A binwriter instance
+     */
+    binwriter&
+    operator=(const binwriter& other) = delete;
+    /**
+     * @brief Move constructor. Deleted
+     * @param other An instance of binwriter
+     */
+    binwriter(binwriter&& other) = delete;
+    /**
+     * @brief Move assignment operator. Deleted
+     * @param other An instance of binwriter
+     * @returns A binwriter instance
+     */
+    binwriter&
+    operator=(binwriter&& other) = delete;
+    /**
+     * @brief Appends the record of a test. Thread-safe
+     * @param log The test log
+     */
+    void
+    report(const unittest::core::testlog& log);
+    /**
+     * @brief Appends all records of a binary results file without decoding
+     *  them into test logs. Only the distinct strings are copied. Thread-safe
+     * @param reader The reader of the binary results file
+     */
+    void
+    append(const unittest::core::binreader& reader);
+    /**
+     * @brief Appends a single record of a binary results file without
+     *  decoding it into a test log. Its strings are interned straight from
+     *  the string table of the file. Thread-safe
+     * @param reader The reader of the binary results file
+     * @param index The index of the record
+     */
+    void
+    append(const unittest::core::binreader& reader,
+           size_t index);
+    /**
+     * @brief Writes the failures and the string table, and fills in the
+     *  header or appends it if the stream cannot seek. Thread-safe
+     * @param results The test results providing the totals
+     */
+    void
+    finish(const unittest::core::testresults& results);
+
+private:
+    struct impl;
+    std::unique_ptr<impl> impl_;
+};
+/**
+ * @brief Reads a file in the compact binary format. The file is mapped
+ *  into memory and only the records asked for are decoded
+ */
+class binreader {
+public:
+    /**
+     * @brief Constructor. Throws std::runtime_error if the file cannot be
+     *  read or is not a complete binary results file
+     * @param filename The file name
+     */
+    explicit
+    binreader(const std::string& filename);
+    /**
+     * @brief Destructor
+     */
+    virtual
+    ~binreader();
+    /**
+     * @brief Copy constructor. Deleted
+     * @param other An instance of binreader
+     */
+    binreader(const binreader& other) = delete;
+    /**
+     * @brief Copy assignment operator. Deleted
+     * @param other An instance of binreader
+     * @returns A binreader instance
+     */
+    binreader&
+    operator=(const binreader& other) = delete;
+    /**
+     * @brief Move constructor. Deleted
+     * @param other An instance of binreader
+     */
+    binreader(binreader&& other) = delete;
+    /**
+     * @brief Move assignment operator. Deleted
+     * @param other An instance of binreader
+     * @returns A binreader instance
+     */
+    binreader&
+    operator=(binreader&& other) = delete;
+    /**
+     * @brief Returns the number of test records
+     * @returns The number of test records
+     */
+    size_t
+    size() const;
+    /**
+     * @brief Decodes a single test record
+     * @param index The index of the record
+     * @returns The test log
+     */
+    unittest::core::testlog
+    log(size_t index) const;
+    /**
+     * @brief Decodes only the class name, the test name, and the outcome
+     *  of a record, i.e. the status, the successful flag, and the timeout
+     *  flag. The strings keep their capacity, so peeking at one record
+     *  after the other does not allocate
+     * @param index The index of the record
+     * @param log The test log whose names and outcome are assigned
+     */
+    void
+    peek(size_t index,
+         unittest::core::testlog& log) const;
+    /**
+     * @brief Checks whether two records have the same class name and test
+     *  name. Compares the offsets into the string table before the strings
+     * @param first The index of the first record
+     * @param second The index of the second record
+     * @returns Whether the records have the same names
+     */
+    bool
+    is_same_name(size_t first,
+                 size_t second) const;
+    /**
+     * @brief Orders the records by class name and test name without
+     *  decoding them. Records of equal names keep their order
+     * @returns The record indices in the order of the names
+     */
+    std::vector<size_t>
+    sorted_by_name() const;
+    /**
+     * @brief Returns the totals without decoding any records
+     * @returns The test results without test logs
+     */
+    unittest::core::testresults
+    totals() const;
+    /**
+     * @brief Decodes all records
+     * @returns The test results including all test logs
+     */
+    unittest::core::testresults
+    results() const;
+    /**
+     * @brief Returns the name of the test suite
+     * @returns The name of the test suite
+     */
+    std::string
+    suite_name() const;
+    /**
+     * @brief Returns the shuffle seed
+     * @returns The shuffle seed
+     */
+    long long
+    shuffle_seed() const;
+    /**
+     * @brief Returns the index of the shard
+     * @returns The index of the shard
+     */
+    int
+    shard_index() const;
+    /**
+     * @brief Returns the number of shards
+     * @returns The number of shards
+     */
+    int
+    shard_count() const;
+    /**
+     * @brief Returns the time point of the suite start
+     * @returns The time point of the suite start
+     */
+    std::chrono::system_clock::time_point
+    time_point() const;
+
+private:
+    friend class binwriter;
+    struct impl;
+    std::unique_ptr<impl> impl_;
+};
+
+/**
+ * @brief Checks whether a file is in the compact binary results format
+ * @param filename The file name
+ * @returns Whether the file starts like a binary results file
+ */
+bool
+is_binresults(const std::string& filename);
+
+} // core
+} // unittest
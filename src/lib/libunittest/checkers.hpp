@@ -28,12 +28,12 @@ template<typename T,
          typename... Args>
 void
 check_isfinite(const T& value,
-               const std::string& argument,
-               const std::string& caller,
+               const char* argument,
+               const char* caller,
                const Args&... message)
 {
     if (!unittest::core::isfinite(value)) {
-        const std::string text = argument + " is not finite" + unittest::core::str_if(": ", value);
+        const std::string text = std::string(argument) + " is not finite" + unittest::core::str_if(": ", value);
         unittest::fail(caller, text, message...);
     }
 }
@@ -49,14 +49,14 @@ template<typename T,
          typename... Args>
 void
 check_isfinite_container(const T& container,
-                         const std::string& argument,
-                         const std::string& caller,
+                         const char* argument,
+                         const char* caller,
                          const Args&... message)
 {
     auto begin = std::begin(container);
     auto end = std::end(container);
     if (!std::all_of(begin, end, [](decltype(*begin) v) { return unittest::core::isfinite(v); })) {
-        const std::string text = argument + " contains non-finite elements";
+        const std::string text = std::string(argument) + " contains non-finite elements";
         unittest::fail(caller, text, message...);
     }
 }
@@ -72,12 +72,12 @@ template<typename T,
          typename... Args>
 void
 check_isnan(const T& value,
-            const std::string& argument,
-            const std::string& caller,
+            const char* argument,
+            const char* caller,
             const Args&... message)
 {
     if (unittest::core::isnan(value)) {
-        const std::string text = argument + " is not a number" + unittest::core::str_if(": ", value);
+        const std::string text = std::string(argument) + " is not a number" + unittest::core::str_if(": ", value);
         unittest::fail(caller, text, message...);
     }
 }
@@ -91,7 +91,7 @@ template<typename T,
          typename... Args>
 void
 check_epsilon(const T& epsilon,
-              const std::string& caller,
+              const char* caller,
               const Args&... message)
 {
     unittest::core::check_isfinite(epsilon, "epsilon", caller, message...);
@@ -113,7 +113,7 @@ template<typename T,
 void
 check_range_bounds(const T& lower,
                    const U& upper,
-                   const std::string& caller,
+                   const char* caller,
                    const Args&... message)
 {
     unittest::core::check_isfinite(lower, "lower bound", caller, message...);
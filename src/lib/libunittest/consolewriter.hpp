@@ -0,0 +1,118 @@
+/**
+ * @brief The buffered writer of the per-test console output
+ * @file consolewriter.hpp
+ */
+#pragma once
+#include "testlog.hpp"
+#include <ostream>
+#include <string>
+#include <vector>
+#include <memory>
+/**
+ * @brief Unit testing in C++
+ */
+namespace unittest {
+/**
+ * @brief Internal functionality, not relevant for most users
+ */
+namespace core {
+/**
+ * @brief The ways the per-test console output is written
+ */
+enum class consolemode : unsigned int {
+    /**
+     * @brief Messages are written in the order the tests finish
+     */
+    buffered = 0,
+    /**
+     * @brief Messages are held back and written at the end of the run
+     *  ordered by the registration of the test classes and test methods
+     */
+    ordered = 1,
+    /**
+     * @brief No per-test output is written at all
+     */
+    silent = 2
+};
+/**
+ * @brief Writes the per-test console output. Every calling thread appends
+ *  complete messages to a buffer of its own. The buffers are drained by a
+ *  single writer such that a block is written at most once per interval.
+ *  In verbose mode a line holding the test name and the result is written
+ *  once the test is finished
+ */
+class consolewriter {
+public:
+    /**
+     * @brief Constructor
+     * @param stream The output stream, must outlive the writer
+     * @param verbose Whether to use verbose output
+     * @param mode The way messages are written
+     * @param interval The interval in seconds between block writes. Messages
+     *  are written at once if not greater than zero
+     * @param class_names The names of the test classes in registration order
+     * @param threaded Whether a thread drains the buffers. Otherwise, buffers
+     *  are drained by the calling threads if the interval has passed
+     */
+    consolewriter(std::ostream& stream,
+                  bool verbose,
+                  unittest::core::consolemode mode,
+                  double interval,
+                  const std::vector<std::string>& class_names={},
+                  bool threaded=true);
+    /**
+     * @brief Destructor. Writes all pending messages
+     */
+    virtual
+    ~consolewriter();
+    /**
+     * @brief Copy constructor. Deleted
+     * @param other An instance of consolewriter
+     */
+    consolewriter(const consolewriter& other) = delete;
+    /**
+     * @brief Copy assignment operator. Deleted
+     * @param other An instance of consolewriter
+     * @returns A consolewriter instance
+     */
+    consolewriter&
+    operator=(const consolewriter& other) = delete;
+    /**
+     * @brief Move constructor. Deleted
+     * @param other An instance of consolewriter
+     */
+    consolewriter(consolewriter&& other) = delete;
+    /**
+     * @brief Move assignment operator. Deleted
+     * @param other An instance of consolewriter
+     * @returns A consolewriter instance
+     */
+    consolewriter&
+    operator=(consolewriter&& other) = delete;
+    /**
+     * @brief Buffers the message of a finished test. Nothing is buffered for
+     *  a timed out test. Thread-safe
+     * @param log The test log
+     */
+    void
+    write_end(const unittest::core::testlog& log);
+    /**
+     * @brief Buffers the message of a timed out test. Thread-safe
+     * @param log The test log
+     */
+    void
+    write_timeout(const unittest::core::testlog& log);
+    /**
+     * @brief Writes all buffered messages, including the ones held back
+     *  in ordered mode. Thread-safe
+     */
+    void
+    flush();
+
+private:
+    struct impl;
+    std::unique_ptr<impl> impl_;
+};
+
+} // core
+} // unittest
@@ -0,0 +1,159 @@
+/**
+ * @brief The failure sink collecting the failures of non-deadly assertions
+ * @file failuresink.hpp
+ */
+#pragma once
+#include "testfailure.hpp"
+#include <string>
+#include <vector>
+#include <memory>
+/**
+ * @brief Unit testing in C++
+ */
+namespace unittest {
+/**
+ * @brief Internal functionality, not relevant for most users
+ */
+namespace core {
+/**
+ * @brief Collects the failures of non-deadly assertions of a single test.
+ *  Failures are pushed without locking such that helper threads of a test
+ *  may report failures concurrently. The sink of the running test is
+ *  installed per thread by a failurescope and held by the test object such
+ *  that non-deadly assertions in its methods find it from any thread. Sinks are shared such that a
+ *  helper thread outliving its test never reports to a destroyed sink,
+ *  failures reported after the test has finished are dropped
+ */
+class failuresink {
+public:
+    /**
+     * @brief Constructor
+     * @param method_id The ID of the test method
+     */
+    explicit
+    failuresink(const std::string& method_id);
+    /**
+     * @brief Destructor
+     */
+    virtual
+    ~failuresink();
+    /**
+     * @brief Copy constructor. Deleted
+     * @param other An instance of failuresink
+     */
+    failuresink(const failuresink& other) = delete;
+    /**
+     * @brief Copy assignment operator. Deleted
+     * @param other An instance of failuresink
+     * @returns An failuresink instance
+     */
+    failuresink&
+    operator=(const failuresink& other) = delete;
+    /**
+     * @brief Move constructor. Deleted
+     * @param other An instance of failuresink
+     */
+    failuresink(failuresink&& other) = delete;
+    /**
+     * @brief Move assignment operator. Deleted
+     * @param other An instance of failuresink
+     * @returns An failuresink instance
+     */
+    failuresink&
+    operator=(failuresink&& other) = delete;
+    /**
+     * @brief Returns the ID of the test method
+     * @returns The ID of the test method
+     */
+    const std::string&
+    method_id() const;
+    /**
+     * @brief Adds a failure. Thread-safe
+     * @param failure The failure
+     */
+    void
+    push(const unittest::testfailure& failure);
+    /**
+     * @brief Removes all failures from the sink
+     * @returns The failures in the order they were added
+     */
+    std::vector<unittest::testfailure>
+    take();
+    /**
+     * @brief Returns the sink installed for the calling thread
+     * @returns A pointer to the sink, nullptr if none is installed
+     */
+    static failuresink*
+    current();
+    /**
+     * @brief Returns shared ownership of the sink installed for the calling
+     *  thread, e.g. to install it for a helper thread
+     * @returns The sink, nullptr if none is installed
+     */
+    static std::shared_ptr<failuresink>
+    acquire();
+
+private:
+    struct impl;
+    std::unique_ptr<impl> impl_;
+};
+/**
+ * @brief Installs a failure sink for the calling thread during its lifetime.
+ *  Can be used to let helper threads of a test report non-deadly failures
+ */
+class failurescope {
+public:
+    /**
+     * @brief Constructor. Installs the given sink and keeps it alive
+     * @param sink The failure sink, can be a nullptr
+     */
+    explicit
+    failurescope(std::shared_ptr<unittest::core::failuresink> sink);
+    /**
+     * @brief Destructor. Reinstalls the previous sink
+     */
+    virtual
+    ~failurescope();
+    /**
+     * @brief Copy constructor. Deleted
+     * @param other An instance of failurescope
+     */
+    failurescope(const failurescope& other) = delete;
+    /**
+     * @brief Copy assignment operator. Deleted
+     * @param other An instance of failurescope
+     * @returns An failurescope instance
+     */
+    failurescope&
+    operator=(const failurescope& other) = delete;
+    /**
+     * @brief Move constructor. Deleted
+     * @param other An instance of failurescope
+     */
+    failurescope(failurescope&& other) = delete;
+    /**
+     * @brief Move assignment operator. Deleted
+     * @param other An instance of failurescope
+     * @returns An failurescope instance
+     */
+    failurescope&
+    operator=(failurescope&& other) = delete;
+
+private:
+    std::shared_ptr<unittest::core::failuresink> sink_;
+    const std::shared_ptr<unittest::core::failuresink>* previous_;
+};
+
+} // core
+} // unittest
+/**
+ * @brief Returns the failure sink used by non-deadly assertions outside of
+ *  test methods, i.e., the sink installed for the calling thread. Within
+ *  test methods this is hidden by testcase::unittest_ndas_sink
+ * @returns The failure sink, nullptr if none is installed
+ */
+inline std::shared_ptr<unittest::core::failuresink>
+unittest_ndas_sink()
+{
+    return unittest::core::failuresink::acquire();
+}
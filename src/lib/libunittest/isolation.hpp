@@ -0,0 +1,120 @@
+/**
+ * @brief Running test classes in isolated child processes
+ * @file isolation.hpp
+ */
+#pragma once
+#include <string>
+#include <vector>
+#include <functional>
+/**
+ * @brief Unit testing in C++
+ */
+namespace unittest {
+/**
+ * @brief Internal functionality, not relevant for most users
+ */
+namespace core {
+/**
+ * @brief Returns whether the calling process is a child process running
+ *  a test class in isolation
+ * @returns Whether the calling process is an isolated child
+ */
+bool
+is_isolated_child();
+/**
+ * @brief Returns whether the calling process is an isolated child which
+ *  gets killed by its parent when a test exceeds its timeout, i.e., unless
+ *  -K is given. Such a child does not observe test timeouts itself
+ * @returns Whether timeouts kill the calling process
+ */
+bool
+is_killed_on_timeout();
+/**
+ * @brief Limits the address space of an isolated child by RLIMIT_AS for the
+ *  lifetime of the scope. The limit is the current size plus the memory
+ *  budget plus some headroom for thread stacks and malloc arenas. It
+ *  catches memory not allocated through operator new, which fails with
+ *  std::bad_alloc or a null pointer. As the limit applies to the whole
+ *  process, it does nothing if several tests could run at the same time,
+ *  i.e., outside isolated children and when the test methods of a class
+ *  run in parallel (-m). Also does nothing on platforms without RLIMIT_AS
+ */
+class addressspacelimit {
+public:
+    /**
+     * @brief Constructor
+     * @param memory_budget The memory budget in bytes (ignored if <= 0)
+     */
+    explicit
+    addressspacelimit(long long memory_budget);
+    /**
+     * @brief Destructor. Restores the previous limit
+     */
+    ~addressspacelimit();
+    /**
+     * @brief Copy constructor. Deleted
+     * @param other An instance of addressspacelimit
+     */
+    addressspacelimit(const addressspacelimit& other) = delete;
+    /**
+     * @brief Copy assignment operator. Deleted
+     * @param other An instance of addressspacelimit
+     * @returns An addressspacelimit instance
+     */
+    addressspacelimit&
+    operator=(const addressspacelimit& other) = delete;
+
+private:
+    bool is_set_;
+    unsigned long long previous_;
+};
+/**
+ * @brief Runs every class run in its own child process forked from the
+ *  calling process, which has already registered all tests and parsed the
+ *  arguments. The children report their test logs back through a pipe.
+ *  A test that crashes its child is logged as an error and a test exceeding
+ *  its timeout gets its child killed. In both cases the remaining tests of
+ *  the class continue in a new child. Falls back to running the class runs
+ *  in-process on platforms without fork()
+ * @param class_runs The class runs
+ * @param class_names The names of the test classes of the class runs
+ * @param n_children The maximum number of children running at the same time
+ */
+void
+call_isolated(const std::vector<std::function<void()>>& class_runs,
+              const std::vector<std::string>& class_names,
+              int n_children);
+
+/**
+ * @brief Runs class runs on long-lived worker processes which re-execute
+ *  the test application. Each worker receives one class index at a time
+ *  and reports its test logs back through a pipe. Crashes and timeouts are
+ *  handled as in call_isolated(). Not supported on platforms without fork()
+ * @param class_indices The indices of the class runs to be run in this order
+ * @param class_names The names of all test classes
+ * @param n_workers The number of worker processes
+ * @param argv The arguments the test application was started with
+ */
+void
+call_workers(const std::vector<size_t>& class_indices,
+             const std::vector<std::string>& class_names,
+             int n_workers,
+             char** argv);
+/**
+ * @brief Returns whether the calling process was started as a worker
+ *  process by call_workers()
+ * @returns Whether the calling process is a worker process
+ */
+bool
+is_worker_process();
+/**
+ * @brief Serves the class runs requested by the parent of a worker process
+ *  until the parent has no more work
+ * @param class_runs All class runs
+ * @returns The exit code of the worker process
+ */
+int
+run_worker(const std::vector<std::function<void()>>& class_runs);
+
+} // core
+} // unittest
@@ -0,0 +1,101 @@
+/**
+ * @brief The reporter streaming test events as JSON Lines
+ * @file jsonreporter.hpp
+ */
+#pragma once
+#include "testreporter.hpp"
+#include <ostream>
+#include <string>
+#include <chrono>
+#include <memory>
+/**
+ * @brief Unit testing in C++
+ */
+namespace unittest {
+/**
+ * @brief Internal functionality, not relevant for most users
+ */
+namespace core {
+/**
+ * @brief Streams test events as JSON Lines, i.e. one JSON object per line.
+ *  Every object has an "event" member being one of suite_start, test_start,
+ *  failure, timeout, test_end, and suite_end. Events are written through a
+ *  buffer that is flushed when it grows large or at least every second
+ *  such that the stream can be tailed without a write per event
+ */
+class jsonreporter : public unittest::core::testreporter {
+public:
+    /**
+     * @brief Constructor. Writes the suite_start event
+     * @param stream The output stream
+     * @param suite_name the name of the test suite
+     * @param shuffle_seed The shuffle seed
+     * @param shard_index The index of the shard
+     * @param shard_count The number of shards (no shard is written if less than two)
+     * @param time_point The time point of the suite start (defaults to now)
+     * @param local_time Whether timestamps are displayed in local time
+     */
+    jsonreporter(std::shared_ptr<std::ostream> stream,
+                 const std::string& suite_name,
+                 long long shuffle_seed,
+                 int shard_index,
+                 int shard_count,
+                 const std::chrono::system_clock::time_point& time_point=std::chrono::system_clock::now(),
+                 bool local_time=true);
+    /**
+     * @brief Destructor. Flushes the buffer
+     */
+    virtual
+    ~jsonreporter();
+    /**
+     * @brief Copy constructor. Deleted
+     * @param other An instance of jsonreporter
+     */
+    jsonreporter(const jsonreporter& other) = delete;
+    /**
+     * @brief Copy assignment operator. Deleted
+     * @param other An instance of jsonreporter
+     * @returns A jsonreporter instance
+     */
+    jsonreporter&
+    operator=(const jsonreporter& other) = delete;
+    /**
+     * @brief Move constructor. Deleted
+     * @param other An instance of jsonreporter
+     */
+    jsonreporter(jsonreporter&& other) = delete;
+    /**
+     * @brief Move assignment operator. Deleted
+     * @param other An instance of jsonreporter
+     * @returns A jsonreporter instance
+     */
+    jsonreporter&
+    operator=(jsonreporter&& other) = delete;
+    /**
+     * @brief Writes the test_start event. Thread-safe
+     * @param log The test log
+     */
+    void
+    start(const unittest::core::testlog& log);
+    /**
+     * @brief Writes a failure event per failure, a timeout event if the
+     *  test has timed out, and the test_end event. Thread-safe
+     * @param log The test log
+     */
+    void
+    report(const unittest::core::testlog& log);
+    /**
+     * @brief Writes the suite_end event with the totals and flushes.
+     *  Thread-safe
+     * @param results The test results providing the totals
+     */
+    void
+    finish(const unittest::core::testresults& results);
+
+private:
+    struct impl;
+    std::unique_ptr<impl> impl_;
+};
+
+} // core
+} // unittest
@@ -10,6 +10,13 @@
  */
 #define UNITTEST_CLASS(test_class) \
 typedef test_class __test_class__;
+/**
+ * @brief Marks a test class as not thread-safe. To be placed inside the class
+ *  body. The test methods of such a class always run one after the other,
+ *  even if running test methods in parallel is enabled
+ */
+#define UNITTEST_NOT_THREADSAFE \
+typedef void __not_threadsafe__;
 /**
  * @brief A test run
  * @param test_method The test method
@@ -55,6 +62,13 @@ unittest::testrun(std::shared_ptr<typename __test_class__::context_type>(nullptr
  */
 #define UNITTEST_RUN_TIME_MAYBE(test_method, timeout, is_run, skip_message) \
 unittest::testrun(std::shared_ptr<typename __test_class__::context_type>(nullptr), &__test_class__::test_method, #test_method, !is_run, skip_message, timeout);
+/**
+ * @brief A test run with a memory budget
+ * @param test_method The test method
+ * @param memory_budget The maximum allowed peak of heap bytes (ignored if <= 0)
+ */
+#define UNITTEST_RUN_MEM(test_method, memory_budget) \
+unittest::testrun(std::shared_ptr<typename __test_class__::context_type>(nullptr), &__test_class__::test_method, #test_method, false, "", -1., memory_budget);
 /**
  * @brief A test run with a test context
  * @param test_context The test context
@@ -107,21 +121,35 @@ unittest::testrun(test_context, &__test_class__::test_method, #test_method, true
 #define UNITTEST_RUNCTX_TIME_MAYBE(test_context, test_method, timeout, is_run, skip_message) \
 unittest::testrun(test_context, &__test_class__::test_method, #test_method, !is_run, skip_message, timeout);
 /**
- * @brief Defines a string with info about the current file name
- *  and the current line number
+ * @brief A test run with a test context and a memory budget
+ * @param test_context The test context
+ * @param test_method The test method
+ * @param memory_budget The maximum allowed peak of heap bytes (ignored if <= 0)
+ */
+#define UNITTEST_RUNCTX_MEM(test_context, test_method, memory_budget) \
+unittest::testrun(test_context, &__test_class__::test_method, #test_method, false, "", -1., memory_budget);
+/**
+ * @brief Defines a record of the current file name and the current
+ *  line number
  */
 #define UNITTEST_SPOT \
-unittest::core::string_of_file_and_line(__FILE__, __LINE__)
+unittest::core::sourcespot{__FILE__, __LINE__}
 /**
- * @brief Defines a string indicating the use of non-deadly assertions
+ * @brief Defines a tag indicating the use of non-deadly assertions. Within
+ *  test methods the failures go to the running test also from helper threads
  */
 #define UNITTEST_NDAS \
-unittest::core::string_of_tagged_text(this->get_test_id(), "NDAS")
+unittest::core::ndastag{unittest_ndas_sink()}
 /**
- * @brief Defines a string of the call site
+ * @brief Defines a record of the call site
  */
 #define UNITTEST_CALL(...) \
-unittest::core::string_of_tagged_text(#__VA_ARGS__, "CALL")
+unittest::core::sourcecall{#__VA_ARGS__}
+/**
+ * @brief Defines a user message that is only formatted if an assertion fails
+ */
+#define UNITTEST_MSG(...) \
+unittest::core::make_deferredmsg([&](std::ostream& __stream__) { __stream__ << __VA_ARGS__; })
 /**
  * @brief Logs info for the current test
  */
@@ -211,6 +239,13 @@ __UNITTEST_TEST_PLAIN_TIME(unittest::sometype, test_name, timeout, true, skip_me
  */
 #define UNITTEST_TEST_TIME_MAYBE(test_name, timeout, is_run, skip_message) \
 __UNITTEST_TEST_PLAIN_TIME(unittest::sometype, test_name, timeout, !is_run, skip_message)
+/**
+ * @brief Sets up a plain test with a memory budget
+ * @param test_name The name of the test
+ * @param memory_budget The maximum allowed peak of heap bytes (ignored if <= 0)
+ */
+#define UNITTEST_TEST_MEM(test_name, memory_budget) \
+__UNITTEST_TEST_PLAIN_MEM(unittest::sometype, test_name, memory_budget)
 /**
  * @brief Sets up a plain test with a test fixture
  * @param fixture The test fixture
@@ -262,6 +297,50 @@ __UNITTEST_TEST_PLAIN_TIME(fixture, test_name, timeout, true, skip_message)
  */
 #define UNITTEST_TEST_FIXTURE_TIME_MAYBE(fixture, test_name, timeout, is_run, skip_message) \
 __UNITTEST_TEST_PLAIN_TIME(fixture, test_name, timeout, !is_run, skip_message)
+/**
+ * @brief Sets up a plain test with a test fixture and a memory budget
+ * @param fixture The test fixture
+ * @param test_name The name of the test
+ * @param memory_budget The maximum allowed peak of heap bytes (ignored if <= 0)
+ */
+#define UNITTEST_TEST_FIXTURE_MEM(fixture, test_name, memory_budget) \
+__UNITTEST_TEST_PLAIN_MEM(fixture, test_name, memory_budget)
+/**
+ * @brief Sets up a benchmark. The body is given the benchmark state as
+ *  state and runs the code to be measured in a loop of the form
+ *  while (state.keep_running())
+ * @param bench_name The name of the benchmark
+ */
+#define UNITTEST_BENCH(bench_name) \
+__UNITTEST_BENCH_PLAIN(unittest::sometype, bench_name)
+/**
+ * @brief Sets up a benchmark with a test fixture
+ * @param fixture The test fixture
+ * @param bench_name The name of the benchmark
+ */
+#define UNITTEST_BENCH_FIXTURE(fixture, bench_name) \
+__UNITTEST_BENCH_PLAIN(fixture, bench_name)
+/**
+ * @brief Sets up a parameter sweep. The body is run as a benchmark for the
+ *  input sizes first, 2 * first, 4 * first, ... up to and including last
+ *  and gets the input size from state.range(). The median times are fitted
+ *  to the complexity classes
+ * @param bench_name The name of the benchmark
+ * @param first The first input size
+ * @param last The last input size
+ */
+#define UNITTEST_BENCH_SWEEP(bench_name, first, last) \
+__UNITTEST_BENCH_SWEEP_PLAIN(unittest::sometype, bench_name, first, last, false, unittest::complexity::constant)
+/**
+ * @brief Sets up a parameter sweep which fails unless its times fit the
+ *  expected complexity class (see unittest::core::fits_complexity)
+ * @param bench_name The name of the benchmark
+ * @param first The first input size
+ * @param last The last input size
+ * @param expected The expected complexity class, e.g. unittest::complexity::linear
+ */
+#define UNITTEST_BENCH_SWEEP_COMPLEXITY(bench_name, first, last, expected) \
+__UNITTEST_BENCH_SWEEP_PLAIN(unittest::sometype, bench_name, first, last, true, expected)
 /**
  * @brief Sets up a generic plain test. Only for internals
  * @param fixture The test fixture
@@ -299,6 +378,70 @@ struct test_name : unittest::testcase<>, fixture { \
 }; \
 UNITTEST_REGISTER(test_name) \
 void test_name::test()
+/**
+ * @brief Sets up a generic plain test with a memory budget. Only for internals
+ * @param fixture The test fixture
+ * @param test_name The name of the test
+ * @param memory_budget The maximum allowed peak of heap bytes (ignored if <= 0)
+ */
+#define __UNITTEST_TEST_PLAIN_MEM(fixture, test_name, memory_budget) \
+struct test_name : unittest::testcase<>, fixture { \
+    static void run() \
+    { \
+        UNITTEST_CLASS(test_name) \
+        UNITTEST_RUN_MEM(test, memory_budget) \
+    } \
+    void test(); \
+}; \
+UNITTEST_REGISTER(test_name) \
+void test_name::test()
+/**
+ * @brief Sets up a generic benchmark. Only for internals
+ * @param fixture The test fixture
+ * @param bench_name The name of the benchmark
+ */
+#define __UNITTEST_BENCH_PLAIN(fixture, bench_name) \
+struct bench_name : unittest::testcase<>, fixture { \
+    static void run() \
+    { \
+        UNITTEST_CLASS(bench_name) \
+        UNITTEST_RUN(bench) \
+    } \
+    void bench() \
+    { \
+        unittest::core::run_benchmark([this](unittest::benchstate& state) { this->body(state); }); \
+    } \
+    void body(unittest::benchstate& state); \
+}; \
+UNITTEST_REGISTER(bench_name) \
+void bench_name::body(unittest::benchstate& state)
+/**
+ * @brief Sets up a generic parameter sweep. Only for internals
+ * @param fixture The test fixture
+ * @param bench_name The name of the benchmark
+ * @param first The first input size
+ * @param last The last input size
+ * @param is_checked Whether to assert the complexity class
+ * @param expected The expected complexity class
+ */
+#define __UNITTEST_BENCH_SWEEP_PLAIN(fixture, bench_name, first, last, is_checked, expected) \
+struct bench_name : unittest::testcase<>, fixture { \
+    static void run() \
+    { \
+        UNITTEST_CLASS(bench_name) \
+        UNITTEST_RUN(bench) \
+    } \
+    void bench() \
+    { \
+        const auto sweep = unittest::core::run_sweep([this](unittest::benchstate& state) { this->body(state); }, \
+                                                     unittest::core::make_range(first, last, 2)); \
+        if (is_checked) \
+            unittest::assertions::assert_complexity(expected, sweep, UNITTEST_SPOT); \
+    } \
+    void body(unittest::benchstate& state); \
+}; \
+UNITTEST_REGISTER(bench_name) \
+void bench_name::body(unittest::benchstate& state)
 /**
  * @brief Sets up a templated test
  * @param test_name The name of the test
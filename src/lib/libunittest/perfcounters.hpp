@@ -0,0 +1,87 @@
+/**
+ * @brief Hardware performance counters per test
+ * @file perfcounters.hpp
+ */
+#pragma once
+#include <string>
+/**
+ * @brief Unit testing in C++
+ */
+namespace unittest {
+/**
+ * @brief Internal functionality, not relevant for most users
+ */
+namespace core {
+/**
+ * @brief Stores the values of the hardware performance counters. A counter
+ *  not supported by the hardware is negative
+ */
+struct perfcounts {
+    /**
+     * @brief Constructor
+     */
+    perfcounts();
+    /**
+     * @brief Whether the counters were read
+     */
+    bool measured;
+    /**
+     * @brief The number of instructions retired
+     */
+    long long instructions;
+    /**
+     * @brief The number of CPU cycles
+     */
+    long long cycles;
+    /**
+     * @brief The number of last level cache misses
+     */
+    long long cache_misses;
+    /**
+     * @brief The number of mispredicted branches
+     */
+    long long branch_misses;
+    /**
+     * @brief The number of data TLB read misses
+     */
+    long long tlb_misses;
+    /**
+     * @brief The time in nanoseconds the counters were enabled
+     */
+    long long time_enabled;
+    /**
+     * @brief The time in nanoseconds the counters were actually counting,
+     *  less than the time enabled if the hardware was shared
+     */
+    long long time_running;
+};
+/**
+ * @brief Reads the hardware performance counters of the calling thread.
+ *  They are opened by perf_event_open() on the first call per thread and
+ *  count user space only. If they cannot be opened, e.g. since
+ *  perf_event_paranoid forbids it, nothing is measured
+ * @returns The current values of the counters
+ */
+unittest::core::perfcounts
+read_perf_counters();
+/**
+ * @brief Computes the counts between two readings, scaled up to the time
+ *  enabled if the counters were not running all the time
+ * @param start The earlier reading
+ * @param end The later reading
+ * @returns The counts in between. Not measured if any of the readings is
+ *  not or if the counters were not running at all
+ */
+unittest::core::perfcounts
+perf_difference(const unittest::core::perfcounts& start,
+                const unittest::core::perfcounts& end);
+/**
+ * @brief Checks whether hardware performance counters can be opened
+ * @param reason Set to the reason if they cannot, can be a nullptr
+ * @returns Whether the counters are available
+ */
+bool
+probe_perf_counters(std::string* reason=nullptr);
+
+} // core
+} // unittest
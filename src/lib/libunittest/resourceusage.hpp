@@ -0,0 +1,91 @@
+/**
+ * @brief The resources used by a test
+ * @file resourceusage.hpp
+ */
+#pragma once
+/**
+ * @brief Unit testing in C++
+ */
+namespace unittest {
+/**
+ * @brief Internal functionality, not relevant for most users
+ */
+namespace core {
+/**
+ * @brief Stores the resources used by a test as reported by getrusage()
+ *  and by /proc/thread-self/io
+ */
+struct resourceusage {
+    /**
+     * @brief Constructor
+     */
+    resourceusage();
+    /**
+     * @brief Whether the resources were measured
+     */
+    bool measured;
+    /**
+     * @brief The CPU time spent in user mode in seconds
+     */
+    double user_time;
+    /**
+     * @brief The CPU time spent in kernel mode in seconds
+     */
+    double system_time;
+    /**
+     * @brief The maximum resident set size of the process in bytes. The
+     *  increase of it if the usage is a difference
+     */
+    long long max_rss;
+    /**
+     * @brief The number of page faults serviced without I/O
+     */
+    long long minor_faults;
+    /**
+     * @brief The number of page faults serviced with I/O
+     */
+    long long major_faults;
+    /**
+     * @brief The number of context switches due to waiting for a resource
+     */
+    long long voluntary_switches;
+    /**
+     * @brief The number of context switches due to preemption
+     */
+    long long involuntary_switches;
+    /**
+     * @brief The number of bytes read by system calls, including the ones
+     *  served from the page cache
+     */
+    long long read_bytes;
+    /**
+     * @brief The number of bytes written by system calls
+     */
+    long long write_bytes;
+    /**
+     * @brief The number of bytes read to measure the I/O counters, which
+     *  are left out of a difference
+     */
+    long long counter_bytes;
+};
+/**
+ * @brief Measures the resources used so far by the calling thread. Falls
+ *  back to the whole process if the platform does not account threads.
+ *  Resources that cannot be read are zero
+ * @returns The resources used so far
+ */
+unittest::core::resourceusage
+measure_resources();
+/**
+ * @brief Computes the resources used between two measurements
+ * @param start The earlier measurement
+ * @param end The later measurement
+ * @returns The resources used in between. Not measured if any of the
+ *  measurements is not
+ */
+unittest::core::resourceusage
+resource_difference(const unittest::core::resourceusage& start,
+                    const unittest::core::resourceusage& end);
+
+} // core
+} // unittest
@@ -0,0 +1,229 @@
+/**
+ * @brief Merging the result files of sharded and multi-process runs
+ * @file resultmerge.hpp
+ */
+#pragma once
+#include "testlog.hpp"
+#include "testresults.hpp"
+#include <string>
+#include <vector>
+#include <chrono>
+#include <memory>
+#include <utility>
+/**
+ * @brief Unit testing in C++
+ */
+namespace unittest {
+/**
+ * @brief Internal functionality, not relevant for most users
+ */
+namespace core {
+/**
+ * @brief Describes a single result file taking part in a merge
+ */
+struct shardinfo {
+    /**
+     * @brief Constructor
+     */
+    shardinfo();
+    /**
+     * @brief The file name
+     */
+    std::string filename;
+    /**
+     * @brief The name of the test suite
+     */
+    std::string suite_name;
+    /**
+     * @brief The shuffle seed, negative if not shuffled
+     */
+    long long shuffle_seed;
+    /**
+     * @brief The index of the shard
+     */
+    int shard_index;
+    /**
+     * @brief The number of shards
+     */
+    int shard_count;
+    /**
+     * @brief The time point of the suite start
+     */
+    std::chrono::system_clock::time_point time_point;
+    /**
+     * @brief The totals as stored in the file, without test logs
+     */
+    unittest::core::testresults totals;
+};
+class binwriter;
+/**
+ * @brief A result file delivering its test logs ordered by class name and
+ *  test name. A test appearing more than once in the file is delivered once
+ *  by its last run
+ */
+class resultsource {
+public:
+    /**
+     * @brief Destructor
+     */
+    virtual
+    ~resultsource()
+    {}
+    /**
+     * @brief Returns the description of the result file
+     * @returns The description of the result file
+     */
+    virtual const unittest::core::shardinfo&
+    info() const = 0;
+    /**
+     * @brief Moves to the next test log
+     * @returns Whether there is a next test log
+     */
+    virtual bool
+    advance() = 0;
+    /**
+     * @brief Returns the current test log. Only the class name, the test
+     *  name, and the outcome need to be filled in as long as it is not read
+     * @returns The current test log
+     */
+    virtual const unittest::core::testlog&
+    head() const = 0;
+    /**
+     * @brief Reads the current test log, at most once per test log
+     * @param log The test log to be filled
+     */
+    virtual void
+    read(unittest::core::testlog& log) = 0;
+    /**
+     * @brief Copies the current test log to a binary writer without reading
+     *  it, if the source supports it
+     * @param writer The binary writer
+     * @returns Whether the test log was copied
+     */
+    virtual bool
+    copy(unittest::core::binwriter& writer);
+    /**
+     * @brief Returns the number of earlier runs of tests skipped so far
+     * @returns The number of test logs skipped
+     */
+    virtual long
+    n_dropped() const = 0;
+};
+/**
+ * @brief Opens a result file in the XML or in the binary format. Only the
+ *  names and positions of the tests are held in memory, test logs are read
+ *  one at a time. Throws std::runtime_error if the file cannot be read
+ * @param filename The file name
+ * @returns The result source
+ */
+std::unique_ptr<unittest::core::resultsource>
+open_resultsource(const std::string& filename);
+/**
+ * @brief Merges result sources by a k-way merge over the test names such
+ *  that only one test log per source is held in memory. A test appearing
+ *  more than once, e.g. since it was retried, is reported once by its last
+ *  run, i.e. the one of the latest source
+ */
+class resultmerger {
+public:
+    /**
+     * @brief Constructor
+     * @param sources The result sources, ordered from first to last run
+     */
+    explicit
+    resultmerger(std::vector<std::unique_ptr<unittest::core::resultsource>> sources);
+    /**
+     * @brief Destructor
+     */
+    virtual
+    ~resultmerger();
+    /**
+     * @brief Copy constructor. Deleted
+     * @param other An instance of resultmerger
+     */
+    resultmerger(const resultmerger& other) = delete;
+    /**
+     * @brief Copy assignment operator. Deleted
+     * @param other An instance of resultmerger
+     * @returns A resultmerger instance
+     */
+    resultmerger&
+    operator=(const resultmerger& other) = delete;
+    /**
+     * @brief Move constructor. Deleted
+     * @param other An instance of resultmerger
+     */
+    resultmerger(resultmerger&& other) = delete;
+    /**
+     * @brief Move assignment operator. Deleted
+     * @param other An instance of resultmerger
+     * @returns A resultmerger instance
+     */
+    resultmerger&
+    operator=(resultmerger&& other) = delete;
+    /**
+     * @brief Reads the next merged test log
+     * @param log The test log to be filled
+     * @returns Whether a test log was read
+     */
+    bool
+    next(unittest::core::testlog& log);
+    /**
+     * @brief Writes the next merged test log to a binary writer. Logs of
+     *  binary sources are copied without reading them
+     * @param writer The binary writer
+     * @returns Whether a test log was written
+     */
+    bool
+    next(unittest::core::binwriter& writer);
+    /**
+     * @brief Moves past the next merged test log, counting it in the totals
+     *  without reading it
+     * @returns Whether there was a next test log
+     */
+    bool
+    skip();
+    /**
+     * @brief Returns the descriptions of the merged sources
+     * @returns The descriptions of the merged sources
+     */
+    const std::vector<unittest::core::shardinfo>&
+    shards() const;
+    /**
+     * @brief Returns the number of test logs dropped as duplicates so far
+     * @returns The number of test logs dropped as duplicates
+     */
+    long
+    n_retried() const;
+    /**
+     * @brief Returns the totals recomputed from the test logs read so far.
+     *  The duration is the longest duration of all sources
+     * @returns The test results without test logs
+     */
+    unittest::core::testresults
+    totals() const;
+
+private:
+    struct impl;
+    std::unique_ptr<impl> impl_;
+};
+/**
+ * @brief Merges result files into a single test results in memory
+ * @param filenames The file names, ordered from first to last run
+ * @param shards If not null, filled with the descriptions of the files
+ * @returns The merged test results
+ */
+unittest::core::testresults
+merge_results(const std::vector<std::string>& filenames,
+              std::vector<unittest::core::shardinfo>* shards=nullptr);
+/**
+ * @brief Makes the XML properties keeping the suite info of every shard,
+ *  e.g. its shuffle seed
+ * @param shards The descriptions of the merged files
+ * @returns The properties as pairs of name and value
+ */
+std::vector<std::pair<std::string, std::string>>
+make_shard_properties(const std::vector<unittest::core::shardinfo>& shards);
+
+} // core
+} // unittest
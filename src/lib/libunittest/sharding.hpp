@@ -0,0 +1,67 @@
+/**
+ * @brief Deterministic splitting of test classes across processes
+ * @file sharding.hpp
+ */
+#pragma once
+#include "testhistory.hpp"
+#include <string>
+#include <vector>
+/**
+ * @brief Unit testing in C++
+ */
+namespace unittest {
+/**
+ * @brief Internal functionality, not relevant for most users
+ */
+namespace core {
+/**
+ * @brief Returns the shard of a test class by hashing its name. The hash
+ *  (FNV-1a) is stable across platforms, compilers, and builds
+ * @param class_name The name of the test class
+ * @param shard_count The number of shards
+ * @returns The shard index in [0, shard_count)
+ */
+int
+hash_shard(const std::string& class_name,
+           int shard_count);
+/**
+ * @brief Assigns test classes to shards such that the expected durations of
+ *  the shards are balanced. Classes are taken longest first and go to the
+ *  shard with the lowest total (longest processing time first). The result
+ *  only depends on the class names and the history, so every shard
+ *  computes the same assignment when reading the same history. Hence, the
+ *  history file must not be written while the shards are running
+ * @param class_names The names of all test classes
+ * @param history The test history
+ * @param shard_count The number of shards
+ * @param default_estimate The duration in seconds assumed for unknown classes
+ * @returns The shard index of every class
+ */
+std::vector<int>
+balance_shards(const std::vector<std::string>& class_names,
+               const unittest::core::testhistory& history,
+               int shard_count,
+               double default_estimate);
+/**
+ * @brief Removes all test classes from the schedule which do not belong
+ *  to the given shard
+ * @param schedule The indices of the test classes to be filtered in place
+ * @param class_names The names of all test classes
+ * @param history The test history
+ * @param shard_index The index of the shard to keep
+ * @param shard_count The number of shards
+ * @param balanced Whether to balance the shards by expected duration
+ *  instead of hashing the class names
+ * @param default_estimate The duration in seconds assumed for unknown classes
+ */
+void
+select_shard(std::vector<size_t>& schedule,
+             const std::vector<std::string>& class_names,
+             const unittest::core::testhistory& history,
+             int shard_index,
+             int shard_count,
+             bool balanced,
+             double default_estimate);
+
+} // core
+} // unittest
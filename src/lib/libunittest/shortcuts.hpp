@@ -4,13 +4,13 @@
  */
 #pragma once
 /**
- * @brief Defines a string with info about the current file name
- *  and the current line number
+ * @brief Defines a record of the current file name and the current
+ *  line number
  */
 #define SPOT \
 UNITTEST_SPOT
 /**
- * @brief Defines a string indicating the use of non-deadly assertions
+ * @brief Defines a tag indicating the use of non-deadly assertions
  */
 #define NDAS \
 UNITTEST_NDAS
@@ -24,6 +24,11 @@ UNITTEST_TESTINFO(__VA_ARGS__)
  */
 #define REGISTER(...) \
 UNITTEST_REGISTER(__VA_ARGS__)
+/**
+ * @brief Marks a test class as not thread-safe
+ */
+#define NOT_THREADSAFE \
+UNITTEST_NOT_THREADSAFE
 /**
  * @brief A test collection
  * @param name The name of the test collection
@@ -75,6 +80,13 @@ UNITTEST_TEST_TIME_SKIP(test_name, timeout, skip_message)
  */
 #define TEST_TIME_MAYBE(test_name, timeout, is_run, skip_message) \
 UNITTEST_TEST_TIME_MAYBE(test_name, timeout, is_run, skip_message)
+/**
+ * @brief Sets up a plain test with a memory budget
+ * @param test_name The name of the test
+ * @param memory_budget The maximum allowed peak of heap bytes (ignored if <= 0)
+ */
+#define TEST_MEM(test_name, memory_budget) \
+UNITTEST_TEST_MEM(test_name, memory_budget)
 /**
  * @brief Sets up a plain test with a test fixture
  * @param fixture The test fixture
@@ -135,6 +147,44 @@ UNITTEST_TEST_FIXTURE_TIME_SKIP(fixture, test_name, timeout, skip_message)
  */
 #define TEST_FIXTURE_TIME_MAYBE(fixture, test_name, timeout, is_run, skip_message) \
 UNITTEST_TEST_FIXTURE_TIME_MAYBE(fixture, test_name, timeout, is_run, skip_message)
+/**
+ * @brief Sets up a plain test with a test fixture and a memory budget
+ * @param fixture The test fixture
+ * @param test_name The name of the test
+ * @param memory_budget The maximum allowed peak of heap bytes (ignored if <= 0)
+ */
+#define TEST_FIXTURE_MEM(fixture, test_name, memory_budget) \
+UNITTEST_TEST_FIXTURE_MEM(fixture, test_name, memory_budget)
+/**
+ * @brief Sets up a benchmark
+ * @param bench_name The name of the benchmark
+ */
+#define BENCH(bench_name) \
+UNITTEST_BENCH(bench_name)
+/**
+ * @brief Sets up a benchmark with a test fixture
+ * @param fixture The test fixture
+ * @param bench_name The name of the benchmark
+ */
+#define BENCH_FIXTURE(fixture, bench_name) \
+UNITTEST_BENCH_FIXTURE(fixture, bench_name)
+/**
+ * @brief Sets up a parameter sweep over powers of two of the input size
+ * @param bench_name The name of the benchmark
+ * @param first The first input size
+ * @param last The last input size
+ */
+#define BENCH_SWEEP(bench_name, first, last) \
+UNITTEST_BENCH_SWEEP(bench_name, first, last)
+/**
+ * @brief Sets up a parameter sweep asserting the expected complexity class
+ * @param bench_name The name of the benchmark
+ * @param first The first input size
+ * @param last The last input size
+ * @param expected The expected complexity class
+ */
+#define BENCH_SWEEP_COMPLEXITY(bench_name, first, last, expected) \
+UNITTEST_BENCH_SWEEP_COMPLEXITY(bench_name, first, last, expected)
 /**
  * @brief Sets up a templated test
  * @param test_name The name of the test
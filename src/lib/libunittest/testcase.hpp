@@ -5,6 +5,7 @@
 #pragma once
 #include "assertions.hpp"
 #include "noexcept.hpp"
+#include "failuresink.hpp"
 #include <string>
 #include <memory>
 /**
@@ -39,7 +40,7 @@ public:
      * @brief Constructor. Called before each test run.
      */
     testcase()
-        : context_(nullptr), test_id_("")
+        : context_(nullptr), test_id_(""), failure_sink_(nullptr)
     {}
     /**
      * @brief Destructor. Called after each test run.
@@ -96,11 +97,24 @@ public:
      * @brief Returns the current test ID
      * @returns The current test ID
      */
-    std::string
+    const std::string&
     get_test_id() const
     {
         return test_id_;
     }
+    /**
+     * @brief Returns the failure sink used by non-deadly assertions within
+     *  the methods of this class. This is the sink installed for the calling
+     *  thread if any, otherwise the sink of the current test such that
+     *  helper threads of a test report to it without installing a scope
+     * @returns The failure sink, nullptr if none is available
+     */
+    std::shared_ptr<unittest::core::failuresink>
+    unittest_ndas_sink() const
+    {
+        auto sink = unittest::core::failuresink::acquire();
+        return sink ? sink : failure_sink_;
+    }
 
 private:
 
@@ -119,8 +133,15 @@ private:
         test_id_ = test_id;
     }
 
+    void
+    set_failure_sink(std::shared_ptr<unittest::core::failuresink> sink)
+    {
+        failure_sink_ = sink;
+    }
+
     std::shared_ptr<context_type> context_;
     std::string test_id_;
+    std::shared_ptr<unittest::core::failuresink> failure_sink_;
 };
 
 } // unittest
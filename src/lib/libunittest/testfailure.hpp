@@ -7,6 +7,7 @@
 #include "noexcept.hpp"
 #include "testsuite.hpp"
 #include <string>
+#include <sstream>
 #include <stdexcept>
 /**
  * @brief Unit testing in C++
@@ -33,6 +34,19 @@ public:
     testfailure(const std::string& assertion,
                 const std::string& message,
                 const std::string& user_msg);
+    /**
+     * @brief Constructor
+     * @param assertion The name of the assertion
+     * @param message The complete message of the test failure
+     * @param filename The name of the file in which the test failure occurred
+     * @param linenumber The line number at which the test failure occurred
+     * @param callsite The call site of the assertion
+     */
+    testfailure(const std::string& assertion,
+                const std::string& message,
+                const std::string& filename,
+                int linenumber,
+                const std::string& callsite);
     /**
      * @brief Copy constructor
      * @param other An instance of testfailure
@@ -87,18 +101,112 @@ private:
 
 namespace core {
 
+/**
+ * @brief Collects the arguments passed to an assertion once it has failed.
+ *  Source spots, call sites and non-deadly assertion tags are kept as
+ *  fields, all other arguments are concatenated to the user message
+ */
+struct failureinfo {
+    /**
+     * @brief Constructor
+     */
+    failureinfo();
+    /**
+     * @brief The name of the file, nullptr if not given
+     */
+    const char* filename;
+    /**
+     * @brief The line number within the file
+     */
+    int linenumber;
+    /**
+     * @brief The call site, nullptr if not given
+     */
+    const char* callsite;
+    /**
+     * @brief Whether the assertion is non-deadly
+     */
+    bool is_non_deadly;
+    /**
+     * @brief The failure sink given by the non-deadly assertion tag
+     */
+    unittest::core::failuresink* sink;
+    /**
+     * @brief The user message
+     */
+    std::ostringstream usermsg;
+};
+/**
+ * @brief Stores a source spot in the failure info
+ * @param info The failure info
+ * @param spot The source spot
+ */
+void
+add_failure_arg(unittest::core::failureinfo& info,
+                const unittest::core::sourcespot& spot);
+/**
+ * @brief Stores a call site in the failure info
+ * @param info The failure info
+ * @param call The call site
+ */
+void
+add_failure_arg(unittest::core::failureinfo& info,
+                const unittest::core::sourcecall& call);
+/**
+ * @brief Stores a non-deadly assertion tag in the failure info
+ * @param info The failure info
+ * @param tag The non-deadly assertion tag
+ */
+void
+add_failure_arg(unittest::core::failureinfo& info,
+                const unittest::core::ndastag& tag);
+/**
+ * @brief Appends an argument to the user message of the failure info
+ * @param info The failure info
+ * @param arg The argument
+ */
+template<typename T>
+void
+add_failure_arg(unittest::core::failureinfo& info,
+                const T& arg)
+{
+    info.usermsg << arg;
+}
+/**
+ * @brief Collects the given arguments into the failure info. Recursion end
+ * @param info The failure info
+ */
+inline void
+add_failure_args(unittest::core::failureinfo&)
+{}
+/**
+ * @brief Collects the given arguments into the failure info
+ * @param info The failure info
+ * @param arg An argument
+ * @param args Further arguments
+ */
+template<typename T,
+         typename... Args>
+void
+add_failure_args(unittest::core::failureinfo& info,
+                 const T& arg,
+                 const Args&... args)
+{
+    unittest::core::add_failure_arg(info, arg);
+    unittest::core::add_failure_args(info, args...);
+}
 /**
  * @brief Builds a fail message from the parameters passed and throws
  *  exception testfailure if assertion is deadly (the default)
  * @param assertion The name of the assertion
  * @param message The assertion message
- * @param usermsg The user message
+ * @param info The failure info
  * @throws testfailure
  */
 void
 fail_impl(const std::string& assertion,
           const std::string& message,
-          std::string usermsg);
+          const unittest::core::failureinfo& info);
 
 } // core
 
@@ -107,8 +215,10 @@ fail_impl(const std::string& assertion,
  *  exception testfailure if assertion is deadly (the default)
  * @param assertion The name of the assertion
  * @param message The assertion message
- * @param args An arbitrary number of arguments that are concatenated
- *  to a single string and are appended to the assertion message
+ * @param args An arbitrary number of arguments. Source spots, call sites
+ *  and non-deadly assertion tags are taken as they are, all other
+ *  arguments are concatenated to a single string and are appended to
+ *  the assertion message
  * @throws testfailure
  */
 template<typename... Args>
@@ -117,7 +227,9 @@ fail(const std::string& assertion,
      const std::string& message,
      const Args&... args)
 {
-    unittest::core::fail_impl(assertion, message, unittest::join("", args...));
+    unittest::core::failureinfo info;
+    unittest::core::add_failure_args(info, args...);
+    unittest::core::fail_impl(assertion, message, info);
 }
 
 } // unittest
@@ -0,0 +1,194 @@
+/**
+ * @brief The test history storing timing information across test runs
+ * @file testhistory.hpp
+ */
+#pragma once
+#include "testlog.hpp"
+#include "teststatus.hpp"
+#include <string>
+#include <array>
+#include <vector>
+#include <memory>
+/**
+ * @brief Unit testing in C++
+ */
+namespace unittest {
+/**
+ * @brief Internal functionality, not relevant for most users
+ */
+namespace core {
+/**
+ * @brief Stores the timing history of a single test
+ */
+struct testrecord {
+    /**
+     * @brief Constructor
+     */
+    testrecord();
+    /**
+     * @brief The number of buckets of the duration sketch
+     */
+    static const int n_buckets = 64;
+    /**
+     * @brief The name of the test class. Stored along with the full test
+     *  name as class names and test names may both contain '::'
+     */
+    std::string class_name;
+    /**
+     * @brief The number of recorded runs
+     */
+    long n_runs;
+    /**
+     * @brief The number of recorded successes
+     */
+    long n_successes;
+    /**
+     * @brief The number of recorded failures
+     */
+    long n_failures;
+    /**
+     * @brief The number of recorded errors
+     */
+    long n_errors;
+    /**
+     * @brief The number of recorded timeouts
+     */
+    long n_timeouts;
+    /**
+     * @brief The exponential moving average of the duration in seconds
+     */
+    double average;
+    /**
+     * @brief The most recent duration in seconds
+     */
+    double last;
+    /**
+     * @brief A duration histogram with logarithmic buckets. Bucket i counts
+     *  durations up to 2^(i/2) microseconds
+     */
+    std::array<unsigned int, n_buckets> sketch;
+    /**
+     * @brief Adds a single test run to the record
+     * @param duration The duration in seconds
+     * @param status The test status
+     * @param has_timed_out Whether the test has timed out
+     */
+    void
+    add(double duration,
+        unittest::core::teststatus status,
+        bool has_timed_out);
+    /**
+     * @brief Estimates a percentile of the recorded durations
+     * @param fraction The percentile as a fraction in [0, 1]
+     * @returns The estimated duration in seconds, zero if nothing was recorded
+     */
+    double
+    percentile(double fraction) const;
+};
+/**
+ * @brief The test history mapping full test names to test records. It is
+ *  loaded from and appended to a history file. Every process appends its
+ *  runs using a single write to the end of the file such that parallel
+ *  shards may share the same history file. Appending and compacting hold
+ *  an advisory lock on the file where available
+ */
+class testhistory {
+public:
+    /**
+     * @brief Constructor
+     */
+    testhistory();
+    /**
+     * @brief Destructor
+     */
+    virtual
+    ~testhistory();
+    /**
+     * @brief Copy constructor. Deleted
+     * @param other An instance of testhistory
+     */
+    testhistory(const testhistory& other) = delete;
+    /**
+     * @brief Copy assignment operator. Deleted
+     * @param other An instance of testhistory
+     * @returns An testhistory instance
+     */
+    testhistory&
+    operator=(const testhistory& other) = delete;
+    /**
+     * @brief Move constructor. Deleted
+     * @param other An instance of testhistory
+     */
+    testhistory(testhistory&& other) = delete;
+    /**
+     * @brief Move assignment operator. Deleted
+     * @param other An instance of testhistory
+     * @returns An testhistory instance
+     */
+    testhistory&
+    operator=(testhistory&& other) = delete;
+    /**
+     * @brief Loads the history from a file. A missing file is not an error
+     * @param filename The name of the history file
+     */
+    void
+    load(const std::string& filename);
+    /**
+     * @brief Records the outcome of a test. Tests that were skipped are ignored
+     * @param log The test log
+     */
+    void
+    record(const unittest::core::testlog& log);
+    /**
+     * @brief Appends the tests recorded since loading to the history file.
+     *  Compacts the file if it mostly consists of single runs, which
+     *  includes the runs other shards appended since loading. The file is
+     *  only compacted if it can be locked
+     * @param filename The name of the history file
+     */
+    void
+    save(const std::string& filename);
+    /**
+     * @brief Returns the record of a given test
+     * @param full_test_name The full test name
+     * @returns A pointer to the record, nullptr if the test is unknown
+     */
+    const unittest::core::testrecord*
+    find(const std::string& full_test_name) const;
+    /**
+     * @brief Returns the expected duration of all known tests of a test class
+     * @param class_name The name of the test class
+     * @returns The expected duration in seconds, a negative value if none
+     *  of the class' tests is known
+     */
+    double
+    expected_class_duration(const std::string& class_name) const;
+    /**
+     * @brief Returns the number of known tests
+     * @returns The number of known tests
+     */
+    size_t
+    size() const;
+
+private:
+    struct impl;
+    std::unique_ptr<impl> impl_;
+};
+
+/**
+ * @brief Orders test classes by their expected duration, longest first.
+ *  Classes with equal expected durations keep their relative order
+ * @param schedule The indices of the test classes to be ordered in place
+ * @param class_names The names of all test classes
+ * @param history The test history
+ * @param default_estimate The duration in seconds assumed for unknown classes
+ * @returns The expected durations in seconds in the order of the schedule
+ */
+std::vector<double>
+order_longest_first(std::vector<size_t>& schedule,
+                    const std::vector<std::string>& class_names,
+                    const unittest::core::testhistory& history,
+                    double default_estimate);
+
+} // core
+} // unittest
@@ -4,6 +4,11 @@
  */
 #pragma once
 #include "teststatus.hpp"
+#include "resourceusage.hpp"
+#include "perfcounters.hpp"
+#include "allocations.hpp"
+#include "benchmark.hpp"
+#include "baseline.hpp"
 #include <string>
 #include <ostream>
 #include <vector>
@@ -87,6 +92,37 @@ struct testlog {
      * @brief A string of the call site
      */
     std::string callsite;
+    /**
+     * @brief The order in which the test was registered to run, negative
+     *  if unknown. Only comparable between tests of the same class
+     */
+    long sequence;
+    /**
+     * @brief The resources used while executing the test method
+     */
+    unittest::core::resourceusage resources;
+    /**
+     * @brief The hardware events counted while executing the test method
+     */
+    unittest::core::perfcounts counters;
+    /**
+     * @brief The heap allocations done while constructing, setting up,
+     *  executing, tearing down, and destructing the test
+     */
+    unittest::core::allocationcounts allocations;
+    /**
+     * @brief The statistics of the benchmark run by the test, if any
+     */
+    unittest::core::benchresult benchmark;
+    /**
+     * @brief The comparison of the benchmark against its baseline, if any
+     */
+    unittest::core::benchcomparison baseline;
+    /**
+     * @brief The times and the complexity fit of the parameter sweep run by
+     *  the test, if any
+     */
+    unittest::core::sweepresult sweep;
     /**
      * @brief The non-deadly failures
      */
@@ -120,6 +156,22 @@ write_test_end_message(std::ostream& stream,
 void
 write_test_timeout_message(std::ostream& stream,
                            bool verbose);
+/**
+ * @brief Serializes a test log into a string which can be passed between processes
+ * @param log The test log
+ * @returns The serialized test log
+ */
+std::string
+serialize_testlog(const unittest::core::testlog& log);
+/**
+ * @brief Restores a test log serialized by serialize_testlog()
+ * @param data The serialized test log
+ * @param log The restored test log
+ * @returns Whether the data could be parsed
+ */
+bool
+deserialize_testlog(const std::string& data,
+                    unittest::core::testlog& log);
 /**
  * @brief Generates the full test name
  * @param class_name The name of the test class
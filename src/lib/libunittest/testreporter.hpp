@@ -0,0 +1,55 @@
+/**
+ * @brief The interface of reporters receiving test logs as tests finish
+ * @file testreporter.hpp
+ */
+#pragma once
+#include "testlog.hpp"
+#include "testresults.hpp"
+/**
+ * @brief Unit testing in C++
+ */
+namespace unittest {
+/**
+ * @brief Internal functionality, not relevant for most users
+ */
+namespace core {
+/**
+ * @brief A reporter receiving the log of every test as it starts and as
+ *  soon as it is collected by the test suite, and the totals once all
+ *  tests are done
+ */
+class testreporter {
+public:
+    /**
+     * @brief Destructor
+     */
+    virtual
+    ~testreporter()
+    {}
+    /**
+     * @brief Reports the start of a single test. Called concurrently when
+     *  tests run in parallel. Does nothing by default
+     * @param log The test log holding the names and the timeout
+     */
+    virtual void
+    start(const unittest::core::testlog& log)
+    {
+        (void)log;
+    }
+    /**
+     * @brief Reports a single test. Called concurrently when tests run in
+     *  parallel
+     * @param log The test log
+     */
+    virtual void
+    report(const unittest::core::testlog& log) = 0;
+    /**
+     * @brief Finishes the report once all tests are done
+     * @param results The test results providing the totals
+     */
+    virtual void
+    finish(const unittest::core::testresults& results) = 0;
+};
+
+} // core
+} // unittest
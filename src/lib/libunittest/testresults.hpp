@@ -60,6 +60,157 @@ struct testresults {
      */
     std::vector<unittest::core::testlog> testlogs;
 };
+/**
+ * @brief A read-only view of a range of test logs. It refers to the logs
+ *  without copying them and is only valid as long as the logs are unchanged
+ */
+class testlogview {
+public:
+    /**
+     * @brief The iterator type
+     */
+    typedef std::vector<unittest::core::testlog>::const_iterator const_iterator;
+    /**
+     * @brief Constructor
+     * @param first The iterator to the first log
+     * @param last The iterator past the last log
+     */
+    testlogview(const_iterator first,
+                const_iterator last);
+    /**
+     * @brief Returns the iterator to the first log
+     * @returns The iterator to the first log
+     */
+    const_iterator
+    begin() const;
+    /**
+     * @brief Returns the iterator past the last log
+     * @returns The iterator past the last log
+     */
+    const_iterator
+    end() const;
+    /**
+     * @brief Returns the number of logs
+     * @returns The number of logs
+     */
+    size_t
+    size() const;
+    /**
+     * @brief Returns whether all logs of the view are successful
+     * @returns Whether all logs of the view are successful
+     */
+    bool
+    successful() const;
+
+private:
+    const_iterator first_;
+    const_iterator last_;
+};
+/**
+ * @brief Creates a view of the test logs collected since a given index
+ * @param results The test results
+ * @param index The index of the first log of the view
+ * @returns The view, empty if the index is beyond the last log
+ */
+unittest::core::testlogview
+make_testlogview(const unittest::core::testresults& results,
+                 size_t index=0);
+/**
+ * @brief Writes the opening testsuite tag of the XML output without the
+ *  closing bracket such that further attributes or padding may follow
+ * @param stream The output stream
+ * @param results The test results providing the totals
+ * @param suite_name the name of the test suite
+ * @param shuffle_seed The shuffle seed
+ * @param shard_index The index of the shard
+ * @param shard_count The number of shards (no shard is written if less than two)
+ * @param time_point The time point used in the tag
+ * @param local_time Whether timestamps are displayed in local time
+ */
+void
+write_xml_testsuite_tag(std::ostream& stream,
+                        const unittest::core::testresults& results,
+                        const std::string& suite_name,
+                        long long shuffle_seed,
+                        int shard_index,
+                        int shard_count,
+                        const std::chrono::system_clock::time_point& time_point,
+                        bool local_time);
+/**
+ * @brief Writes the properties element of the XML output. Writes nothing
+ *  if there are no properties
+ * @param stream The output stream
+ * @param properties The properties as pairs of name and value
+ */
+void
+write_xml_properties(std::ostream& stream,
+                     const std::vector<std::pair<std::string, std::string>>& properties);
+/**
+ * @brief Writes the resources used by a test as attributes of its testcase
+ *  element, named after the fields of getrusage() and /proc/thread-self/io.
+ *  Each attribute is preceded by a space
+ * @param stream The output stream
+ * @param usage The resources used
+ */
+void
+write_xml_resources(std::ostream& stream,
+                    const unittest::core::resourceusage& usage);
+/**
+ * @brief Writes the hardware events counted for a test as attributes of its
+ *  testcase element, leaving out the counters not supported. Each attribute
+ *  is preceded by a space
+ * @param stream The output stream
+ * @param counts The hardware event counts
+ */
+void
+write_xml_counters(std::ostream& stream,
+                   const unittest::core::perfcounts& counts);
+/**
+ * @brief Writes the heap allocations of a test as attributes of its
+ *  testcase element. Each attribute is preceded by a space
+ * @param stream The output stream
+ * @param counts The allocation counts
+ */
+void
+write_xml_allocations(std::ostream& stream,
+                      const unittest::core::allocationcounts& counts);
+/**
+ * @brief Writes the statistics of a benchmark as attributes of its testcase
+ *  element, including the samples as a space separated list. Times are in
+ *  seconds per iteration. Each attribute is preceded by a space
+ * @param stream The output stream
+ * @param result The benchmark result
+ */
+void
+write_xml_benchmark(std::ostream& stream,
+                    const unittest::core::benchresult& result);
+/**
+ * @brief Writes the comparison of a benchmark against its baseline as
+ *  attributes of its testcase element. Each attribute is preceded by a space
+ * @param stream The output stream
+ * @param comparison The comparison
+ */
+void
+write_xml_baseline(std::ostream& stream,
+                   const unittest::core::benchcomparison& comparison);
+/**
+ * @brief Writes the times of a parameter sweep and their complexity fit as
+ *  attributes of its testcase element, including the input sizes and the
+ *  times as space separated lists. Each attribute is preceded by a space
+ * @param stream The output stream
+ * @param result The sweep result
+ */
+void
+write_xml_sweep(std::ostream& stream,
+                const unittest::core::sweepresult& result);
+/**
+ * @brief Writes a single testcase element of the XML output
+ * @param stream The output stream
+ * @param log The test log
+ */
+void
+write_xml_testcase(std::ostream& stream,
+                   const unittest::core::testlog& log);
 /**
  * @brief Writes the test results as an XML to the given output stream
  * @param stream The output stream
@@ -68,6 +219,8 @@ struct testresults {
  * @param shuffle_seed The shuffle seed
  * @param time_point The time point used in the root tag (defaults to now)
  * @param local_time Whether timestamps are displayed in local time
+ * @param shard_index The index of the shard
+ * @param shard_count The number of shards (no shard is written if less than two)
  */
 void
 write_xml(std::ostream& stream,
@@ -75,7 +228,9 @@ write_xml(std::ostream& stream,
           const std::string& suite_name,
           long long shuffle_seed,
           const std::chrono::system_clock::time_point& time_point=std::chrono::system_clock::now(),
-          bool local_time=true);
+          bool local_time=true,
+          int shard_index=0,
+          int shard_count=1);
 /**
  * @brief Writes the test summary to the given output stream
  * @param stream The output stream
@@ -96,6 +251,42 @@ void
 write_error_info(std::ostream& stream,
                  const std::vector<unittest::core::testlog>& testlogs,
                  bool successful);
+/**
+ * @brief Writes the error info to the given output stream
+ * @param stream The output stream
+ * @param testlogs A view of the test logs
+ * @param successful Whether all tests passed
+ */
+void
+write_error_info(std::ostream& stream,
+                 const unittest::core::testlogview& testlogs,
+                 bool successful);
+/**
+ * @brief Checks whether a successful test ended with more bytes allocated
+ *  than before it was constructed
+ * @param log The test log
+ * @returns Whether the test has leaked
+ */
+bool
+has_leaked(const unittest::core::testlog& log);
+/**
+ * @brief Writes the tests that have leaked to the given output stream.
+ *  Writes nothing if there are none
+ * @param stream The output stream
+ * @param testlogs The test logs
+ */
+void
+write_leak_info(std::ostream& stream,
+                const std::vector<unittest::core::testlog>& testlogs);
+/**
+ * @brief Writes the statistics of the successful benchmarks to the given
+ *  output stream. Writes nothing if there are none
+ * @param stream The output stream
+ * @param testlogs The test logs
+ */
+void
+write_bench_info(std::ostream& stream,
+                 const std::vector<unittest::core::testlog>& testlogs);
 
 } // core
 } // unittest
@@ -7,10 +7,16 @@
 #include "testsuite.hpp"
 #include "utilities.hpp"
 #include "testcase.hpp"
+#include "threadpool.hpp"
+#include "isolation.hpp"
+#include "watchdog.hpp"
+#include "resourceusage.hpp"
+#include "perfcounters.hpp"
+#include "allocations.hpp"
 #include <string>
 #include <stdexcept>
-#include <thread>
 #include <functional>
+#include <type_traits>
 /**
  * @brief Unit testing in C++
  */
@@ -29,10 +35,14 @@ public:
      * @param class_name The name of the test class
      * @param test_name The name of the current test method
      * @param method_id The ID of the current test method
+     * @param timeout The timeout of the current test method
+     * @param sequence The order in which the test was registered to run
      */
     testmonitor(const std::string& class_name,
                 const std::string& test_name,
-                const std::string& method_id);
+                const std::string& method_id,
+                double timeout=-1,
+                long sequence=-1);
     /**
      * @brief Destructor
      */
@@ -62,12 +72,29 @@ public:
      */
     testmonitor&
     operator=(testmonitor&& other) = delete;
+    /**
+     * @brief Logs text into the log of the test monitored by the calling
+     *  thread given it has the method ID
+     * @param method_id The method ID
+     * @param text The text to be logged
+     * @returns Whether the text was logged
+     */
+    static bool
+    log_text(const std::string& method_id,
+             const std::string& text);
     /**
      * @brief Returns whether to execute the current test
      * @returns Whether to execute the current test
      */
     bool
     is_executed();
+    /**
+     * @brief Returns the sink collecting the non-deadly failures of the
+     *  current test
+     * @returns The failure sink
+     */
+    std::shared_ptr<unittest::core::failuresink>
+    failure_sink() const;
     /**
      * @brief Logs success for the current test
      */
@@ -101,6 +128,41 @@ public:
      */
     void
     has_timed_out(double timeout);
+    /**
+     * @brief Logs the resources used since a given measurement
+     * @param start The measurement taken when the test method was entered
+     */
+    void
+    log_resources(const unittest::core::resourceusage& start);
+    /**
+     * @brief Logs the hardware events counted since a given reading
+     * @param start The reading taken when the test method was entered
+     */
+    void
+    log_counters(const unittest::core::perfcounts& start);
+    /**
+     * @brief Logs the heap allocations of the test
+     * @param counts The allocations counted
+     */
+    void
+    log_allocations(const unittest::core::allocationcounts& counts);
+    /**
+     * @brief Logs a failure for the current test if it has succeeded so far
+     *  but its peak of heap bytes exceeds the memory budget. The counts
+     *  only cover the allocations of the thread running the test
+     * @param counts The allocations counted
+     * @param memory_budget The maximum allowed peak of heap bytes
+     */
+    void
+    check_memory_budget(const unittest::core::allocationcounts& counts,
+                        long long memory_budget);
+    /**
+     * @brief Compares the benchmark of the current test, if any, against
+     *  its baseline and logs a failure if it has succeeded so far but got
+     *  significantly slower than the baseline by more than the threshold
+     */
+    void
+    check_baseline();
 
 private:
     struct impl;
@@ -138,6 +200,22 @@ struct testinfo {
      * @brief Whether to handle unexpected exceptions
      */
     bool handle_exceptions;
+    /**
+     * @brief Whether to account the resources used
+     */
+    bool resource_usage;
+    /**
+     * @brief Whether to count hardware events
+     */
+    bool perf_counters;
+    /**
+     * @brief Whether to track heap allocations
+     */
+    bool track_allocations;
+    /**
+     * @brief The maximum allowed peak of heap bytes (ignored if <= 0)
+     */
+    long long memory_budget;
     /**
      * @brief Whether the test is done
      */
@@ -158,14 +236,35 @@ struct testinfo {
      * @brief A message explaining why the test is skipped
      */
     std::string skip_message;
+    /**
+     * @brief The order in which the test was registered to run
+     */
+    long sequence;
 };
 /**
- * @brief Creates the test info object
+ * @brief Draws the next test sequence number and assigns it to the calling
+ *  thread. Numbers increase in the order the tests are registered to run
+ * @returns The test sequence number
+ */
+long
+make_test_sequence();
+/**
+ * @brief Assigns a test sequence number to the calling thread, e.g. to a
+ *  thread of a pool running the test
+ * @param sequence The test sequence number
+ */
+void
+set_test_sequence(long sequence);
+/**
+ * @brief Creates the test info object. The test sequence number is the one
+ *  assigned to the calling thread
+ * @param class_id The id of the test class
  * @param class_id The id of the test class
  * @param test_name The name of the current test method
  * @param skipped Whether this test run is skipped
  * @param skip_message A message explaining why the test is skipped
  * @param timeout The maximum allowed run time in seconds (ignored if <= 0)
+ * @param memory_budget The maximum allowed peak of heap bytes (ignored if <= 0)
  * @returns The test info object
  */
 unittest::core::testinfo
@@ -173,20 +272,15 @@ make_testinfo(std::string class_id,
               std::string test_name,
               bool skipped,
               std::string skip_message,
-              double timeout);
+              double timeout,
+              long long memory_budget);
 /**
- * @brief Observes the progress of an asynchronous operation and waits until
- *  the operation has finished or timed out
- * @param thread The asynchronous operation
- * @param done Whether the operation is finished
- * @param has_timed_out Whether the test has timed out
- * @param timeout The maximum allowed run time in seconds (ignored if <= 0)
+ * @brief Creates a test log identifying the test given by the test info
+ * @param info The test info
+ * @returns The test log
  */
-void
-observe_and_wait(std::thread&& thread,
-                 std::shared_ptr<std::atomic_bool> done,
-                 std::shared_ptr<std::atomic_bool> has_timed_out,
-                 double timeout);
+unittest::core::testlog
+make_testlog(const unittest::core::testinfo& info);
 /**
  * @brief Stores the test to be run and an optional test context.
  *  By using the ()-operator the test is executed.
@@ -230,7 +324,7 @@ struct testfunctor {
     void
     operator()()
     {
-        unittest::core::testmonitor monitor(info_.class_name, info_.test_name, info_.method_id);
+        unittest::core::testmonitor monitor(info_.class_name, info_.test_name, info_.method_id, info_.timeout, info_.sequence);
         if (info_.skipped) {
             monitor.log_skipped(info_.skip_message);
         } else if (monitor.is_executed()) {
@@ -238,7 +332,16 @@ struct testfunctor {
                 monitor.log_success();
             } else {
                 unittest::testcase<TestContext>* test = nullptr;
-                this->run(test, monitor);
+                {
+                    unittest::core::allocationowner owner(this->is_tracking_allocations() ? &allocations_ : nullptr);
+                    unittest::core::addressspacelimit limit(info_.memory_budget);
+                    this->run(test, monitor);
+                }
+                if (this->is_tracking_allocations())
+                    monitor.log_allocations(allocations_);
+                if (info_.memory_budget > 0)
+                    monitor.check_memory_budget(allocations_, info_.memory_budget);
+                monitor.check_baseline();
                 if (info_.has_timed_out->load())
                     monitor.has_timed_out(info_.timeout);
             }
@@ -278,7 +381,7 @@ private:
     {
         if (info_.handle_exceptions) {
             try {
-                (this->*function)(test, monitor);
+                this->call(test, monitor, function);
                 monitor.log_success();
                 return true;
             } catch (const unittest::testfailure& e) {
@@ -296,7 +399,7 @@ private:
             }
         } else {
             try {
-                (this->*function)(test, monitor);
+                this->call(test, monitor, function);
                 monitor.log_success();
                 return true;
             } catch (const unittest::testfailure& e) {
@@ -307,6 +410,21 @@ private:
         }
     }
 
+    bool
+    is_tracking_allocations() const
+    {
+        return info_.track_allocations || info_.memory_budget > 0;
+    }
+
+    void
+    call(unittest::testcase<TestContext>*& test,
+         unittest::core::testmonitor& monitor,
+         bool (testfunctor::*function)(unittest::testcase<TestContext>*&, unittest::core::testmonitor&))
+    {
+        unittest::core::allocationscope scope(this->is_tracking_allocations() ? &allocations_ : nullptr);
+        (this->*function)(test, monitor);
+    }
+
     bool
     construct(unittest::testcase<TestContext>*& test,
               unittest::core::testmonitor& monitor)
@@ -318,11 +436,12 @@ private:
 
     bool
     _construct(unittest::testcase<TestContext>*& test,
-               unittest::core::testmonitor&)
+               unittest::core::testmonitor& monitor)
     {
         test = constructor_();
         test->set_test_context(context_);
         test->set_test_id(info_.method_id);
+        test->set_failure_sink(monitor.failure_sink());
         return true;
     }
 
@@ -354,12 +473,31 @@ private:
 
     bool
     _execute(unittest::testcase<TestContext>*& test,
-             unittest::core::testmonitor&)
+             unittest::core::testmonitor& monitor)
     {
-    	  caller_(test);
+        const auto start = info_.resource_usage ? unittest::core::measure_resources() : unittest::core::resourceusage();
+        const auto counters = info_.perf_counters ? unittest::core::read_perf_counters() : unittest::core::perfcounts();
+        try {
+            caller_(test);
+        } catch (...) {
+            log_usage(monitor, start, counters);
+            throw;
+        }
+        log_usage(monitor, start, counters);
         return true;
     }
 
+    void
+    log_usage(unittest::core::testmonitor& monitor,
+              const unittest::core::resourceusage& start,
+              const unittest::core::perfcounts& counters)
+    {
+        if (info_.perf_counters)
+            monitor.log_counters(counters);
+        if (info_.resource_usage)
+            monitor.log_resources(start);
+    }
+
     bool
     tear_down(unittest::testcase<TestContext>*& test,
               unittest::core::testmonitor& monitor)
@@ -398,6 +536,7 @@ private:
     std::function<unittest::testcase<TestContext>*()> constructor_;
     std::function<void(unittest::testcase<TestContext>*)> caller_;
     const unittest::core::testinfo info_;
+    unittest::core::allocationcounts allocations_;
 };
 /**
  * @brief Runs the test functor (provides actual implementation)
@@ -409,6 +548,7 @@ private:
  * @param skipped Whether this test run is skipped
  * @param skip_message A message explaining why the test is skipped
  * @param timeout The maximum allowed run time in seconds (ignored if <= 0)
+ * @param memory_budget The maximum allowed peak of heap bytes (ignored if <= 0)
  */
 template<typename TestContext>
 void run_testfunctor_impl(std::shared_ptr<TestContext> context,
@@ -418,16 +558,16 @@ void run_testfunctor_impl(std::shared_ptr<TestContext> context,
                           const std::string& test_name,
                           bool skipped,
                           const std::string& skip_message,
-                          double timeout)
+                          double timeout,
+                          long long memory_budget)
 {
     unittest::core::testfunctor<TestContext> functor(context, constructor, caller,
-                    unittest::core::make_testinfo(class_id, test_name, skipped, skip_message, timeout));
+                    unittest::core::make_testinfo(class_id, test_name, skipped, skip_message, timeout, memory_budget));
     const double updated_timeout = functor.info().timeout;
-    if (updated_timeout > 0) {
-        std::shared_ptr<std::atomic_bool> done = functor.info().done;
-        std::shared_ptr<std::atomic_bool> has_timed_out = functor.info().has_timed_out;
-        std::thread thread(functor);
-        unittest::core::observe_and_wait(std::move(thread), done, has_timed_out, updated_timeout);
+    if (updated_timeout > 0 && !unittest::core::is_killed_on_timeout()) {
+        unittest::core::watchdog::instance()->run(functor, functor.info().done,
+                                                  functor.info().has_timed_out, updated_timeout,
+                                                  unittest::core::make_testlog(functor.info()));
     } else {
         functor();
     }
@@ -442,6 +582,7 @@ void run_testfunctor_impl(std::shared_ptr<TestContext> context,
  * @param skipped Whether this test run is skipped
  * @param skip_message A message explaining why the test is skipped
  * @param timeout The maximum allowed run time in seconds (ignored if <= 0)
+ * @param memory_budget The maximum allowed peak of heap bytes (ignored if <= 0)
  */
 template<typename TestContext>
 void run_testfunctor(std::shared_ptr<TestContext> context,
@@ -451,9 +592,10 @@ void run_testfunctor(std::shared_ptr<TestContext> context,
                      const std::string& test_name,
                      bool skipped,
                      const std::string& skip_message,
-                     double timeout)
+                     double timeout,
+                     long long memory_budget)
 {
-    unittest::core::run_testfunctor_impl<TestContext>(context, constructor, caller, class_id, test_name, skipped, skip_message, timeout);
+    unittest::core::run_testfunctor_impl<TestContext>(context, constructor, caller, class_id, test_name, skipped, skip_message, timeout, memory_budget);
 }
 /**
  * @brief A typedef for the default context type
@@ -469,6 +611,7 @@ typedef typename unittest::testcase<>::context_type def_context_type;
  * @param skipped Whether this test run is skipped
  * @param skip_message A message explaining why the test is skipped
  * @param timeout The maximum allowed run time in seconds (ignored if <= 0)
+ * @param memory_budget The maximum allowed peak of heap bytes (ignored if <= 0)
  */
 template<>
 void run_testfunctor<def_context_type>(std::shared_ptr<def_context_type> context,
@@ -478,7 +621,44 @@ void run_testfunctor<def_context_type>(std::shared_ptr<def_context_type> context
                                        const std::string& test_name,
                                        bool skipped,
                                        const std::string& skip_message,
-                                       double timeout);
+                                       double timeout,
+                                       long long memory_budget);
+/**
+ * @brief Checks whether the test methods of a test class may run in parallel.
+ *  This is the case unless the class is marked by UNITTEST_NOT_THREADSAFE
+ */
+template<typename TestCase>
+struct is_threadsafe {
+    /**
+     * @brief Overload chosen for classes marked as not thread-safe
+     * @returns std::false_type
+     */
+    template<typename T>
+    static std::false_type
+    check(typename T::__not_threadsafe__*);
+    /**
+     * @brief Overload chosen for all other classes
+     * @returns std::true_type
+     */
+    template<typename T>
+    static std::true_type
+    check(...);
+    /**
+     * @brief Whether the test methods of the test class may run in parallel
+     */
+    static const bool value = decltype(check<TestCase>(nullptr))::value;
+};
+/**
+ * @brief Whether the test methods of the test class may run in parallel
+ */
+template<typename TestCase>
+const bool is_threadsafe<TestCase>::value;
+/**
+ * @brief Returns the thread pool to queue single test methods on
+ * @returns The thread pool, nullptr if test methods are to be run in place
+ */
+unittest::core::threadpool*
+get_method_threadpool();
 /**
  * @brief Updates the local timeout by assigning the global timeout
  *  from the test suite if the local one is not greater than zero
@@ -504,13 +684,19 @@ update_testrun_info(const std::string& class_id,
 } // core
 
 /**
- * @brief A test run with a test context and with timeout measurement
+ * @brief A test run with a test context, with timeout measurement, and
+ *  with a memory budget. The budget is checked against the heap bytes
+ *  allocated by the thread running the test, the allocations of helper
+ *  threads are not counted. In isolated children the
+ *  budget also limits the address space of the process unless the test
+ *  methods run in parallel (-m), see addressspacelimit
  * @param context The test context, can be a nullptr
  * @param method A pointer to the method to be run
  * @param test_name The name of the current test method
  * @param skipped Whether this test run is skipped
  * @param skip_message A message explaining why the test is skipped
  * @param timeout The maximum allowed run time in seconds (ignored if <= 0)
+ * @param memory_budget The maximum allowed peak of heap bytes (ignored if <= 0)
  */
 template<typename TestCase>
 void
@@ -519,17 +705,47 @@ testrun(std::shared_ptr<typename TestCase::context_type> context,
         std::string test_name,
         bool skipped,
         std::string skip_message,
-        double timeout)
+        double timeout,
+        long long memory_budget)
 {
     typedef typename TestCase::context_type context_type;
     auto constructor = []() -> unittest::testcase<context_type>* {
         return new TestCase;
     };
-    auto caller = [&method](unittest::testcase<context_type>* test_class) {
+    auto caller = [method](unittest::testcase<context_type>* test_class) {
         (dynamic_cast<TestCase*>(test_class)->*method)();
     };
     const std::string class_id = unittest::core::get_type_id<TestCase>();
-    unittest::core::run_testfunctor<context_type>(context, constructor, caller, class_id, test_name, skipped, skip_message, timeout);
+    auto pool = unittest::core::is_threadsafe<TestCase>::value ? unittest::core::get_method_threadpool() : nullptr;
+    const long sequence = unittest::core::make_test_sequence();
+    if (pool) {
+        pool->push([=]() {
+            unittest::core::set_test_sequence(sequence);
+            unittest::core::run_testfunctor<context_type>(context, constructor, caller, class_id, test_name, skipped, skip_message, timeout, memory_budget);
+        });
+    } else {
+        unittest::core::run_testfunctor<context_type>(context, constructor, caller, class_id, test_name, skipped, skip_message, timeout, memory_budget);
+    }
+}
+/**
+ * @brief A test run with a test context and with timeout measurement
+ * @param context The test context, can be a nullptr
+ * @param method A pointer to the method to be run
+ * @param test_name The name of the current test method
+ * @param skipped Whether this test run is skipped
+ * @param skip_message A message explaining why the test is skipped
+ * @param timeout The maximum allowed run time in seconds (ignored if <= 0)
+ */
+template<typename TestCase>
+void
+testrun(std::shared_ptr<typename TestCase::context_type> context,
+        void (TestCase::*method)(),
+        std::string test_name,
+        bool skipped,
+        std::string skip_message,
+        double timeout)
+{
+    unittest::testrun(context, method, test_name, skipped, skip_message, timeout, -1);
 }
 /**
  * @brief A test run with a test context and without timeout measurement
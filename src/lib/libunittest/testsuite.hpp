@@ -6,9 +6,13 @@
 #include "userargs.hpp"
 #include "testresults.hpp"
 #include "testlog.hpp"
+#include "testreporter.hpp"
+#include "consolewriter.hpp"
 #include <string>
 #include <thread>
 #include <map>
+#include <set>
+#include <functional>
 #include <atomic>
 /**
  * @brief Unit testing in C++
@@ -22,6 +26,14 @@ class testfailure;
  * @brief Internal functionality, not relevant for most users
  */
 namespace core {
+/**
+ * @brief The events of a test passed on to the listener of the test suite
+ */
+enum class testevent : unsigned int {
+    started,
+    timed_out,
+    finished
+};
 /**
  * @brief The test suite collecting test information (singleton, thread-safe)
  */
@@ -75,11 +87,20 @@ public:
     const unittest::core::userargs&
     get_arguments() const;
     /**
-     * @brief Returns a reference to the vector of registered class runs
+     * @brief Returns a reference to the vector of registered class runs,
+     *  ordered by the class names
      * @returns A reference to the vector of registered class runs
      */
     const std::vector<std::function<void()>>&
     get_class_runs() const;
+    /**
+     * @brief Returns a reference to the names of the registered test classes.
+     *  The names are in the same order as the class runs returned by
+     *  get_class_runs(), which are kept sorted while registering
+     * @returns A reference to the names of the registered test classes
+     */
+    const std::vector<std::string>&
+    get_class_names() const;
     /**
      * @brief Returns a reference to the mappings from test class IDs to
      *  test class names
@@ -94,11 +115,20 @@ public:
     std::vector<std::pair<std::thread, std::shared_ptr<std::atomic_bool>>>&
     get_lonely_threads() const;
     /**
-     * @brief Returns the accumulated test results
+     * @brief Returns a copy of the accumulated test results
      * @returns The test results
      */
     unittest::core::testresults
     get_results() const;
+    /**
+     * @brief Moves the test logs collected since the last call into the
+     *  accumulated test results and updates the counters. Logs already
+     *  accumulated keep their position such that subsequent logs can be
+     *  viewed using make_testlogview
+     * @returns A reference to the test results, valid until the next call
+     */
+    const unittest::core::testresults&
+    update_results() const;
     /**
      * @brief Logs text for a given method
      * @param method_id The method ID
@@ -108,13 +138,25 @@ public:
     log_text(const std::string& method_id,
              const std::string& text);
     /**
-     * @brief Logs a failure for a given method
-     * @param method_id The method ID
-     * @param failure The failure
+     * @brief Adds a reporter receiving the log of every test as soon as the
+     *  test is collected
+     * @param reporter The reporter
+     */
+    void
+    add_reporter(std::shared_ptr<unittest::core::testreporter> reporter);
+    /**
+     * @brief Sets the writer of the per-test console output. Without a
+     *  writer, messages are written to std::cout directly
+     * @param writer The console writer
+     */
+    void
+    set_consolewriter(std::shared_ptr<unittest::core::consolewriter> writer);
+    /**
+     * @brief Sets the baseline the benchmarks are compared against
+     * @param baseline The baseline, can be a nullptr
      */
     void
-    log_failure(const std::string& method_id,
-                const unittest::testfailure& failure);
+    set_baseline(std::shared_ptr<const unittest::core::benchbaseline> baseline);
 
 private:
 
@@ -126,15 +168,16 @@ private:
     friend void
     register_class(const std::string& class_name);
 
-    friend void
-    observe_and_wait(std::thread&& thread,
-                     std::shared_ptr<std::atomic_bool> done,
-                     std::shared_ptr<std::atomic_bool> has_timed_out,
-                     double timeout);
+    friend class processrunner;
+
+    friend class watchdog;
 
     void
     make_keep_running(const unittest::core::testlog& log);
 
+    bool
+    is_keep_running() const;
+
     void
     start_timing();
 
@@ -142,7 +185,7 @@ private:
     stop_timing();
 
     void
-    collect(const unittest::core::testlog& log);
+    collect(unittest::core::testlog log);
 
     bool
     is_test_run(const std::string& class_name,
@@ -159,8 +202,35 @@ private:
     add_lonely_thread(std::thread&& thread,
                       std::shared_ptr<std::atomic_bool> done);
 
-    std::vector<unittest::testfailure>
-    get_failures(const std::string& method_id);
+    void
+    set_listener(std::function<void(const unittest::core::testlog&, unittest::core::testevent)> listener);
+
+    void
+    notify_start(const unittest::core::testlog& log);
+
+    void
+    remove_reporters();
+
+    void
+    silence_console();
+
+    void
+    write_test_start(const unittest::core::testlog& log);
+
+    void
+    write_test_end(const unittest::core::testlog& log);
+
+    void
+    write_test_timeout(const unittest::core::testlog& log);
+
+    void
+    set_excluded_tests(const std::set<std::string>& method_ids);
+
+    bool
+    is_excluded(const std::string& method_id) const;
+
+    const unittest::core::benchbaseline*
+    get_baseline() const;
 
     struct impl;
     std::unique_ptr<impl> impl_;
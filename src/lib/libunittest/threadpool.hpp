@@ -0,0 +1,95 @@
+/**
+ * @brief A work-stealing thread pool
+ * @file threadpool.hpp
+ */
+#pragma once
+#include <functional>
+#include <memory>
+/**
+ * @brief Unit testing in C++
+ */
+namespace unittest {
+/**
+ * @brief Internal functionality, not relevant for most users
+ */
+namespace core {
+/**
+ * @brief A work-stealing thread pool. Each worker owns a task deque. Workers
+ *  take tasks from the back of their own deque, then from a shared queue of
+ *  tasks pushed from outside the pool in submission order, and steal from the
+ *  front of the other deques when they run out of work. The threads are
+ *  created once at construction and joined at destruction
+ */
+class threadpool {
+public:
+    /**
+     * @brief Constructor
+     * @param n_threads The number of worker threads (at least one is created)
+     */
+    explicit
+    threadpool(int n_threads);
+    /**
+     * @brief Destructor. Waits for the workers to finish their current task
+     *  and joins them. Tasks still queued are discarded
+     */
+    virtual
+    ~threadpool();
+    /**
+     * @brief Copy constructor. Deleted
+     * @param other An instance of threadpool
+     */
+    threadpool(const threadpool& other) = delete;
+    /**
+     * @brief Copy assignment operator. Deleted
+     * @param other An instance of threadpool
+     * @returns An threadpool instance
+     */
+    threadpool&
+    operator=(const threadpool& other) = delete;
+    /**
+     * @brief Move constructor. Deleted
+     * @param other An instance of threadpool
+     */
+    threadpool(threadpool&& other) = delete;
+    /**
+     * @brief Move assignment operator. Deleted
+     * @param other An instance of threadpool
+     * @returns An threadpool instance
+     */
+    threadpool&
+    operator=(threadpool&& other) = delete;
+    /**
+     * @brief Queues a task. When called from one of the pool's workers the task
+     *  goes to the worker's own deque, otherwise to the shared queue
+     * @param task The task
+     */
+    void
+    push(std::function<void()> task);
+    /**
+     * @brief Blocks until all queued tasks, including the ones queued by
+     *  other tasks in the meantime, have finished. Must not be called from
+     *  one of the pool's workers
+     * @throws The first exception thrown by any of the tasks
+     */
+    void
+    wait();
+    /**
+     * @brief Returns the number of worker threads
+     * @returns The number of worker threads
+     */
+    int
+    size() const;
+    /**
+     * @brief Returns the pool the calling thread is a worker of
+     * @returns A pointer to the pool, nullptr if the calling thread is not a worker
+     */
+    static threadpool*
+    current();
+
+private:
+    struct impl;
+    std::unique_ptr<impl> impl_;
+};
+
+} // core
+} // unittest
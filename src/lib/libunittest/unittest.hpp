@@ -7,15 +7,32 @@
 #include "assertions.hpp"
 #include "checkers.hpp"
 #include "environments.hpp"
+#include "failuresink.hpp"
 #include "formatting.hpp"
 #include "testcase.hpp"
 #include "testfailure.hpp"
+#include "testhistory.hpp"
 #include "testlog.hpp"
 #include "testresults.hpp"
 #include "testrun.hpp"
 #include "teststatus.hpp"
 #include "testsuite.hpp"
 #include "testregistry.hpp"
+#include "testreporter.hpp"
+#include "xmlreporter.hpp"
+#include "jsonreporter.hpp"
+#include "binresults.hpp"
+#include "consolewriter.hpp"
+#include "resultmerge.hpp"
+#include "resourceusage.hpp"
+#include "perfcounters.hpp"
+#include "allocations.hpp"
+#include "benchmark.hpp"
+#include "baseline.hpp"
+#include "threadpool.hpp"
+#include "sharding.hpp"
+#include "isolation.hpp"
+#include "watchdog.hpp"
 #include "testcollection.hpp"
 #include "userargs.hpp"
 #include "utilities.hpp"
@@ -94,6 +94,109 @@ struct userargs : argparser {
      * @brief Whether to display a random quote and exit
      */
     bool display_quote;
+    /**
+     * @brief Whether to run the test methods of a class in parallel (default: false)
+     */
+    bool parallel_methods;
+    /**
+     * @brief The file recording test durations across runs (default: "")
+     */
+    std::string history_filename;
+    /**
+     * @brief The duration assumed for test classes without history (default: 1)
+     */
+    double default_estimate;
+    /**
+     * @brief The index of the shard to run (default: 0)
+     */
+    int shard_index;
+    /**
+     * @brief The number of shards the test classes are split into (default: 1)
+     */
+    int shard_count;
+    /**
+     * @brief A history file the shards are balanced by instead of hashing
+     *  the class names. It must not be written while the shards run such
+     *  that every shard reads the same history (default: "")
+     */
+    std::string balance_filename;
+    /**
+     * @brief Whether to run each test class in its own child process (default: false)
+     */
+    bool isolate_classes;
+    /**
+     * @brief The number of worker processes to run tests on (default: 0)
+     */
+    int worker_processes;
+    /**
+     * @brief The file receiving the JSON Lines event stream, e.g. /dev/fd/3
+     *  for a file descriptor (default: "")
+     */
+    std::string json_filename;
+    /**
+     * @brief The file receiving the results in the compact binary format (default: "")
+     */
+    std::string binary_filename;
+    /**
+     * @brief The interval in seconds between writes of the per-test console
+     *  output, written at once if not greater than zero (default: 0.1)
+     */
+    double console_interval;
+    /**
+     * @brief Whether to write the per-test console output in the order the
+     *  tests are registered instead of the order they finish (default: false)
+     */
+    bool ordered_output;
+    /**
+     * @brief Whether to write no per-test console output at all (default: false)
+     */
+    bool silent_output;
+    /**
+     * @brief Whether to account the resources used per test, e.g. CPU time
+     *  and page faults (default: false)
+     */
+    bool resource_usage;
+    /**
+     * @brief Whether to count hardware events per test, e.g. instructions
+     *  and cache misses (default: false)
+     */
+    bool perf_counters;
+    /**
+     * @brief Whether to track the heap allocations per test and to report
+     *  the tests leaking memory (default: false)
+     */
+    bool track_allocations;
+    /**
+     * @brief The target time in seconds per benchmark sample. The number of
+     *  iterations per sample is calibrated to reach it (default: 0.01)
+     */
+    double bench_time;
+    /**
+     * @brief The number of samples per benchmark (default: 10)
+     */
+    int bench_samples;
+    /**
+     * @brief The name of a baseline file to compare the benchmarks against.
+     *  No comparison if empty (default: "")
+     */
+    std::string baseline_filename;
+    /**
+     * @brief The name of a baseline file to save the benchmarks to. Other
+     *  benchmarks already in the file are kept (default: "")
+     */
+    std::string save_baseline_filename;
+    /**
+     * @brief The relative slowdown against the baseline at which a
+     *  significantly slower benchmark fails (default: 0.05)
+     */
+    double bench_threshold;
+    /**
+     * @brief Whether to let a test exceeding its timeout finish in its child
+     *  process, with -j or -P. The child then only reports its class as done
+     *  once the test has finished. Otherwise the child is killed when the
+     *  test exceeds its timeout (default: false)
+     */
+    bool keep_timeouts;
 
 private:
 
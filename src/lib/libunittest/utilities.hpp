@@ -24,6 +24,14 @@ namespace unittest {
  * @brief Internal functionality, not relevant for most users
  */
 namespace core {
+/**
+ * @brief A work-stealing thread pool
+ */
+class threadpool;
+/**
+ * @brief The failure sink of non-deadly assertions
+ */
+class failuresink;
 /**
  * @brief Computes "now"
  * @return Microseconds since epoch
@@ -37,6 +45,13 @@ now();
  */
 std::string
 xml_escape(const std::string& data);
+/**
+ * @brief Escapes a string for use in a JSON string literal
+ * @param data Some string
+ * @returns The escaped string (without the enclosing quotes)
+ */
+std::string
+json_escape(const std::string& data);
 /**
  * @brief Generates the ISO8601 time stamp from a time point object
  * @param time_point The time point object
@@ -424,6 +439,16 @@ is_regex_matched(const std::string& value,
 int
 call_functions(const std::vector<std::function<void()>>& functions,
                int n_threads=1);
+/**
+ * @brief Calls each function of a given vector of functions on a thread pool
+ *  and waits until all of them have finished
+ * @param functions The vector of functions
+ * @param pool The thread pool
+ * @returns The number of function calls
+ */
+int
+call_functions(const std::vector<std::function<void()>>& functions,
+               unittest::core::threadpool& pool);
 /**
  * @brief Limits a given string to some maximum length
  * @param value The string
@@ -450,6 +475,96 @@ string_of_file_and_line(const std::string& filename,
  */
 std::string
 string_of_tagged_text(const std::string& text, const std::string& tag);
+/**
+ * @brief The location of an assertion in the source code. Capturing it
+ *  does not allocate as it only refers to static data
+ */
+struct sourcespot {
+    /**
+     * @brief The name of the file
+     */
+    const char* filename;
+    /**
+     * @brief The line number within the file
+     */
+    int linenumber;
+    /**
+     * @brief Converts to a tagged string for code expecting a string
+     * @returns A tagged string build from filename and line number
+     */
+    operator std::string() const
+    {
+        return unittest::core::string_of_file_and_line(filename, linenumber);
+    }
+};
+/**
+ * @brief The call site of an assertion as written in the source code
+ */
+struct sourcecall {
+    /**
+     * @brief The text of the call site
+     */
+    const char* text;
+    /**
+     * @brief Converts to a tagged string for code expecting a string
+     * @returns A tagged string of the call site
+     */
+    operator std::string() const
+    {
+        return unittest::core::string_of_tagged_text(text, "CALL");
+    }
+};
+/**
+ * @brief A tag indicating the use of non-deadly assertions
+ */
+struct ndastag {
+    /**
+     * @brief The failure sink of the test, nullptr if created outside of a
+     *  test. Shared such that the tag may be passed to a helper thread
+     */
+    std::shared_ptr<unittest::core::failuresink> sink;
+    /**
+     * @brief Converts to a tagged string for code expecting a string
+     * @returns A tagged string of the test ID
+     */
+    operator std::string() const;
+};
+/**
+ * @brief A user message that is only formatted when written to a stream,
+ *  i.e., when an assertion has failed
+ */
+template<typename Formatter>
+struct deferredmsg {
+    /**
+     * @brief A functor writing the message to a given stream
+     */
+    Formatter formatter;
+};
+/**
+ * @brief Creates a deferred user message
+ * @param formatter A functor writing the message to a given stream
+ * @returns A deferred user message
+ */
+template<typename Formatter>
+unittest::core::deferredmsg<Formatter>
+make_deferredmsg(Formatter formatter)
+{
+    return {formatter};
+}
+/**
+ * @brief Formats a deferred user message into an output stream
+ * @param stream The output stream
+ * @param message The deferred user message
+ * @returns The output stream
+ */
+template<typename Formatter>
+std::ostream&
+operator<<(std::ostream& stream,
+           const unittest::core::deferredmsg<Formatter>& message)
+{
+    message.formatter(stream);
+    return stream;
+}
 /**
  * @brief Ensures that all threads passed will be finished and joined.
  *  This makes the threads happy.
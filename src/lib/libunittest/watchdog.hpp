@@ -0,0 +1,87 @@
+/**
+ * @brief A watchdog observing the timeouts of tests
+ * @file watchdog.hpp
+ */
+#pragma once
+#include "testlog.hpp"
+#include <functional>
+#include <memory>
+#include <atomic>
+/**
+ * @brief Unit testing in C++
+ */
+namespace unittest {
+/**
+ * @brief Internal functionality, not relevant for most users
+ */
+namespace core {
+/**
+ * @brief Runs tests that have a timeout on cached threads and observes
+ *  their deadlines. A single watchdog thread keeps the deadlines in a
+ *  min-heap and sleeps until the earliest deadline. Threads running a test
+ *  that has timed out are handed over to the test suite as lonely threads,
+ *  all other threads are reused for subsequent tests
+ */
+class watchdog {
+public:
+    /**
+     * @brief Returns a pointer to the instance of this class
+     * @returns A pointer to the instance of this class
+     */
+    static watchdog*
+    instance();
+    /**
+     * @brief Destructor. Stops the watchdog and joins all idle threads
+     */
+    virtual
+    ~watchdog();
+    /**
+     * @brief Copy constructor. Deleted
+     * @param other An instance of watchdog
+     */
+    watchdog(const watchdog& other) = delete;
+    /**
+     * @brief Copy assignment operator. Deleted
+     * @param other An instance of watchdog
+     * @returns An watchdog instance
+     */
+    watchdog&
+    operator=(const watchdog& other) = delete;
+    /**
+     * @brief Move constructor. Deleted
+     * @param other An instance of watchdog
+     */
+    watchdog(watchdog&& other) = delete;
+    /**
+     * @brief Move assignment operator. Deleted
+     * @param other An instance of watchdog
+     * @returns An watchdog instance
+     */
+    watchdog&
+    operator=(watchdog&& other) = delete;
+    /**
+     * @brief Runs a test on a cached thread and blocks until the test has
+     *  finished or its timeout has passed
+     * @param test The test
+     * @param done Whether the test is finished, set by the test
+     * @param has_timed_out Whether the test has timed out, set by the watchdog
+     * @param timeout The maximum allowed run time in seconds
+     * @param log The log identifying the test in the timeout message
+     */
+    void
+    run(std::function<void()> test,
+        std::shared_ptr<std::atomic_bool> done,
+        std::shared_ptr<std::atomic_bool> has_timed_out,
+        double timeout,
+        const unittest::core::testlog& log=unittest::core::testlog());
+
+private:
+
+    watchdog();
+
+    struct impl;
+    std::unique_ptr<impl> impl_;
+};
+
+} // core
+} // unittest
@@ -0,0 +1,100 @@
+/**
+ * @brief The reporter streaming the XML output while tests are running
+ * @file xmlreporter.hpp
+ */
+#pragma once
+#include "testreporter.hpp"
+#include <ostream>
+#include <string>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <utility>
+/**
+ * @brief Unit testing in C++
+ */
+namespace unittest {
+/**
+ * @brief Internal functionality, not relevant for most users
+ */
+namespace core {
+/**
+ * @brief Streams the XML output. The testsuite tag is written on
+ *  construction with its totals set to zero and padded by white space.
+ *  Testcases are appended as they are reported, through a buffer that is
+ *  flushed when it grows large or at least every second. Finishing closes
+ *  the testsuite and overwrites the testsuite tag in place with the totals.
+ *  If the process dies early the output holds all testcases flushed so far.
+ *  A stream that cannot seek, e.g. a pipe, gets the whole document at once
+ *  on finishing instead
+ */
+class xmlreporter : public unittest::core::testreporter {
+public:
+    /**
+     * @brief Constructor
+     * @param stream The output stream
+     * @param suite_name the name of the test suite
+     * @param shuffle_seed The shuffle seed
+     * @param shard_index The index of the shard
+     * @param shard_count The number of shards (no shard is written if less than two)
+     * @param time_point The time point used in the root tag (defaults to now)
+     * @param local_time Whether timestamps are displayed in local time
+     * @param properties The properties written after the testsuite tag
+     */
+    xmlreporter(std::shared_ptr<std::ostream> stream,
+                const std::string& suite_name,
+                long long shuffle_seed,
+                int shard_index,
+                int shard_count,
+                const std::chrono::system_clock::time_point& time_point=std::chrono::system_clock::now(),
+                bool local_time=true,
+                const std::vector<std::pair<std::string, std::string>>& properties={});
+    /**
+     * @brief Destructor
+     */
+    virtual
+    ~xmlreporter();
+    /**
+     * @brief Copy constructor. Deleted
+     * @param other An instance of xmlreporter
+     */
+    xmlreporter(const xmlreporter& other) = delete;
+    /**
+     * @brief Copy assignment operator. Deleted
+     * @param other An instance of xmlreporter
+     * @returns An xmlreporter instance
+     */
+    xmlreporter&
+    operator=(const xmlreporter& other) = delete;
+    /**
+     * @brief Move constructor. Deleted
+     * @param other An instance of xmlreporter
+     */
+    xmlreporter(xmlreporter&& other) = delete;
+    /**
+     * @brief Move assignment operator. Deleted
+     * @param other An instance of xmlreporter
+     * @returns An xmlreporter instance
+     */
+    xmlreporter&
+    operator=(xmlreporter&& other) = delete;
+    /**
+     * @brief Appends a testcase. Thread-safe
+     * @param log The test log
+     */
+    void
+    report(const unittest::core::testlog& log);
+    /**
+     * @brief Closes the testsuite and writes the totals. Thread-safe
+     * @param results The test results providing the totals
+     */
+    void
+    finish(const unittest::core::testresults& results);
+
+private:
+    struct impl;
+    std::unique_ptr<impl> impl_;
+};
+
+} // core
+} // unittest
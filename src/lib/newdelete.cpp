@@ -0,0 +1,113 @@
+#include "libunittest/allocations.hpp"
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <new>
+
+namespace {
+
+// stored in front of each block, keeps the alignment of malloc
+struct alignas(alignof(std::max_align_t)) blockheader {
+    unittest::core::allocationtag tag;
+};
+
+void*
+allocate(std::size_t size)
+{
+    if (size == 0)
+        size = 1;
+    if (size > std::numeric_limits<std::size_t>::max() - sizeof(blockheader))
+        throw std::bad_alloc();
+    void* pointer;
+    while (!(pointer = std::malloc(sizeof(blockheader) + size))) {
+        const std::new_handler handler = std::get_new_handler();
+        if (!handler)
+            throw std::bad_alloc();
+        handler();
+    }
+    auto header = static_cast<blockheader*>(pointer);
+    header->tag = unittest::core::note_allocation(static_cast<long long>(size));
+    return header + 1;
+}
+
+void*
+allocate_nothrow(std::size_t size) noexcept
+{
+    try {
+        return allocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void
+deallocate(void* pointer) noexcept
+{
+    if (!pointer)
+        return;
+    auto header = static_cast<blockheader*>(pointer) - 1;
+    unittest::core::note_deallocation(header->tag);
+    std::free(header);
+}
+
+}
+
+void*
+operator new(std::size_t size)
+{
+    return allocate(size);
+}
+
+void*
+operator new[](std::size_t size)
+{
+    return allocate(size);
+}
+
+void*
+operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate_nothrow(size);
+}
+
+void*
+operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate_nothrow(size);
+}
+
+void
+operator delete(void* pointer) noexcept
+{
+    deallocate(pointer);
+}
+
+void
+operator delete[](void* pointer) noexcept
+{
+    deallocate(pointer);
+}
+
+void
+operator delete(void* pointer, std::size_t) noexcept
+{
+    deallocate(pointer);
+}
+
+void
+operator delete[](void* pointer, std::size_t) noexcept
+{
+    deallocate(pointer);
+}
+
+void
+operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+    deallocate(pointer);
+}
+
+void
+operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+    deallocate(pointer);
+}
@@ -0,0 +1,205 @@
+#include "libunittest/perfcounters.hpp"
+#include "libunittest/utilities.hpp"
+#include <cstring>
+#include <cstdint>
+#include <fstream>
+#ifdef __linux__
+#include <cerrno>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace unittest {
+namespace core {
+
+namespace {
+
+#ifdef __linux__
+
+#ifndef PERF_FLAG_FD_CLOEXEC
+#define PERF_FLAG_FD_CLOEXEC (1UL << 3)
+#endif
+
+enum counterindex {
+    cycles_index = 0,
+    instructions_index,
+    cache_misses_index,
+    branch_misses_index,
+    tlb_misses_index,
+    n_counters
+};
+
+int
+open_counter(std::uint32_t type,
+             std::uint64_t config,
+             int group_fd)
+{
+    struct perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(::syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, PERF_FLAG_FD_CLOEXEC));
+}
+
+// the counters of a single thread, read at once as a group led by the cycles
+struct countergroup {
+    int fds_[n_counters];
+    int slots_[n_counters];
+    int n_open_;
+    int error_;
+
+    countergroup()
+        : n_open_(0), error_(0)
+    {
+        const std::uint64_t tlb_read_miss = PERF_COUNT_HW_CACHE_DTLB |
+                                            (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        const std::uint32_t types[n_counters] = {PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+                                                 PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE};
+        const std::uint64_t configs[n_counters] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                                   PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES,
+                                                   tlb_read_miss};
+        for (int i=0; i<n_counters; ++i) {
+            fds_[i] = -1;
+            slots_[i] = -1;
+        }
+        for (int i=0; i<n_counters; ++i) {
+            fds_[i] = open_counter(types[i], configs[i], i==cycles_index ? -1 : fds_[cycles_index]);
+            if (fds_[i] < 0) {
+                if (i==cycles_index) {
+                    error_ = errno;
+                    return;
+                }
+                continue;
+            }
+            slots_[i] = n_open_++;
+        }
+    }
+
+    ~countergroup()
+    {
+        for (int i=0; i<n_counters; ++i)
+            if (fds_[i] >= 0)
+                ::close(fds_[i]);
+    }
+
+    countergroup(const countergroup&) = delete;
+
+    countergroup&
+    operator=(const countergroup&) = delete;
+
+    bool
+    is_open() const
+    {
+        return fds_[cycles_index] >= 0;
+    }
+
+    bool
+    read(perfcounts& counts) const
+    {
+        if (!is_open())
+            return false;
+        std::uint64_t values[3 + n_counters];
+        ssize_t size;
+        while ((size = ::read(fds_[cycles_index], values, sizeof(values))) < 0 && errno==EINTR);
+        if (size < static_cast<ssize_t>((3 + n_open_) * sizeof(std::uint64_t)))
+            return false;
+        long long* targets[n_counters] = {&counts.cycles, &counts.instructions, &counts.cache_misses,
+                                          &counts.branch_misses, &counts.tlb_misses};
+        for (int i=0; i<n_counters; ++i)
+            *targets[i] = slots_[i] >= 0 ? static_cast<long long>(values[3 + slots_[i]]) : -1;
+        counts.time_enabled = static_cast<long long>(values[1]);
+        counts.time_running = static_cast<long long>(values[2]);
+        counts.measured = true;
+        return true;
+    }
+
+};
+
+thread_local countergroup g_thread_counters;
+
+std::string
+read_paranoid_level()
+{
+    std::ifstream file("/proc/sys/kernel/perf_event_paranoid");
+    std::string level;
+    file >> level;
+    return level;
+}
+
+#endif
+
+long long
+scale_count(long long start,
+            long long end,
+            double scale)
+{
+    if (start < 0 || end < 0)
+        return -1;
+    return static_cast<long long>((end - start) * scale + 0.5);
+}
+
+}
+
+perfcounts::perfcounts()
+    : measured(false), instructions(-1), cycles(-1), cache_misses(-1),
+      branch_misses(-1), tlb_misses(-1), time_enabled(0), time_running(0)
+{}
+
+perfcounts
+read_perf_counters()
+{
+    perfcounts counts;
+#ifdef __linux__
+    g_thread_counters.read(counts);
+#endif
+    return counts;
+}
+
+perfcounts
+perf_difference(const perfcounts& start,
+                const perfcounts& end)
+{
+    perfcounts counts;
+    const long long running = end.time_running - start.time_running;
+    if (!start.measured || !end.measured || running <= 0)
+        return counts;
+    const long long enabled = end.time_enabled - start.time_enabled;
+    const double scale = enabled > running ? static_cast<double>(enabled) / running : 1.;
+    counts.measured = true;
+    counts.instructions = scale_count(start.instructions, end.instructions, scale);
+    counts.cycles = scale_count(start.cycles, end.cycles, scale);
+    counts.cache_misses = scale_count(start.cache_misses, end.cache_misses, scale);
+    counts.branch_misses = scale_count(start.branch_misses, end.branch_misses, scale);
+    counts.tlb_misses = scale_count(start.tlb_misses, end.tlb_misses, scale);
+    counts.time_enabled = enabled;
+    counts.time_running = running;
+    return counts;
+}
+
+bool
+probe_perf_counters(std::string* reason)
+{
+#ifdef __linux__
+    const countergroup group;
+    if (!group.is_open() && reason) {
+        *reason = join("perf_event_open() failed: ", std::strerror(group.error_));
+        const auto level = read_paranoid_level();
+        if (level.size())
+            *reason += join(" (perf_event_paranoid is ", level, ")");
+    }
+    return group.is_open();
+#else
+    if (reason)
+        *reason = "Not supported on this platform";
+    return false;
+#endif
+}
+
+} // core
+} // unittest
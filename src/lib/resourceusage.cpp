@@ -0,0 +1,112 @@
+#include "libunittest/resourceusage.hpp"
+#include <cstdlib>
+#include <cstring>
+#ifndef _MSC_VER
+#include <cerrno>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace unittest {
+namespace core {
+
+namespace {
+
+#ifndef _MSC_VER
+
+double
+seconds_of(const struct timeval& value)
+{
+    return value.tv_sec + value.tv_usec * 1e-6;
+}
+
+long long
+read_io_field(const char* data,
+              const char* name)
+{
+    const char* found = std::strstr(data, name);
+    return found ? std::strtoll(found + std::strlen(name), nullptr, 10) : 0;
+}
+
+void
+read_io_counters(resourceusage& usage)
+{
+    const int fd = ::open("/proc/thread-self/io", O_RDONLY);
+    if (fd < 0)
+        return;
+    char data[512];
+    ssize_t size;
+    while ((size = ::read(fd, data, sizeof(data) - 1)) < 0 && errno==EINTR);
+    ::close(fd);
+    if (size <= 0)
+        return;
+    data[size] = '\0';
+    usage.read_bytes = read_io_field(data, "rchar:");
+    usage.counter_bytes = size;
+    usage.write_bytes = read_io_field(data, "wchar:");
+}
+
+#endif
+
+}
+
+resourceusage::resourceusage()
+    : measured(false), user_time(0), system_time(0), max_rss(0),
+      minor_faults(0), major_faults(0), voluntary_switches(0),
+      involuntary_switches(0), read_bytes(0), write_bytes(0), counter_bytes(0)
+{}
+
+resourceusage
+measure_resources()
+{
+    resourceusage usage;
+#ifndef _MSC_VER
+#ifdef RUSAGE_THREAD
+    const int who = RUSAGE_THREAD;
+#else
+    const int who = RUSAGE_SELF;
+#endif
+    struct rusage values;
+    if (::getrusage(who, &values)!=0)
+        return usage;
+    usage.measured = true;
+    usage.user_time = seconds_of(values.ru_utime);
+    usage.system_time = seconds_of(values.ru_stime);
+#ifdef __APPLE__
+    usage.max_rss = values.ru_maxrss;
+#else
+    usage.max_rss = values.ru_maxrss * 1024LL;
+#endif
+    usage.minor_faults = values.ru_minflt;
+    usage.major_faults = values.ru_majflt;
+    usage.voluntary_switches = values.ru_nvcsw;
+    usage.involuntary_switches = values.ru_nivcsw;
+    read_io_counters(usage);
+#endif
+    return usage;
+}
+
+resourceusage
+resource_difference(const resourceusage& start,
+                    const resourceusage& end)
+{
+    resourceusage usage;
+    if (!start.measured || !end.measured)
+        return usage;
+    usage.measured = true;
+    usage.user_time = end.user_time - start.user_time;
+    usage.system_time = end.system_time - start.system_time;
+    usage.max_rss = end.max_rss - start.max_rss;
+    usage.minor_faults = end.minor_faults - start.minor_faults;
+    usage.major_faults = end.major_faults - start.major_faults;
+    usage.voluntary_switches = end.voluntary_switches - start.voluntary_switches;
+    usage.involuntary_switches = end.involuntary_switches - start.involuntary_switches;
+    usage.read_bytes = end.read_bytes - start.read_bytes - start.counter_bytes;
+    usage.write_bytes = end.write_bytes - start.write_bytes;
+    return usage;
+}
+
+} // core
+} // unittest
@@ -0,0 +1,742 @@
+#include "libunittest/resultmerge.hpp"
+#include "libunittest/binresults.hpp"
+#include "libunittest/teststatus.hpp"
+#include "libunittest/testfailure.hpp"
+#include "libunittest/utilities.hpp"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <map>
+#include <cstdio>
+#include <cstdlib>
+#include <cctype>
+#include <ctime>
+
+namespace unittest {
+namespace core {
+
+namespace {
+
+struct xmltag {
+    std::string name;
+    std::map<std::string, std::string> attributes;
+    bool is_closing;
+    bool is_empty;
+    std::string text;
+};
+
+void
+append_utf8(std::string& result,
+            unsigned long code)
+{
+    if (code < 0x80) {
+        result.append(1, static_cast<char>(code));
+    } else if (code < 0x800) {
+        result.append(1, static_cast<char>(0xc0 | (code >> 6)));
+        result.append(1, static_cast<char>(0x80 | (code & 0x3f)));
+    } else if (code < 0x10000) {
+        result.append(1, static_cast<char>(0xe0 | (code >> 12)));
+        result.append(1, static_cast<char>(0x80 | ((code >> 6) & 0x3f)));
+        result.append(1, static_cast<char>(0x80 | (code & 0x3f)));
+    } else {
+        result.append(1, static_cast<char>(0xf0 | (code >> 18)));
+        result.append(1, static_cast<char>(0x80 | ((code >> 12) & 0x3f)));
+        result.append(1, static_cast<char>(0x80 | ((code >> 6) & 0x3f)));
+        result.append(1, static_cast<char>(0x80 | (code & 0x3f)));
+    }
+}
+
+std::string
+xml_unescape(const std::string& data)
+{
+    std::string result;
+    result.reserve(data.size());
+    for (size_t i=0; i<data.size(); ++i) {
+        const auto end = data[i]=='&' ? data.find(';', i) : std::string::npos;
+        if (end==std::string::npos) {
+            result.append(1, data[i]);
+            continue;
+        }
+        const auto entity = data.substr(i + 1, end - i - 1);
+        if (entity=="amp") result.append("&");
+        else if (entity=="lt") result.append("<");
+        else if (entity=="gt") result.append(">");
+        else if (entity=="quot") result.append("\"");
+        else if (entity=="apos") result.append("'");
+        else if (entity.size() > 1 && entity[0]=='#') {
+            const bool is_hex = entity[1]=='x' || entity[1]=='X';
+            append_utf8(result, std::strtoul(entity.c_str() + (is_hex ? 2 : 1), nullptr, is_hex ? 16 : 10));
+        } else {
+            result.append(data, i, end - i + 1);
+        }
+        i = end;
+    }
+    return result;
+}
+
+bool
+skip_to(std::istream& stream,
+        const std::string& marker)
+{
+    size_t matched = 0;
+    char character;
+    while (stream.get(character)) {
+        matched = character==marker[matched] ? matched + 1 : (character==marker[0] ? 1 : 0);
+        if (matched==marker.size())
+            return true;
+    }
+    return false;
+}
+
+bool
+read_xml_tag(std::istream& stream,
+             xmltag& tag,
+             std::streampos* position=nullptr)
+{
+    tag.name.clear();
+    tag.attributes.clear();
+    tag.is_closing = false;
+    tag.is_empty = false;
+    tag.text.clear();
+    char character;
+    while (true) {
+        while (stream.get(character) && character!='<')
+            tag.text.append(1, character);
+        if (!stream)
+            return false;
+        if (position)
+            *position = stream.tellg() - std::streamoff(1);
+        const int peeked = stream.peek();
+        if (peeked=='?') {
+            skip_to(stream, "?>");
+        } else if (peeked=='!') {
+            stream.get(character);
+            if (stream.peek()=='-')
+                skip_to(stream, "-->");
+            else
+                skip_to(stream, ">");
+        } else {
+            break;
+        }
+    }
+    if (stream.peek()=='/') {
+        stream.get(character);
+        tag.is_closing = true;
+    }
+    while (stream.get(character) && !std::isspace(static_cast<unsigned char>(character)) && character!='/' && character!='>')
+        tag.name.append(1, character);
+    while (stream) {
+        if (character=='>')
+            break;
+        if (character=='/') {
+            tag.is_empty = true;
+        } else if (!std::isspace(static_cast<unsigned char>(character))) {
+            std::string name(1, character);
+            while (stream.get(character) && character!='=' && !std::isspace(static_cast<unsigned char>(character)))
+                name.append(1, character);
+            while (character!='=' && stream.get(character));
+            char quote = 0;
+            while (stream.get(quote) && quote!='"' && quote!='\'');
+            std::string value;
+            while (stream.get(character) && character!=quote)
+                value.append(1, character);
+            tag.attributes[name] = xml_unescape(value);
+        }
+        stream.get(character);
+    }
+    tag.text = xml_unescape(tag.text);
+    return static_cast<bool>(stream);
+}
+
+std::string
+get_attribute(const xmltag& tag,
+              const std::string& name,
+              const std::string& default_value="")
+{
+    const auto found = tag.attributes.find(name);
+    return found!=tag.attributes.end() ? found->second : default_value;
+}
+
+template<typename T>
+T
+get_number(const xmltag& tag,
+           const std::string& name,
+           T default_value)
+{
+    const auto value = get_attribute(tag, name);
+    if (value.empty())
+        return default_value;
+    try {
+        return to_number<T>(value);
+    } catch (const std::exception&) {
+        return default_value;
+    }
+}
+
+std::chrono::system_clock::time_point
+parse_iso_timestamp(const std::string& timestamp)
+{
+    struct std::tm timeinfo = std::tm();
+    if (std::sscanf(timestamp.c_str(), "%d-%d-%dT%d:%d:%d", &timeinfo.tm_year, &timeinfo.tm_mon,
+                    &timeinfo.tm_mday, &timeinfo.tm_hour, &timeinfo.tm_min, &timeinfo.tm_sec)!=6)
+        return std::chrono::system_clock::time_point();
+    timeinfo.tm_year -= 1900;
+    timeinfo.tm_mon -= 1;
+    timeinfo.tm_isdst = -1;
+    return std::chrono::system_clock::from_time_t(std::mktime(&timeinfo));
+}
+
+void
+parse_failure_info(const std::string& text,
+                   std::string& assertion,
+                   std::string& filename,
+                   int& linenumber,
+                   std::string& callsite)
+{
+    std::istringstream stream(text);
+    std::string line;
+    while (std::getline(stream, line)) {
+        line = trim(line);
+        if (line.compare(0, 11, "assertion: ")==0) {
+            assertion = line.substr(11);
+            const auto in_pos = assertion.find(" in ");
+            if (in_pos!=std::string::npos) {
+                filename = assertion.substr(in_pos + 4);
+                assertion = assertion.substr(0, in_pos);
+                const auto at_pos = filename.rfind(" at line ");
+                if (at_pos!=std::string::npos) {
+                    const auto number = filename.substr(at_pos + 9);
+                    linenumber = is_numeric(number) ? to_number<int>(number) : -1;
+                    filename = filename.substr(0, at_pos);
+                }
+            }
+        } else if (line.compare(0, 12, "calledwith: ")==0) {
+            callsite = line.substr(12);
+        }
+    }
+}
+
+testresults
+make_totals(const xmltag& tag)
+{
+    testresults totals;
+    totals.n_skipped = get_number<long>(tag, "skipped", 0);
+    totals.n_tests = get_number<long>(tag, "tests", 0) - totals.n_skipped;
+    totals.n_errors = get_number<long>(tag, "errors", 0);
+    totals.n_failures = get_number<long>(tag, "failures", 0);
+    totals.n_timeouts = get_number<long>(tag, "timeouts", 0);
+    totals.n_successes = totals.n_tests - totals.n_errors - totals.n_failures;
+    totals.successful = totals.n_tests==totals.n_successes;
+    totals.duration = get_number<double>(tag, "time", 0);
+    return totals;
+}
+
+class xmlsource : public resultsource {
+public:
+
+    explicit
+    xmlsource(const std::string& filename)
+        : stream_(filename.c_str(), std::ios::binary), info_(), entries_(), index_(0),
+          head_(), n_dropped_(0)
+    {
+        if (!stream_)
+            throw std::runtime_error(join("Cannot open XML results: ", filename));
+        info_.filename = filename;
+        bool has_testsuite = false;
+        xmltag tag;
+        std::streampos position;
+        while (read_xml_tag(stream_, tag, &position)) {
+            if (tag.is_closing)
+                continue;
+            if (tag.name=="testsuite" && !has_testsuite) {
+                has_testsuite = true;
+                info_.suite_name = get_attribute(tag, "name");
+                info_.time_point = parse_iso_timestamp(get_attribute(tag, "timestamp"));
+                info_.shuffle_seed = get_number<long long>(tag, "shuffseed", -1);
+                info_.shard_index = get_number<int>(tag, "shard", 0);
+                info_.shard_count = get_number<int>(tag, "shards", 1);
+                info_.totals = make_totals(tag);
+            } else if (tag.name=="testcase") {
+                entries_.push_back(entry{get_attribute(tag, "classname"), get_attribute(tag, "name"), position});
+            }
+        }
+        if (!has_testsuite)
+            throw std::runtime_error(join("Not an XML results file: ", filename));
+        std::stable_sort(entries_.begin(), entries_.end(), [](const entry& first, const entry& second) {
+            return first.class_name!=second.class_name ? first.class_name < second.class_name : first.test_name < second.test_name;
+        });
+    }
+
+    const shardinfo&
+    info() const
+    {
+        return info_;
+    }
+
+    bool
+    advance()
+    {
+        if (index_ >= entries_.size())
+            return false;
+        // earlier runs of the same test precede the last one as the sorting is stable
+        while (index_ + 1 < entries_.size() && entries_[index_].class_name==entries_[index_ + 1].class_name &&
+               entries_[index_].test_name==entries_[index_ + 1].test_name) {
+            ++index_;
+            ++n_dropped_;
+        }
+        read_entry(entries_[index_++], head_);
+        return true;
+    }
+
+    const testlog&
+    head() const
+    {
+        return head_;
+    }
+
+    void
+    read(testlog& log)
+    {
+        log = std::move(head_);
+    }
+
+    long
+    n_dropped() const
+    {
+        return n_dropped_;
+    }
+
+private:
+
+    struct entry {
+        std::string class_name;
+        std::string test_name;
+        std::streampos position;
+    };
+
+    void
+    read_entry(const entry& item,
+               testlog& log)
+    {
+        stream_.clear();
+        stream_.seekg(item.position);
+        xmltag tag;
+        if (!read_xml_tag(stream_, tag) || tag.name!="testcase")
+            throw std::runtime_error(join("Corrupt XML results: ", info_.filename));
+        log = testlog();
+        log.class_name = get_attribute(tag, "classname");
+        log.test_name = get_attribute(tag, "name");
+        log.assertion = get_attribute(tag, "assertions");
+        log.filename = get_attribute(tag, "file");
+        log.linenumber = get_number<int>(tag, "line", -1);
+        log.duration = get_number<double>(tag, "time", 0);
+        log.has_timed_out = tag.attributes.count("timeout") > 0;
+        log.timeout = get_number<double>(tag, "timeout", -1);
+        if (tag.attributes.count("usertime")) {
+            log.resources.measured = true;
+            log.resources.user_time = get_number<double>(tag, "usertime", 0);
+            log.resources.system_time = get_number<double>(tag, "systime", 0);
+            log.resources.max_rss = get_number<long long>(tag, "maxrss", 0);
+            log.resources.minor_faults = get_number<long long>(tag, "minflt", 0);
+            log.resources.major_faults = get_number<long long>(tag, "majflt", 0);
+            log.resources.voluntary_switches = get_number<long long>(tag, "nvcsw", 0);
+            log.resources.involuntary_switches = get_number<long long>(tag, "nivcsw", 0);
+            log.resources.read_bytes = get_number<long long>(tag, "rchar", 0);
+            log.resources.write_bytes = get_number<long long>(tag, "wchar", 0);
+        }
+        const char* counters[] = {"instructions", "cycles", "cache_misses", "branch_misses", "tlb_misses"};
+        long long* counts[] = {&log.counters.instructions, &log.counters.cycles, &log.counters.cache_misses,
+                               &log.counters.branch_misses, &log.counters.tlb_misses};
+        for (size_t i=0; i<5; ++i) {
+            if (tag.attributes.count(counters[i])) {
+                log.counters.measured = true;
+                *counts[i] = get_number<long long>(tag, counters[i], -1);
+            }
+        }
+        if (tag.attributes.count("allocs")) {
+            log.allocations.measured = true;
+            log.allocations.count = get_number<long long>(tag, "allocs", 0);
+            log.allocations.bytes = get_number<long long>(tag, "alloc_bytes", 0);
+            log.allocations.peak_bytes = get_number<long long>(tag, "peak_bytes", 0);
+            log.allocations.live_bytes = get_number<long long>(tag, "live_bytes", 0);
+        }
+        if (tag.attributes.count("bench_mean")) {
+            log.benchmark.measured = true;
+            log.benchmark.iterations = get_number<long long>(tag, "bench_iterations", 0);
+            log.benchmark.mean = get_number<double>(tag, "bench_mean", 0);
+            log.benchmark.median = get_number<double>(tag, "bench_median", 0);
+            log.benchmark.stddev = get_number<double>(tag, "bench_stddev", 0);
+            log.benchmark.min = get_number<double>(tag, "bench_min", 0);
+            log.benchmark.throughput = get_number<double>(tag, "bench_throughput", 0);
+            log.benchmark.bytes_per_second = get_number<double>(tag, "bench_bytes_per_second", 0);
+            std::istringstream samples(get_attribute(tag, "bench_samples"));
+            double sample;
+            while (samples >> sample)
+                log.benchmark.samples.push_back(sample);
+        }
+        if (tag.attributes.count("baseline_ratio")) {
+            log.baseline.compared = true;
+            log.baseline.baseline_median = get_number<double>(tag, "baseline_median", 0);
+            log.baseline.ratio = get_number<double>(tag, "baseline_ratio", 0);
+            log.baseline.p_value = get_number<double>(tag, "baseline_p", 1);
+            log.baseline.regressed = get_attribute(tag, "baseline_regressed")=="true";
+        }
+        if (tag.attributes.count("sweep_complexity")) {
+            log.sweep.measured = true;
+            complexity_from_name(get_attribute(tag, "sweep_complexity"), log.sweep.best_fit);
+            log.sweep.coefficient = get_number<double>(tag, "sweep_coefficient", 0);
+            log.sweep.rms = get_number<double>(tag, "sweep_rms", 0);
+            std::istringstream ranges(get_attribute(tag, "sweep_ranges"));
+            std::istringstream times(get_attribute(tag, "sweep_times"));
+            long long range;
+            double time;
+            while (ranges >> range && times >> time) {
+                log.sweep.ranges.push_back(range);
+                log.sweep.times.push_back(time);
+            }
+        }
+        log.status = teststatus::success;
+        log.successful = true;
+        if (tag.is_empty)
+            return;
+        std::string type, message;
+        while (read_xml_tag(stream_, tag)) {
+            if (tag.is_closing && tag.name=="testcase") {
+                break;
+            } else if (tag.name=="skipped") {
+                log.status = teststatus::skipped;
+            } else if ((tag.name=="failure" || tag.name=="error") && !tag.is_closing) {
+                type = get_attribute(tag, "type");
+                message = get_attribute(tag, "message");
+                if (tag.is_empty)
+                    add_failure(log, tag.name, type, message, "");
+            } else if ((tag.name=="failure" || tag.name=="error") && tag.is_closing) {
+                add_failure(log, tag.name, type, message, tag.text);
+            } else if (tag.name=="system-out" && tag.is_closing) {
+                log.text = trim(tag.text);
+            }
+        }
+    }
+
+    static void
+    add_failure(testlog& log,
+                const std::string& name,
+                const std::string& type,
+                const std::string& message,
+                const std::string& text)
+    {
+        log.successful = false;
+        if (log.status==teststatus::success)
+            log.status = teststatus::failure;
+        if (type=="testfailure (non-deadly)") {
+            std::string assertion, filename, callsite;
+            int linenumber = -1;
+            parse_failure_info(text, assertion, filename, linenumber, callsite);
+            log.nd_failures.push_back(testfailure(assertion, message, filename, linenumber, callsite));
+        } else {
+            log.error_type = type;
+            log.message = message;
+            log.status = name=="failure" ? teststatus::failure : teststatus::error;
+            std::string assertion, filename;
+            int linenumber = -1;
+            parse_failure_info(text, assertion, filename, linenumber, log.callsite);
+        }
+    }
+
+    std::ifstream stream_;
+    shardinfo info_;
+    std::vector<entry> entries_;
+    size_t index_;
+    testlog head_;
+    long n_dropped_;
+};
+
+class binsource : public resultsource {
+public:
+
+    explicit
+    binsource(const std::string& filename)
+        : reader_(filename), info_(), indices_(reader_.sorted_by_name()), index_(0),
+          current_(0), head_(), n_dropped_(0)
+    {
+        info_.filename = filename;
+        info_.suite_name = reader_.suite_name();
+        info_.shuffle_seed = reader_.shuffle_seed();
+        info_.shard_index = reader_.shard_index();
+        info_.shard_count = reader_.shard_count();
+        info_.time_point = reader_.time_point();
+        info_.totals = reader_.totals();
+    }
+
+    const shardinfo&
+    info() const
+    {
+        return info_;
+    }
+
+    bool
+    advance()
+    {
+        if (index_ >= indices_.size())
+            return false;
+        // earlier runs of the same test precede the last one as the sorting is stable
+        while (index_ + 1 < indices_.size() && reader_.is_same_name(indices_[index_], indices_[index_ + 1])) {
+            ++index_;
+            ++n_dropped_;
+        }
+        current_ = indices_[index_++];
+        reader_.peek(current_, head_);
+        return true;
+    }
+
+    const testlog&
+    head() const
+    {
+        return head_;
+    }
+
+    void
+    read(testlog& log)
+    {
+        log = reader_.log(current_);
+    }
+
+    bool
+    copy(binwriter& writer)
+    {
+        writer.append(reader_, current_);
+        return true;
+    }
+
+    long
+    n_dropped() const
+    {
+        return n_dropped_;
+    }
+
+private:
+    binreader reader_;
+    shardinfo info_;
+    std::vector<size_t> indices_;
+    size_t index_;
+    size_t current_;
+    testlog head_;
+    long n_dropped_;
+};
+
+bool
+is_name_less(const testlog& first,
+             const testlog& second)
+{
+    return first.class_name!=second.class_name ? first.class_name < second.class_name : first.test_name < second.test_name;
+}
+
+}
+
+shardinfo::shardinfo()
+    : filename(""), suite_name(""), shuffle_seed(-1), shard_index(0),
+      shard_count(1), time_point(), totals()
+{}
+
+bool
+resultsource::copy(binwriter&)
+{
+    return false;
+}
+
+std::unique_ptr<resultsource>
+open_resultsource(const std::string& filename)
+{
+    if (is_binresults(filename))
+        return std::unique_ptr<resultsource>(new binsource(filename));
+    return std::unique_ptr<resultsource>(new xmlsource(filename));
+}
+
+struct resultmerger::impl {
+
+    std::vector<std::unique_ptr<resultsource>> sources_;
+    std::vector<shardinfo> shards_;
+    std::vector<size_t> heap_;
+    long n_retried_;
+    testresults totals_;
+
+    explicit
+    impl(std::vector<std::unique_ptr<resultsource>> sources)
+        : sources_(std::move(sources)), shards_(),
+          heap_(), n_retried_(0), totals_()
+    {
+        totals_.successful = true;
+        for (size_t i=0; i<sources_.size(); ++i) {
+            shards_.push_back(sources_[i]->info());
+            totals_.duration = std::max(totals_.duration, shards_.back().totals.duration);
+            advance(i);
+        }
+    }
+
+    bool
+    is_later(size_t first,
+             size_t second) const
+    {
+        const auto& first_head = sources_[first]->head();
+        const auto& second_head = sources_[second]->head();
+        if (is_name_less(second_head, first_head))
+            return true;
+        if (is_name_less(first_head, second_head))
+            return false;
+        return first > second;
+    }
+
+    void
+    advance(size_t source)
+    {
+        if (!sources_[source]->advance())
+            return;
+        heap_.push_back(source);
+        std::push_heap(heap_.begin(), heap_.end(), [this](size_t first, size_t second) { return is_later(first, second); });
+    }
+
+    size_t
+    pop()
+    {
+        std::pop_heap(heap_.begin(), heap_.end(), [this](size_t first, size_t second) { return is_later(first, second); });
+        const auto source = heap_.back();
+        heap_.pop_back();
+        return source;
+    }
+
+    // pops the source holding the next merged test log, i.e. the last run
+    // of its test, and counts it
+    size_t
+    select()
+    {
+        auto source = pop();
+        while (!heap_.empty() && !is_name_less(sources_[source]->head(), sources_[heap_.front()]->head())) {
+            advance(source);
+            source = pop();
+            ++n_retried_;
+        }
+        count(sources_[source]->head());
+        return source;
+    }
+
+    void
+    count(const testlog& log)
+    {
+        if (log.status!=teststatus::skipped)
+            ++totals_.n_tests;
+        if (log.has_timed_out)
+            ++totals_.n_timeouts;
+        switch (log.status) {
+        case teststatus::success: ++totals_.n_successes; break;
+        case teststatus::failure: ++totals_.n_failures; break;
+        case teststatus::error: ++totals_.n_errors; break;
+        default: ++totals_.n_skipped; break;
+        }
+        totals_.successful = totals_.n_tests==totals_.n_successes;
+    }
+
+};
+
+resultmerger::resultmerger(std::vector<std::unique_ptr<resultsource>> sources)
+    : impl_(unittest::core::make_unique<impl>(std::move(sources)))
+{}
+
+resultmerger::~resultmerger()
+{}
+
+bool
+resultmerger::next(testlog& log)
+{
+    if (impl_->heap_.empty())
+        return false;
+    const auto source = impl_->select();
+    impl_->sources_[source]->read(log);
+    impl_->advance(source);
+    return true;
+}
+
+bool
+resultmerger::next(binwriter& writer)
+{
+    if (impl_->heap_.empty())
+        return false;
+    const auto source = impl_->select();
+    if (!impl_->sources_[source]->copy(writer)) {
+        testlog log;
+        impl_->sources_[source]->read(log);
+        writer.report(log);
+    }
+    impl_->advance(source);
+    return true;
+}
+
+bool
+resultmerger::skip()
+{
+    if (impl_->heap_.empty())
+        return false;
+    impl_->advance(impl_->select());
+    return true;
+}
+
+const std::vector<shardinfo>&
+resultmerger::shards() const
+{
+    return impl_->shards_;
+}
+
+long
+resultmerger::n_retried() const
+{
+    long n_retried = impl_->n_retried_;
+    for (const auto& source : impl_->sources_)
+        n_retried += source->n_dropped();
+    return n_retried;
+}
+
+testresults
+resultmerger::totals() const
+{
+    return impl_->totals_;
+}
+
+testresults
+merge_results(const std::vector<std::string>& filenames,
+              std::vector<shardinfo>* shards)
+{
+    std::vector<std::unique_ptr<resultsource>> sources;
+    for (const auto& filename : filenames)
+        sources.push_back(open_resultsource(filename));
+    resultmerger merger(std::move(sources));
+    std::vector<testlog> testlogs;
+    testlog log;
+    while (merger.next(log))
+        testlogs.push_back(std::move(log));
+    auto results = merger.totals();
+    results.testlogs = std::move(testlogs);
+    if (shards)
+        *shards = merger.shards();
+    return results;
+}
+
+std::vector<std::pair<std::string, std::string>>
+make_shard_properties(const std::vector<shardinfo>& shards)
+{
+    std::vector<std::pair<std::string, std::string>> properties;
+    for (size_t i=0; i<shards.size(); ++i) {
+        const auto& shard = shards[i];
+        const auto prefix = join("shard.", i, ".");
+        properties.push_back(std::make_pair(prefix + "file", shard.filename));
+        properties.push_back(std::make_pair(prefix + "suite", shard.suite_name));
+        if (shard.shuffle_seed >= 0)
+            properties.push_back(std::make_pair(prefix + "shuffseed", join(shard.shuffle_seed)));
+        if (shard.shard_count > 1)
+            properties.push_back(std::make_pair(prefix + "shard", join(shard.shard_index, "/", shard.shard_count)));
+        properties.push_back(std::make_pair(prefix + "tests", join(shard.totals.n_tests + shard.totals.n_skipped)));
+    }
+    return properties;
+}
+
+} // core
+} // unittest
@@ -0,0 +1,77 @@
+#include "libunittest/sharding.hpp"
+#include <algorithm>
+#include <numeric>
+#include <cstdint>
+
+namespace unittest {
+namespace core {
+
+int
+hash_shard(const std::string& class_name,
+           int shard_count)
+{
+    std::uint64_t hash = 14695981039346656037ull;
+    for (unsigned char character : class_name) {
+        hash ^= character;
+        hash *= 1099511628211ull;
+    }
+    return shard_count > 1 ? static_cast<int>(hash % static_cast<std::uint64_t>(shard_count)) : 0;
+}
+
+std::vector<int>
+balance_shards(const std::vector<std::string>& class_names,
+               const testhistory& history,
+               int shard_count,
+               double default_estimate)
+{
+    std::vector<int> shards(class_names.size(), 0);
+    if (shard_count < 2)
+        return shards;
+    std::vector<double> estimates(class_names.size(), default_estimate);
+    for (size_t i=0; i<class_names.size(); ++i) {
+        const double expected = history.expected_class_duration(class_names[i]);
+        if (expected >= 0)
+            estimates[i] = expected;
+    }
+    std::vector<size_t> order(class_names.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+        [&](size_t first, size_t second) {
+            if (estimates[first]!=estimates[second])
+                return estimates[first] > estimates[second];
+            return class_names[first] < class_names[second];
+        });
+    std::vector<double> loads(shard_count, 0.);
+    for (auto index : order) {
+        const auto lightest = std::min_element(loads.begin(), loads.end());
+        *lightest += estimates[index];
+        shards[index] = static_cast<int>(lightest - loads.begin());
+    }
+    return shards;
+}
+
+void
+select_shard(std::vector<size_t>& schedule,
+             const std::vector<std::string>& class_names,
+             const testhistory& history,
+             int shard_index,
+             int shard_count,
+             bool balanced,
+             double default_estimate)
+{
+    if (shard_count < 2)
+        return;
+    std::vector<int> shards;
+    if (balanced) {
+        shards = balance_shards(class_names, history, shard_count, default_estimate);
+    } else {
+        for (const auto& class_name : class_names)
+            shards.push_back(hash_shard(class_name, shard_count));
+    }
+    schedule.erase(std::remove_if(schedule.begin(), schedule.end(),
+                                  [&](size_t index) { return shards[index]!=shard_index; }),
+                   schedule.end());
+}
+
+} // core
+} // unittest
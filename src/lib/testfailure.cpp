@@ -1,5 +1,6 @@
 #include "libunittest/testfailure.hpp"
 #include "libunittest/utilities.hpp"
+#include "libunittest/failuresink.hpp"
 
 
 namespace unittest {
@@ -23,6 +24,18 @@ testfailure::testfailure(const std::string& assertion,
       callsite_(core::extract_tagged_text(user_msg, "CALL"))
 {}
 
+testfailure::testfailure(const std::string& assertion,
+                         const std::string& message,
+                         const std::string& filename,
+                         int linenumber,
+                         const std::string& callsite)
+    : std::runtime_error(message),
+      error_msg_(message),
+      assertion_(assertion),
+      spot_(std::make_pair(filename, linenumber)),
+      callsite_(callsite)
+{}
+
 testfailure::testfailure(const testfailure& other)
     : std::runtime_error(other.error_msg_),
       error_msg_(other.error_msg_),
@@ -81,17 +94,65 @@ testfailure::callsite() const
 
 namespace core {
 
+failureinfo::failureinfo()
+    : filename(nullptr), linenumber(-1), callsite(nullptr),
+      is_non_deadly(false), sink(nullptr), usermsg()
+{}
+
+void
+add_failure_arg(failureinfo& info,
+                const sourcespot& spot)
+{
+    info.filename = spot.filename;
+    info.linenumber = spot.linenumber;
+}
+
+void
+add_failure_arg(failureinfo& info,
+                const sourcecall& call)
+{
+    info.callsite = call.text;
+}
+
+void
+add_failure_arg(failureinfo& info,
+                const ndastag& tag)
+{
+    info.is_non_deadly = true;
+    info.sink = tag.sink.get();
+}
+
 void
 fail_impl(const std::string& assertion,
           const std::string& message,
-          std::string usermsg)
+          const failureinfo& info)
 {
-    const auto ndas_test_id = unittest::core::extract_tagged_text(usermsg, "NDAS");
-    const unittest::testfailure failure(assertion, message, usermsg);
-    if (ndas_test_id.empty()) {
-        throw failure;
+    auto usermsg = info.usermsg.str();
+    std::string filename = info.filename ? info.filename : "";
+    int linenumber = info.linenumber;
+    std::string callsite = info.callsite ? info.callsite : "";
+    bool is_non_deadly = info.is_non_deadly;
+    if (usermsg.find('@')!=std::string::npos) {
+        if (filename.empty()) {
+            const auto spot = extract_file_and_line(usermsg);
+            filename = spot.first;
+            linenumber = spot.second;
+        }
+        if (callsite.empty())
+            callsite = extract_tagged_text(usermsg, "CALL");
+        if (usermsg.find("@NDAS@")!=std::string::npos)
+            is_non_deadly = true;
+        usermsg = remove_tagged_text(usermsg, "SPOT");
+        usermsg = remove_tagged_text(usermsg, "NDAS");
+        usermsg = remove_tagged_text(usermsg, "CALL");
+    }
+    const auto text = usermsg.size() ? message + " - " + usermsg : message;
+    const unittest::testfailure failure(assertion, text, filename, linenumber, callsite);
+    auto sink = info.sink ? info.sink : failuresink::current();
+    if (is_non_deadly && sink) {
+        sink->push(failure);
     } else {
-        unittest::core::testsuite::instance()->log_failure(ndas_test_id, failure);
+        throw failure;
     }
 }
 
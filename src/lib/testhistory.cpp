@@ -0,0 +1,499 @@
+#include "libunittest/testhistory.hpp"
+#include "libunittest/utilities.hpp"
+#include <unordered_map>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+#ifndef _MSC_VER
+#include <sys/file.h>
+#include <sys/stat.h>
+#endif
+
+namespace unittest {
+namespace core {
+
+namespace {
+
+const std::string g_history_header = "# libunittest history 1";
+
+const double g_average_weight = 0.3;
+
+const unsigned int g_max_sketch_count = 1024;
+
+int
+bucket_of(double duration)
+{
+    const double micros = duration * 1e6;
+    if (!(micros > 1))
+        return 0;
+    const int index = static_cast<int>(std::ceil(2 * std::log2(micros)));
+    return index < testrecord::n_buckets ? index : testrecord::n_buckets - 1;
+}
+
+class lineparser {
+public:
+
+    explicit
+    lineparser(char* line)
+        : cursor_(line), good_(true)
+    {}
+
+    std::string
+    next_string()
+    {
+        const char* begin = next_field();
+        return good_ ? std::string(begin) : std::string();
+    }
+
+    long
+    next_long()
+    {
+        const char* begin = next_field();
+        char* end = nullptr;
+        const long value = good_ ? std::strtol(begin, &end, 10) : 0;
+        if (end==begin) good_ = false;
+        return value;
+    }
+
+    double
+    next_double()
+    {
+        const char* begin = next_field();
+        char* end = nullptr;
+        const double value = good_ ? std::strtod(begin, &end) : 0;
+        if (end==begin) good_ = false;
+        return value;
+    }
+
+    bool
+    good() const
+    {
+        return good_;
+    }
+
+private:
+
+    const char*
+    next_field()
+    {
+        if (!cursor_) {
+            good_ = false;
+            return "";
+        }
+        char* begin = cursor_;
+        char* tab = begin;
+        while (*tab && *tab!='\t') ++tab;
+        if (*tab) {
+            *tab = '\0';
+            cursor_ = tab + 1;
+        } else {
+            cursor_ = nullptr;
+        }
+        return begin;
+    }
+
+    char* cursor_;
+    bool good_;
+};
+
+void
+parse_sketch(const std::string& value,
+             testrecord& record)
+{
+    std::istringstream stream(value);
+    std::string token;
+    while (std::getline(stream, token, ',')) {
+        const auto separator = token.find(':');
+        if (separator==std::string::npos)
+            continue;
+        const long index = std::strtol(token.substr(0, separator).c_str(), nullptr, 10);
+        const long count = std::strtol(token.substr(separator + 1).c_str(), nullptr, 10);
+        if (index>=0 && index<testrecord::n_buckets && count>0)
+            record.sketch[index] = static_cast<unsigned int>(count);
+    }
+}
+
+void
+write_snapshot(std::ostream& stream,
+               const std::string& name,
+               const testrecord& record)
+{
+    stream << "S\t" << name << "\t" << record.n_runs << "\t" << record.n_successes;
+    stream << "\t" << record.n_failures << "\t" << record.n_errors << "\t" << record.n_timeouts;
+    stream << "\t" << record.average << "\t" << record.last << "\t";
+    bool first = true;
+    for (int i=0; i<testrecord::n_buckets; ++i) {
+        if (record.sketch[i]) {
+            if (!first) stream << ",";
+            stream << i << ":" << record.sketch[i];
+            first = false;
+        }
+    }
+    if (first) stream << "-";
+    stream << "\t" << record.class_name << "\n";
+}
+
+std::string
+read_file(const std::string& filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+// the history file opened for appending and locked against other shards
+// until destruction. Reopens the file if a compaction replaced it while
+// waiting for the lock
+class historyfile {
+public:
+
+    explicit
+    historyfile(const std::string& filename)
+        : file_(nullptr), is_locked_(false)
+    {
+        for (int attempt=0; attempt<8 && !is_locked_; ++attempt) {
+            if (file_)
+                std::fclose(file_);
+            file_ = std::fopen(filename.c_str(), "ab");
+            if (!file_)
+                return;
+            std::setvbuf(file_, nullptr, _IONBF, 0);
+#ifndef _MSC_VER
+            if (::flock(::fileno(file_), LOCK_EX)!=0)
+                return;
+            struct stat opened, current;
+            is_locked_ = ::fstat(::fileno(file_), &opened)==0 && ::stat(filename.c_str(), &current)==0 &&
+                         opened.st_dev==current.st_dev && opened.st_ino==current.st_ino;
+#else
+            return;
+#endif
+        }
+    }
+
+    ~historyfile()
+    {
+        if (file_)
+            std::fclose(file_);
+    }
+
+    historyfile(const historyfile&) = delete;
+
+    historyfile&
+    operator=(const historyfile&) = delete;
+
+    std::FILE*
+    get() const
+    {
+        return file_;
+    }
+
+    bool
+    is_locked() const
+    {
+        return is_locked_;
+    }
+
+    long long
+    size() const
+    {
+        if (!file_ || std::fseek(file_, 0, SEEK_END)!=0)
+            return -1;
+        return std::ftell(file_);
+    }
+
+private:
+    std::FILE* file_;
+    bool is_locked_;
+};
+
+}
+
+testrecord::testrecord()
+    : class_name(), n_runs(0), n_successes(0), n_failures(0), n_errors(0),
+      n_timeouts(0), average(0), last(0), sketch()
+{
+    sketch.fill(0);
+}
+
+void
+testrecord::add(double duration,
+                teststatus status,
+                bool has_timed_out)
+{
+    if (status==teststatus::skipped)
+        return;
+    average = n_runs ? g_average_weight * duration + (1 - g_average_weight) * average : duration;
+    last = duration;
+    ++n_runs;
+    switch (status) {
+    case teststatus::success: ++n_successes; break;
+    case teststatus::failure: ++n_failures; break;
+    case teststatus::error: ++n_errors; break;
+    default: break;
+    }
+    if (has_timed_out)
+        ++n_timeouts;
+    unsigned int total = 0;
+    for (auto count : sketch)
+        total += count;
+    if (total >= g_max_sketch_count) {
+        for (auto& count : sketch)
+            count = (count + 1) / 2;
+    }
+    ++sketch[bucket_of(duration)];
+}
+
+double
+testrecord::percentile(double fraction) const
+{
+    unsigned int total = 0;
+    for (auto count : sketch)
+        total += count;
+    if (total==0)
+        return 0;
+    const double target = fraction * total;
+    unsigned int cumulative = 0;
+    int index = 0;
+    for (; index<n_buckets; ++index) {
+        cumulative += sketch[index];
+        if (sketch[index] && cumulative >= target)
+            break;
+    }
+    if (index==n_buckets)
+        --index;
+    return std::pow(2., index / 2.) * 1e-6;
+}
+
+struct testhistory::impl {
+
+    std::unordered_map<std::string, testrecord> records_;
+    std::unordered_map<std::string, double> class_durations_;
+    std::ostringstream pending_;
+    long n_pending_;
+    long n_events_;
+    long long loaded_size_;
+
+    impl()
+        : records_(), class_durations_(), pending_(), n_pending_(0),
+          n_events_(0), loaded_size_(-1)
+    {
+        pending_ << std::setprecision(9);
+    }
+
+    // keeps the class durations up to date with every change of a record
+    void
+    add_run(const std::string& name,
+            const std::string& class_name,
+            double duration,
+            teststatus status,
+            bool has_timed_out)
+    {
+        auto& record = records_[name];
+        add_duration(record, -1);
+        record.class_name = class_name;
+        record.add(duration, status, has_timed_out);
+        add_duration(record, 1);
+    }
+
+    void
+    replace(const std::string& name,
+            const testrecord& record)
+    {
+        auto& element = records_[name];
+        add_duration(element, -1);
+        element = record;
+        add_duration(element, 1);
+    }
+
+    void
+    add_duration(const testrecord& record,
+                 double sign)
+    {
+        if (record.n_runs)
+            class_durations_[record.class_name] += sign * record.average;
+    }
+
+    void
+    parse_content(std::string& content)
+    {
+        size_t begin = 0;
+        while (begin < content.size()) {
+            size_t end = content.find('\n', begin);
+            if (end==std::string::npos)
+                break;
+            content[end] = '\0';
+            parse_line(&content[begin]);
+            begin = end + 1;
+        }
+    }
+
+    void
+    parse_line(char* line)
+    {
+        if (line[0]=='E' && line[1]=='\t') {
+            lineparser parser(line + 2);
+            const auto name = parser.next_string();
+            const long status = parser.next_long();
+            const double duration = parser.next_double();
+            const long timed_out = parser.next_long();
+            const auto class_name = parser.next_string();
+            if (parser.good() && status>=0 && status<=3) {
+                add_run(name, class_name, duration, static_cast<teststatus>(status), timed_out!=0);
+                ++n_events_;
+            }
+        } else if (line[0]=='S' && line[1]=='\t') {
+            lineparser parser(line + 2);
+            testrecord record;
+            const auto name = parser.next_string();
+            record.n_runs = parser.next_long();
+            record.n_successes = parser.next_long();
+            record.n_failures = parser.next_long();
+            record.n_errors = parser.next_long();
+            record.n_timeouts = parser.next_long();
+            record.average = parser.next_double();
+            record.last = parser.next_double();
+            const auto sketch = parser.next_string();
+            record.class_name = parser.next_string();
+            if (parser.good()) {
+                parse_sketch(sketch, record);
+                replace(name, record);
+            }
+        }
+    }
+
+    // must hold the lock of the history file. Rebuilds the records from
+    // the file as other shards may have appended since loading
+    bool
+    compact(const std::string& filename)
+    {
+        std::string content = read_file(filename);
+        records_.clear();
+        class_durations_.clear();
+        n_events_ = 0;
+        parse_content(content);
+        std::string pending = pending_.str();
+        parse_content(pending);
+        const std::string tmp_filename = join(filename, ".tmp", now().count());
+        {
+            std::ofstream file(tmp_filename, std::ios::binary);
+            if (!file)
+                return false;
+            file << std::setprecision(9);
+            file << g_history_header << "\n";
+            for (const auto& pair : records_)
+                write_snapshot(file, pair.first, pair.second);
+            if (!file) {
+                std::remove(tmp_filename.c_str());
+                return false;
+            }
+        }
+        if (std::rename(tmp_filename.c_str(), filename.c_str())!=0) {
+            std::remove(tmp_filename.c_str());
+            return false;
+        }
+        n_events_ = 0;
+        return true;
+    }
+
+};
+
+testhistory::testhistory()
+    : impl_(make_unique<impl>())
+{}
+
+testhistory::~testhistory()
+{}
+
+void
+testhistory::load(const std::string& filename)
+{
+    std::string content = read_file(filename);
+    impl_->loaded_size_ = content.size();
+    impl_->parse_content(content);
+}
+
+void
+testhistory::record(const testlog& log)
+{
+    if (log.status==teststatus::skipped)
+        return;
+    const auto name = make_full_test_name(log.class_name, log.test_name);
+    impl_->add_run(name, log.class_name, log.duration, log.status, log.has_timed_out);
+    impl_->pending_ << "E\t" << name << "\t" << static_cast<unsigned int>(log.status);
+    impl_->pending_ << "\t" << log.duration << "\t" << (log.has_timed_out ? 1 : 0);
+    impl_->pending_ << "\t" << log.class_name << "\n";
+    ++impl_->n_pending_;
+}
+
+void
+testhistory::save(const std::string& filename)
+{
+    if (!impl_->n_pending_)
+        return;
+    const long n_events = impl_->n_events_ + impl_->n_pending_;
+    // the lock is held across compacting and appending so that no shard
+    // appends to a file that is being replaced. Without a lock the file
+    // is never rewritten
+    historyfile file(filename);
+    bool compacted = false;
+    if (file.is_locked() && impl_->loaded_size_ > 0 &&
+            n_events > 1024 + 4 * static_cast<long>(impl_->records_.size()))
+        compacted = impl_->compact(filename);
+    if (!compacted) {
+        std::string content = impl_->pending_.str();
+        if (file.size()==0)
+            content = g_history_header + "\n" + content;
+        if (file.get())
+            std::fwrite(content.data(), 1, content.size(), file.get());
+        impl_->n_events_ = n_events;
+    }
+    impl_->n_pending_ = 0;
+    impl_->pending_.str("");
+}
+
+const testrecord*
+testhistory::find(const std::string& full_test_name) const
+{
+    const auto element = impl_->records_.find(full_test_name);
+    return element!=impl_->records_.end() ? &element->second : nullptr;
+}
+
+double
+testhistory::expected_class_duration(const std::string& class_name) const
+{
+    const auto element = impl_->class_durations_.find(class_name);
+    return element!=impl_->class_durations_.end() ? std::max(element->second, 0.) : -1;
+}
+
+size_t
+testhistory::size() const
+{
+    return impl_->records_.size();
+}
+
+std::vector<double>
+order_longest_first(std::vector<size_t>& schedule,
+                    const std::vector<std::string>& class_names,
+                    const testhistory& history,
+                    double default_estimate)
+{
+    std::vector<double> estimates(class_names.size(), default_estimate);
+    for (auto index : schedule) {
+        const double expected = history.expected_class_duration(class_names[index]);
+        if (expected >= 0)
+            estimates[index] = expected;
+    }
+    std::stable_sort(schedule.begin(), schedule.end(),
+                     [&estimates](size_t first, size_t second) { return estimates[first] > estimates[second]; });
+    std::vector<double> ordered;
+    ordered.reserve(schedule.size());
+    for (auto index : schedule)
+        ordered.push_back(estimates[index]);
+    return ordered;
+}
+
+} // core
+} // unittest
@@ -3,17 +3,97 @@
 #include "libunittest/utilities.hpp"
 #include "libunittest/testfailure.hpp"
 #include <algorithm>
-#include <mutex>
+#include <sstream>
+#include <iomanip>
+#include <cstdlib>
 
 namespace unittest {
 namespace core {
 
+namespace {
+
+void
+write_field(std::string& data,
+            const std::string& value)
+{
+    data += std::to_string(value.size());
+    data += ':';
+    data += value;
+}
+
+void
+write_field(std::string& data,
+            long value)
+{
+    write_field(data, std::to_string(value));
+}
+
+void
+write_field(std::string& data,
+            double value)
+{
+    std::ostringstream stream;
+    stream << std::setprecision(17) << value;
+    write_field(data, stream.str());
+}
+
+class fieldreader {
+public:
+
+    explicit
+    fieldreader(const std::string& data)
+        : data_(data), position_(0), good_(true)
+    {}
+
+    std::string
+    next_string()
+    {
+        const size_t separator = data_.find(':', position_);
+        if (!good_ || separator==std::string::npos) {
+            good_ = false;
+            return "";
+        }
+        const size_t size = std::strtoul(data_.c_str() + position_, nullptr, 10);
+        if (separator + 1 + size > data_.size()) {
+            good_ = false;
+            return "";
+        }
+        position_ = separator + 1 + size;
+        return data_.substr(separator + 1, size);
+    }
+
+    long
+    next_long()
+    {
+        return std::strtol(next_string().c_str(), nullptr, 10);
+    }
+
+    double
+    next_double()
+    {
+        return std::strtod(next_string().c_str(), nullptr);
+    }
+
+    bool
+    good() const
+    {
+        return good_;
+    }
+
+private:
+    const std::string& data_;
+    size_t position_;
+    bool good_;
+};
+
+}
+
 testlog::testlog()
     : class_name(""), test_name(""), successful(true),
       status(teststatus::skipped), error_type(""), message(""),
       duration(0), has_timed_out(false), timeout(-1), assertion(""),
       method_id(""), text(""), filename(""), linenumber(-1),
-      callsite(""), nd_failures()
+      callsite(""), sequence(-1), resources(), counters(), allocations(), benchmark(), baseline(), sweep(), nd_failures()
 {}
 
 void
@@ -21,12 +101,8 @@ write_test_start_message(std::ostream& stream,
                          const testlog& log,
                          bool verbose)
 {
-    static std::mutex write_test_start_message_mutex_;
-    std::lock_guard<std::mutex> lock(write_test_start_message_mutex_);
-    if (verbose) {
+    if (verbose)
         stream << make_full_test_name(log.class_name, log.test_name) << " ... ";
-        stream << std::flush;
-    }
 }
 
 void
@@ -34,8 +110,6 @@ write_test_end_message(std::ostream& stream,
                        const testlog& log,
                        bool verbose)
 {
-    static std::mutex write_test_end_message_mutex_;
-    std::lock_guard<std::mutex> lock(write_test_end_message_mutex_);
     if (!log.has_timed_out) {
         if (verbose) {
             stream << "[" << log.duration << "s] ";
@@ -56,7 +130,6 @@ write_test_end_message(std::ostream& stream,
             default: break;
             }
         }
-        stream << std::flush;
     }
 }
 
@@ -64,10 +137,167 @@ void
 write_test_timeout_message(std::ostream& stream,
                            bool verbose)
 {
-    static std::mutex write_test_timeout_message_mutex_;
-    std::lock_guard<std::mutex> lock(write_test_timeout_message_mutex_);
-    const std::string message = verbose ? "TIMEOUT\n" : "T";
-    stream << message << std::flush;
+    stream << (verbose ? "TIMEOUT\n" : "T");
+}
+
+std::string
+serialize_testlog(const testlog& log)
+{
+    std::string data;
+    write_field(data, log.class_name);
+    write_field(data, log.test_name);
+    write_field(data, static_cast<long>(log.successful));
+    write_field(data, static_cast<long>(log.status));
+    write_field(data, log.error_type);
+    write_field(data, log.message);
+    write_field(data, log.duration);
+    write_field(data, static_cast<long>(log.has_timed_out));
+    write_field(data, log.timeout);
+    write_field(data, log.assertion);
+    write_field(data, log.method_id);
+    write_field(data, log.text);
+    write_field(data, log.filename);
+    write_field(data, static_cast<long>(log.linenumber));
+    write_field(data, log.callsite);
+    write_field(data, log.sequence);
+    write_field(data, static_cast<long>(log.resources.measured));
+    write_field(data, log.resources.user_time);
+    write_field(data, log.resources.system_time);
+    write_field(data, static_cast<long>(log.resources.max_rss));
+    write_field(data, static_cast<long>(log.resources.minor_faults));
+    write_field(data, static_cast<long>(log.resources.major_faults));
+    write_field(data, static_cast<long>(log.resources.voluntary_switches));
+    write_field(data, static_cast<long>(log.resources.involuntary_switches));
+    write_field(data, static_cast<long>(log.resources.read_bytes));
+    write_field(data, static_cast<long>(log.resources.write_bytes));
+    write_field(data, static_cast<long>(log.counters.measured));
+    write_field(data, static_cast<long>(log.counters.instructions));
+    write_field(data, static_cast<long>(log.counters.cycles));
+    write_field(data, static_cast<long>(log.counters.cache_misses));
+    write_field(data, static_cast<long>(log.counters.branch_misses));
+    write_field(data, static_cast<long>(log.counters.tlb_misses));
+    write_field(data, static_cast<long>(log.allocations.measured));
+    write_field(data, static_cast<long>(log.allocations.count));
+    write_field(data, static_cast<long>(log.allocations.bytes));
+    write_field(data, static_cast<long>(log.allocations.peak_bytes));
+    write_field(data, static_cast<long>(log.allocations.live_bytes));
+    write_field(data, static_cast<long>(log.benchmark.measured));
+    write_field(data, static_cast<long>(log.benchmark.iterations));
+    write_field(data, log.benchmark.mean);
+    write_field(data, log.benchmark.median);
+    write_field(data, log.benchmark.stddev);
+    write_field(data, log.benchmark.min);
+    write_field(data, log.benchmark.throughput);
+    write_field(data, log.benchmark.bytes_per_second);
+    write_field(data, static_cast<long>(log.benchmark.samples.size()));
+    for (auto sample : log.benchmark.samples)
+        write_field(data, sample);
+    write_field(data, static_cast<long>(log.baseline.compared));
+    write_field(data, log.baseline.baseline_median);
+    write_field(data, log.baseline.ratio);
+    write_field(data, log.baseline.p_value);
+    write_field(data, static_cast<long>(log.baseline.regressed));
+    write_field(data, static_cast<long>(log.sweep.measured));
+    write_field(data, static_cast<long>(log.sweep.best_fit));
+    write_field(data, log.sweep.coefficient);
+    write_field(data, log.sweep.rms);
+    write_field(data, static_cast<long>(log.sweep.ranges.size()));
+    for (size_t i=0; i<log.sweep.ranges.size(); ++i) {
+        write_field(data, static_cast<long>(log.sweep.ranges[i]));
+        write_field(data, log.sweep.times[i]);
+    }
+    write_field(data, static_cast<long>(log.nd_failures.size()));
+    for (const auto& failure : log.nd_failures) {
+        write_field(data, failure.assertion());
+        write_field(data, std::string(failure.what()));
+        write_field(data, failure.filename());
+        write_field(data, static_cast<long>(failure.linenumber()));
+        write_field(data, failure.callsite());
+    }
+    return data;
+}
+
+bool
+deserialize_testlog(const std::string& data,
+                    testlog& log)
+{
+    fieldreader reader(data);
+    log.class_name = reader.next_string();
+    log.test_name = reader.next_string();
+    log.successful = reader.next_long()!=0;
+    log.status = static_cast<teststatus>(reader.next_long());
+    log.error_type = reader.next_string();
+    log.message = reader.next_string();
+    log.duration = reader.next_double();
+    log.has_timed_out = reader.next_long()!=0;
+    log.timeout = reader.next_double();
+    log.assertion = reader.next_string();
+    log.method_id = reader.next_string();
+    log.text = reader.next_string();
+    log.filename = reader.next_string();
+    log.linenumber = static_cast<int>(reader.next_long());
+    log.callsite = reader.next_string();
+    log.sequence = reader.next_long();
+    log.resources.measured = reader.next_long()!=0;
+    log.resources.user_time = reader.next_double();
+    log.resources.system_time = reader.next_double();
+    log.resources.max_rss = reader.next_long();
+    log.resources.minor_faults = reader.next_long();
+    log.resources.major_faults = reader.next_long();
+    log.resources.voluntary_switches = reader.next_long();
+    log.resources.involuntary_switches = reader.next_long();
+    log.resources.read_bytes = reader.next_long();
+    log.resources.write_bytes = reader.next_long();
+    log.counters.measured = reader.next_long()!=0;
+    log.counters.instructions = reader.next_long();
+    log.counters.cycles = reader.next_long();
+    log.counters.cache_misses = reader.next_long();
+    log.counters.branch_misses = reader.next_long();
+    log.counters.tlb_misses = reader.next_long();
+    log.allocations.measured = reader.next_long()!=0;
+    log.allocations.count = reader.next_long();
+    log.allocations.bytes = reader.next_long();
+    log.allocations.peak_bytes = reader.next_long();
+    log.allocations.live_bytes = reader.next_long();
+    log.benchmark.measured = reader.next_long()!=0;
+    log.benchmark.iterations = reader.next_long();
+    log.benchmark.mean = reader.next_double();
+    log.benchmark.median = reader.next_double();
+    log.benchmark.stddev = reader.next_double();
+    log.benchmark.min = reader.next_double();
+    log.benchmark.throughput = reader.next_double();
+    log.benchmark.bytes_per_second = reader.next_double();
+    const long n_samples = reader.next_long();
+    log.benchmark.samples.clear();
+    for (long i=0; i<n_samples && reader.good(); ++i)
+        log.benchmark.samples.push_back(reader.next_double());
+    log.baseline.compared = reader.next_long()!=0;
+    log.baseline.baseline_median = reader.next_double();
+    log.baseline.ratio = reader.next_double();
+    log.baseline.p_value = reader.next_double();
+    log.baseline.regressed = reader.next_long()!=0;
+    log.sweep.measured = reader.next_long()!=0;
+    log.sweep.best_fit = static_cast<unittest::complexity>(reader.next_long());
+    log.sweep.coefficient = reader.next_double();
+    log.sweep.rms = reader.next_double();
+    const long n_ranges = reader.next_long();
+    log.sweep.ranges.clear();
+    log.sweep.times.clear();
+    for (long i=0; i<n_ranges && reader.good(); ++i) {
+        log.sweep.ranges.push_back(reader.next_long());
+        log.sweep.times.push_back(reader.next_double());
+    }
+    const long n_failures = reader.next_long();
+    log.nd_failures.clear();
+    for (long i=0; i<n_failures && reader.good(); ++i) {
+        const auto assertion = reader.next_string();
+        const auto message = reader.next_string();
+        const auto filename = reader.next_string();
+        const int linenumber = static_cast<int>(reader.next_long());
+        const auto callsite = reader.next_string();
+        log.nd_failures.push_back(testfailure(assertion, message, filename, linenumber, callsite));
+    }
+    return reader.good();
 }
 
 std::string
@@ -12,6 +12,48 @@ testresults::testresults()
       n_errors(0), n_skipped(0), n_timeouts(0), duration(0), testlogs(0)
 {}
 
+testlogview::testlogview(const_iterator first,
+                         const_iterator last)
+    : first_(first), last_(last)
+{}
+
+testlogview::const_iterator
+testlogview::begin() const
+{
+    return first_;
+}
+
+testlogview::const_iterator
+testlogview::end() const
+{
+    return last_;
+}
+
+size_t
+testlogview::size() const
+{
+    return static_cast<size_t>(last_ - first_);
+}
+
+bool
+testlogview::successful() const
+{
+    for (const auto& log : *this)
+        if (!log.successful)
+            return false;
+    return true;
+}
+
+testlogview
+make_testlogview(const testresults& results,
+                 size_t index)
+{
+    const auto last = results.testlogs.end();
+    if (index >= results.testlogs.size())
+        return testlogview(last, last);
+    return testlogview(results.testlogs.begin() + index, last);
+}
+
 void
 write_failure_info(std::ostream& stream,
                    const std::string& assertion,
@@ -35,18 +77,15 @@ write_failure_info(std::ostream& stream,
 }
 
 void
-write_xml(std::ostream& stream,
-          const testresults& results,
-          const std::string& suite_name,
-          long long shuffle_seed,
-          const std::chrono::system_clock::time_point& time_point,
-          bool local_time)
+write_xml_testsuite_tag(std::ostream& stream,
+                        const testresults& results,
+                        const std::string& suite_name,
+                        long long shuffle_seed,
+                        int shard_index,
+                        int shard_count,
+                        const std::chrono::system_clock::time_point& time_point,
+                        bool local_time)
 {
-    static std::mutex write_xml_mutex_;
-    std::lock_guard<std::mutex> lock(write_xml_mutex_);
-    stream.setf(std::ios_base::fixed);
-    stream << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>";
-    stream << "\n";
     stream << "<testsuite name=\"" << xml_escape(trim(suite_name));
     stream << "\" timestamp=\"" << make_iso_timestamp(time_point, local_time);
     stream << "\" tests=\"" << results.n_tests + results.n_skipped;
@@ -56,84 +95,244 @@ write_xml(std::ostream& stream,
     stream << "\" skipped=\"" << results.n_skipped;
     if (shuffle_seed >= 0)
         stream << "\" shuffseed=\"" << shuffle_seed;
-    stream << "\" time=\"" << results.duration << "\">";
+    if (shard_count > 1) {
+        stream << "\" shard=\"" << shard_index;
+        stream << "\" shards=\"" << shard_count;
+    }
+    stream << "\" time=\"" << results.duration << "\"";
+}
+
+void
+write_xml_properties(std::ostream& stream,
+                     const std::vector<std::pair<std::string, std::string>>& properties)
+{
+    if (properties.empty())
+        return;
+    stream << "\t<properties>";
     stream << "\n";
-    for (const auto& log : results.testlogs) {
-        std::string system_out;
-        if (log.text.size()) {
-            system_out += "\t\t<system-out>\n";
-            system_out += "\t\t\t" + xml_escape(trim(log.text)) + "\n";
-            system_out += "\t\t</system-out>";
-        }
-        stream << "\t<testcase ";
-        if (log.class_name.size())
-            stream << "classname=\"" << xml_escape(log.class_name) << "\" ";
-        stream << "name=\"" << xml_escape(log.test_name);
-        if (log.assertion.size())
-            stream << "\" assertions=\"" << xml_escape(log.assertion);
-        if (log.filename.size())
-            stream << "\" file=\"" << xml_escape(log.filename);
-        if (log.linenumber>-1)
-            stream << "\" line=\"" << log.linenumber;
-        stream << "\" time=\"" << log.duration << "\"";
-        if (log.has_timed_out)
-            stream << " timeout=\"" << log.timeout << "\"";
-        if (log.successful) {
-            if (log.status==teststatus::skipped) {
-                stream << ">";
-                stream << "\n";
-                stream << "\t\t<skipped/>";
+    for (const auto& property : properties) {
+        stream << "\t\t<property name=\"" << xml_escape(property.first);
+        stream << "\" value=\"" << xml_escape(property.second) << "\"/>";
+        stream << "\n";
+    }
+    stream << "\t</properties>";
+    stream << "\n";
+}
+
+void
+write_xml_resources(std::ostream& stream,
+                    const resourceusage& usage)
+{
+    stream << " usertime=\"" << usage.user_time << "\"";
+    stream << " systime=\"" << usage.system_time << "\"";
+    stream << " maxrss=\"" << usage.max_rss << "\"";
+    stream << " minflt=\"" << usage.minor_faults << "\"";
+    stream << " majflt=\"" << usage.major_faults << "\"";
+    stream << " nvcsw=\"" << usage.voluntary_switches << "\"";
+    stream << " nivcsw=\"" << usage.involuntary_switches << "\"";
+    stream << " rchar=\"" << usage.read_bytes << "\"";
+    stream << " wchar=\"" << usage.write_bytes << "\"";
+}
+
+void
+write_xml_counters(std::ostream& stream,
+                   const perfcounts& counts)
+{
+    const std::vector<std::pair<const char*, long long>> values = {
+        {"instructions", counts.instructions}, {"cycles", counts.cycles},
+        {"cache_misses", counts.cache_misses}, {"branch_misses", counts.branch_misses},
+        {"tlb_misses", counts.tlb_misses}};
+    for (const auto& value : values)
+        if (value.second >= 0)
+            stream << " " << value.first << "=\"" << value.second << "\"";
+}
+
+void
+write_xml_allocations(std::ostream& stream,
+                      const allocationcounts& counts)
+{
+    stream << " allocs=\"" << counts.count << "\"";
+    stream << " alloc_bytes=\"" << counts.bytes << "\"";
+    stream << " peak_bytes=\"" << counts.peak_bytes << "\"";
+    stream << " live_bytes=\"" << counts.live_bytes << "\"";
+}
+
+void
+write_xml_benchmark(std::ostream& stream,
+                    const benchresult& result)
+{
+    // times per iteration are far below the fixed precision used elsewhere
+    const auto flags = stream.flags();
+    const auto precision = stream.precision();
+    stream.unsetf(std::ios::floatfield);
+    stream.precision(9);
+    stream << " bench_iterations=\"" << result.iterations << "\"";
+    stream << " bench_samples=\"";
+    for (size_t i=0; i<result.samples.size(); ++i)
+        stream << (i ? " " : "") << result.samples[i];
+    stream << "\"";
+    stream << " bench_mean=\"" << result.mean << "\"";
+    stream << " bench_median=\"" << result.median << "\"";
+    stream << " bench_stddev=\"" << result.stddev << "\"";
+    stream << " bench_min=\"" << result.min << "\"";
+    stream << " bench_throughput=\"" << result.throughput << "\"";
+    if (result.bytes_per_second > 0)
+        stream << " bench_bytes_per_second=\"" << result.bytes_per_second << "\"";
+    stream.flags(flags);
+    stream.precision(precision);
+}
+
+void
+write_xml_baseline(std::ostream& stream,
+                   const benchcomparison& comparison)
+{
+    const auto flags = stream.flags();
+    const auto precision = stream.precision();
+    stream.unsetf(std::ios::floatfield);
+    stream.precision(9);
+    stream << " baseline_median=\"" << comparison.baseline_median << "\"";
+    stream << " baseline_ratio=\"" << comparison.ratio << "\"";
+    stream << " baseline_p=\"" << comparison.p_value << "\"";
+    stream << " baseline_regressed=\"" << (comparison.regressed ? "true" : "false") << "\"";
+    stream.flags(flags);
+    stream.precision(precision);
+}
+
+void
+write_xml_sweep(std::ostream& stream,
+                const sweepresult& result)
+{
+    const auto flags = stream.flags();
+    const auto precision = stream.precision();
+    stream.unsetf(std::ios::floatfield);
+    stream.precision(9);
+    stream << " sweep_ranges=\"";
+    for (size_t i=0; i<result.ranges.size(); ++i)
+        stream << (i ? " " : "") << result.ranges[i];
+    stream << "\"";
+    stream << " sweep_times=\"";
+    for (size_t i=0; i<result.times.size(); ++i)
+        stream << (i ? " " : "") << result.times[i];
+    stream << "\"";
+    stream << " sweep_complexity=\"" << complexity_name(result.best_fit) << "\"";
+    stream << " sweep_coefficient=\"" << result.coefficient << "\"";
+    stream << " sweep_rms=\"" << result.rms << "\"";
+    stream.flags(flags);
+    stream.precision(precision);
+}
+
+void
+write_xml_testcase(std::ostream& stream,
+                   const testlog& log)
+{
+    std::string system_out;
+    if (log.text.size()) {
+        system_out += "\t\t<system-out>\n";
+        system_out += "\t\t\t" + xml_escape(trim(log.text)) + "\n";
+        system_out += "\t\t</system-out>";
+    }
+    stream << "\t<testcase ";
+    if (log.class_name.size())
+        stream << "classname=\"" << xml_escape(log.class_name) << "\" ";
+    stream << "name=\"" << xml_escape(log.test_name);
+    if (log.assertion.size())
+        stream << "\" assertions=\"" << xml_escape(log.assertion);
+    if (log.filename.size())
+        stream << "\" file=\"" << xml_escape(log.filename);
+    if (log.linenumber>-1)
+        stream << "\" line=\"" << log.linenumber;
+    stream << "\" time=\"" << log.duration << "\"";
+    if (log.has_timed_out)
+        stream << " timeout=\"" << log.timeout << "\"";
+    if (log.resources.measured)
+        write_xml_resources(stream, log.resources);
+    if (log.counters.measured)
+        write_xml_counters(stream, log.counters);
+    if (log.allocations.measured)
+        write_xml_allocations(stream, log.allocations);
+    if (log.benchmark.measured)
+        write_xml_benchmark(stream, log.benchmark);
+    if (log.baseline.compared)
+        write_xml_baseline(stream, log.baseline);
+    if (log.sweep.measured)
+        write_xml_sweep(stream, log.sweep);
+    if (log.successful) {
+        if (log.status==teststatus::skipped) {
+            stream << ">";
+            stream << "\n";
+            stream << "\t\t<skipped/>";
+            stream << "\n";
+            stream << system_out;
+            if (system_out.size())
                 stream << "\n";
-                stream << system_out;
-                if (system_out.size())
-                    stream << "\n";
+            stream << "\t</testcase>";
+        } else {
+            if (system_out.size()) {
+                stream << ">\n";
+                stream << system_out << "\n";
                 stream << "\t</testcase>";
             } else {
-                if (system_out.size()) {
-                    stream << ">\n";
-                    stream << system_out << "\n";
-                    stream << "\t</testcase>";
-                } else {
-                    stream << "/>";
-                }
+                stream << "/>";
             }
+        }
+        stream << "\n";
+    } else {
+        stream << ">";
+        for (const auto& failure : log.nd_failures) {
             stream << "\n";
-        } else {
-            stream << ">";
-            for (const auto& failure : log.nd_failures) {
+            stream << "\t\t<" << "failure" << " ";
+            stream << "type=\"" << xml_escape("testfailure (non-deadly)");
+            stream << "\" message=\"" << xml_escape(trim(failure.what())) << "\">";
+            if (failure.assertion().size()) {
                 stream << "\n";
-                stream << "\t\t<" << "failure" << " ";
-                stream << "type=\"" << xml_escape("testfailure (non-deadly)");
-                stream << "\" message=\"" << xml_escape(trim(failure.what())) << "\">";
-                if (failure.assertion().size()) {
-                    stream << "\n";
-                    write_failure_info(stream, xml_escape(trim(failure.assertion())), xml_escape(trim(failure.filename())), failure.linenumber(), xml_escape(trim(failure.callsite())), "\t\t\t");
-                }
-                stream << "\n\t\t</" << "failure" << ">";
+                write_failure_info(stream, xml_escape(trim(failure.assertion())), xml_escape(trim(failure.filename())), failure.linenumber(), xml_escape(trim(failure.callsite())), "\t\t\t");
             }
-            if (!log.error_type.empty()) {
-                stream << "\n";
-                std::string name("error");
-                if (log.error_type=="testfailure")
-                    name = "failure";
-                stream << "\t\t<" << name << " ";
-                stream << "type=\"" << xml_escape(log.error_type);
-                stream << "\" message=\"" << xml_escape(trim(log.message)) << "\">";
-                if (log.error_type=="testfailure" && !log.assertion.empty()) {
-                    stream << "\n";
-                    write_failure_info(stream, xml_escape(trim(log.assertion)), xml_escape(trim(log.filename)), log.linenumber, xml_escape(trim(log.callsite)), "\t\t\t");
-                }
+            stream << "\n\t\t</" << "failure" << ">";
+        }
+        if (!log.error_type.empty()) {
+            stream << "\n";
+            std::string name("error");
+            if (log.error_type=="testfailure")
+                name = "failure";
+            stream << "\t\t<" << name << " ";
+            stream << "type=\"" << xml_escape(log.error_type);
+            stream << "\" message=\"" << xml_escape(trim(log.message)) << "\">";
+            if (log.error_type=="testfailure" && !log.assertion.empty()) {
                 stream << "\n";
-                stream << "\t\t</" << name << ">";
-                if (system_out.size())
-                    stream << "\n";
-                stream << system_out;
+                write_failure_info(stream, xml_escape(trim(log.assertion)), xml_escape(trim(log.filename)), log.linenumber, xml_escape(trim(log.callsite)), "\t\t\t");
             }
             stream << "\n";
-            stream << "\t</testcase>";
-            stream << "\n";
+            stream << "\t\t</" << name << ">";
+            if (system_out.size())
+                stream << "\n";
+            stream << system_out;
         }
+        stream << "\n";
+        stream << "\t</testcase>";
+        stream << "\n";
     }
+}
+
+void
+write_xml(std::ostream& stream,
+          const testresults& results,
+          const std::string& suite_name,
+          long long shuffle_seed,
+          const std::chrono::system_clock::time_point& time_point,
+          bool local_time,
+          int shard_index,
+          int shard_count)
+{
+    static std::mutex write_xml_mutex_;
+    std::lock_guard<std::mutex> lock(write_xml_mutex_);
+    stream.setf(std::ios_base::fixed);
+    stream << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>";
+    stream << "\n";
+    write_xml_testsuite_tag(stream, results, suite_name, shuffle_seed, shard_index, shard_count, time_point, local_time);
+    stream << ">";
+    stream << "\n";
+    for (const auto& log : results.testlogs)
+        write_xml_testcase(stream, log);
     stream << "</testsuite>";
     stream << "\n";
     stream << std::flush;
@@ -189,6 +388,14 @@ void
 write_error_info(std::ostream& stream,
                  const std::vector<testlog>& testlogs,
                  bool successful)
+{
+    write_error_info(stream, testlogview(testlogs.begin(), testlogs.end()), successful);
+}
+
+void
+write_error_info(std::ostream& stream,
+                 const testlogview& testlogs,
+                 bool successful)
 {
     static std::mutex write_error_info_mutex_;
     std::lock_guard<std::mutex> lock(write_error_info_mutex_);
@@ -239,5 +446,66 @@ write_error_info(std::ostream& stream,
     }
 }
 
+bool
+has_leaked(const testlog& log)
+{
+    return log.allocations.measured && log.allocations.live_bytes > 0 &&
+           log.status==teststatus::success;
+}
+
+void
+write_leak_info(std::ostream& stream,
+                const std::vector<testlog>& testlogs)
+{
+    bool any_leaks = false;
+    for (const auto& log : testlogs) {
+        if (has_leaked(log)) {
+            if (!any_leaks)
+                stream << "\n";
+            any_leaks = true;
+            stream << "LEAK: " << make_full_test_name(log.class_name, log.test_name);
+            stream << " (" << log.allocations.live_bytes << " bytes still allocated)\n";
+        }
+    }
+    if (any_leaks)
+        stream << "\n" << std::flush;
+}
+
+void
+write_bench_info(std::ostream& stream,
+                 const std::vector<testlog>& testlogs)
+{
+    bool any_benchmarks = false;
+    for (const auto& log : testlogs) {
+        if (!(log.benchmark.measured || log.sweep.measured) || log.status!=teststatus::success)
+            continue;
+        if (!any_benchmarks)
+            stream << "\n";
+        any_benchmarks = true;
+        if (log.sweep.measured) {
+            const auto& sweep = log.sweep;
+            stream << "SWEEP: " << make_full_test_name(log.class_name, log.test_name);
+            stream << " " << complexity_name(sweep.best_fit) << " coefficient=" << sweep.coefficient << "s";
+            stream << " rms=" << sweep.rms;
+            stream << " [" << sweep.ranges.size() << " ranges, " << sweep.ranges.front() << ".." << sweep.ranges.back() << "]\n";
+            continue;
+        }
+        const auto& result = log.benchmark;
+        stream << "BENCH: " << make_full_test_name(log.class_name, log.test_name);
+        stream << " mean=" << result.mean << "s median=" << result.median << "s";
+        stream << " stddev=" << result.stddev << "s min=" << result.min << "s";
+        stream << " throughput=" << result.throughput << "/s";
+        if (result.bytes_per_second > 0)
+            stream << " (" << result.bytes_per_second << " bytes/s)";
+        stream << " [" << result.samples.size() << "x" << result.iterations << "]";
+        if (log.baseline.compared)
+            stream << " baseline=" << log.baseline.baseline_median << "s ratio=" << log.baseline.ratio
+                   << " p=" << log.baseline.p_value;
+        stream << "\n";
+    }
+    if (any_benchmarks)
+        stream << "\n" << std::flush;
+}
+
 } // core
 } // unittest
@@ -3,49 +3,25 @@
 #include "libunittest/teststatus.hpp"
 #include "libunittest/testlog.hpp"
 #include "libunittest/testcollection.hpp"
+#include "libunittest/failuresink.hpp"
 #include <chrono>
-#include <iostream>
 #include <typeinfo>
+#include <atomic>
 
 namespace unittest {
 namespace core {
 
-void
-observe_and_wait(std::thread&& thread,
-                 std::shared_ptr<std::atomic_bool> done,
-                 std::shared_ptr<std::atomic_bool> has_timed_out,
-                 double timeout)
-{
-    if (!done->load() && timeout > 0) {
-        const std::chrono::milliseconds min_resolution(2);
-        volatile double overhead = 0.123;
-        volatile double duration = -1.;
-
-        // compute approx. overhead of instructions
-        const auto start_instr = unittest::core::now();
-        if (!done->load()) {
-            if (duration < timeout) {
-                std::this_thread::sleep_for(min_resolution);
-                duration += timeout;
-            }
-        }
-        overhead = duration_in_seconds(unittest::core::now() - start_instr);
-        duration = overhead;
-
-        while (!done->load()) {
-            if (duration > timeout) {
-                has_timed_out->store(true);
-                auto suite = testsuite::instance();
-                write_test_timeout_message(std::cout, suite->get_arguments().verbose);
-                suite->add_lonely_thread(std::move(thread), done);
-                break;
-            }
-            std::this_thread::sleep_for(min_resolution);
-            duration += overhead;
-        }
-    }
-    if (!has_timed_out->load())
-        thread.join();
+namespace {
+
+std::atomic<long> g_test_count(0);
+
+thread_local long g_test_sequence = -1;
+
+thread_local testmonitor* g_current_monitor = nullptr;
+
+// the p-value below which a benchmark slower than its baseline is deemed significantly slower
+const double g_baseline_significance = 0.01;
+
 }
 
 struct testmonitor::impl {
@@ -53,40 +29,56 @@ struct testmonitor::impl {
     testlog log_;
     std::chrono::microseconds start_;
     bool is_executed_;
+    std::shared_ptr<failuresink> sink_;
+    failurescope scope_;
+    benchscope bench_scope_;
+    testmonitor* previous_;
 
-    impl()
+    explicit
+    impl(const std::string& method_id)
         : log_(),
           start_(std::chrono::microseconds::min()),
-          is_executed_(true)
+          is_executed_(true),
+          sink_(std::make_shared<failuresink>(method_id)),
+          scope_(sink_),
+          bench_scope_(&log_.benchmark, &log_.sweep),
+          previous_(g_current_monitor)
     {}
 
 };
 
 testmonitor::testmonitor(const std::string& class_name,
                          const std::string& test_name,
-                         const std::string& method_id)
-    : impl_(make_unique<impl>())
+                         const std::string& method_id,
+                         double timeout,
+                         long sequence)
+    : impl_(unittest::core::make_unique<impl>(method_id))
 {
+    g_current_monitor = this;
     auto suite = testsuite::instance();
-    impl_->is_executed_ = suite->is_test_run(class_name, test_name);
+    impl_->is_executed_ = suite->is_test_run(class_name, test_name) && !suite->is_excluded(method_id);
     impl_->log_.class_name = class_name;
     impl_->log_.test_name = test_name;
     impl_->log_.method_id = method_id;
+    impl_->log_.timeout = timeout;
+    impl_->log_.sequence = sequence;
     if (impl_->is_executed_) {
         suite->start_timing();
         impl_->start_ = unittest::core::now();
-        write_test_start_message(std::cout, impl_->log_, suite->get_arguments().verbose);
+        suite->write_test_start(impl_->log_);
+        suite->notify_start(impl_->log_);
     }
 }
 
 testmonitor::~testmonitor()
 {
+    g_current_monitor = impl_->previous_;
     auto suite = testsuite::instance();
     if (impl_->is_executed_) {
         if (!suite->get_arguments().dry_run) {
             suite->stop_timing();
             if (impl_->log_.status!=teststatus::skipped) {
-                const auto failures = suite->get_failures(impl_->log_.method_id);
+                auto failures = impl_->sink_->take();
                 if (failures.size()) {
                     if (impl_->log_.assertion.empty()) {
                         impl_->log_.assertion = failures[failures.size()-1].assertion();
@@ -95,7 +87,7 @@ testmonitor::~testmonitor()
                             impl_->log_.linenumber = failures[failures.size()-1].linenumber();
                         }
                     }
-                    impl_->log_.nd_failures = failures;
+                    impl_->log_.nd_failures = std::move(failures);
                     impl_->log_.status = teststatus::failure;
                 }
                 impl_->log_.duration = duration_in_seconds(unittest::core::now() - impl_->start_);
@@ -104,9 +96,25 @@ testmonitor::~testmonitor()
         suite->make_keep_running(impl_->log_);
         impl_->log_.successful = impl_->log_.status==teststatus::success ||
                                  impl_->log_.status==teststatus::skipped;
-        write_test_end_message(std::cout, impl_->log_, suite->get_arguments().verbose);
+        suite->write_test_end(impl_->log_);
     }
-    suite->collect(impl_->log_);
+    suite->collect(std::move(impl_->log_));
+}
+
+bool
+testmonitor::log_text(const std::string& method_id,
+                      const std::string& text)
+{
+    if (!g_current_monitor || g_current_monitor->impl_->log_.method_id!=method_id)
+        return false;
+    g_current_monitor->impl_->log_.text = text;
+    return true;
+}
+
+std::shared_ptr<failuresink>
+testmonitor::failure_sink() const
+{
+    return impl_->sink_;
 }
 
 bool
@@ -165,6 +173,66 @@ testmonitor::has_timed_out(double timeout)
     impl_->log_.timeout = timeout;
 }
 
+void
+testmonitor::log_counters(const perfcounts& start)
+{
+    impl_->log_.counters = perf_difference(start, read_perf_counters());
+}
+
+void
+testmonitor::log_allocations(const allocationcounts& counts)
+{
+    impl_->log_.allocations = counts;
+}
+
+void
+testmonitor::check_memory_budget(const allocationcounts& counts,
+                                 long long memory_budget)
+{
+    if (impl_->log_.status==teststatus::success && counts.measured && counts.peak_bytes > memory_budget) {
+        const std::string message = join("peak of ", counts.peak_bytes, " heap bytes exceeds the memory budget of ",
+                                         memory_budget, " bytes");
+        log_failure(testfailure("memory_budget", message));
+    }
+}
+
+void
+testmonitor::check_baseline()
+{
+    auto suite = testsuite::instance();
+    const auto baseline = suite->get_baseline();
+    if (!baseline || !impl_->log_.benchmark.measured)
+        return;
+    const auto samples = baseline->find(make_full_test_name(impl_->log_.class_name, impl_->log_.test_name));
+    if (!samples)
+        return;
+    const double threshold = suite->get_arguments().bench_threshold;
+    impl_->log_.baseline = compare_benchmark(*samples, impl_->log_.benchmark.samples, threshold, g_baseline_significance);
+    const auto& comparison = impl_->log_.baseline;
+    if (impl_->log_.status==teststatus::success && comparison.regressed) {
+        const std::string message = join("median of ", impl_->log_.benchmark.median, "s is ",
+                                         static_cast<long>(100 * (comparison.ratio - 1) + 0.5),
+                                         "% slower than the baseline median of ", comparison.baseline_median,
+                                         "s (threshold=", 100 * threshold, "%, p=", comparison.p_value, ")");
+        log_failure(testfailure("benchmark_baseline", message));
+    }
+}
+
+void
+testmonitor::log_resources(const resourceusage& start)
+{
+    impl_->log_.resources = resource_difference(start, measure_resources());
+}
+
+threadpool*
+get_method_threadpool()
+{
+    if (testsuite::instance()->get_arguments().parallel_methods)
+        return threadpool::current();
+    else
+        return nullptr;
+}
+
 void
 update_local_timeout(double& local_timeout,
                      double global_timeout)
@@ -198,12 +266,26 @@ make_method_id(const std::string& class_id, const std::string& test_name)
     return class_id + test_name;
 }
 
+long
+make_test_sequence()
+{
+    g_test_sequence = g_test_count++;
+    return g_test_sequence;
+}
+
+void
+set_test_sequence(long sequence)
+{
+    g_test_sequence = sequence;
+}
+
 unittest::core::testinfo
 make_testinfo(std::string class_id,
               std::string test_name,
               bool skipped,
               std::string skip_message,
-              double timeout)
+              double timeout,
+              long long memory_budget)
 {
     std::string class_name;
     unittest::core::update_testrun_info(class_id, class_name, test_name, timeout);
@@ -213,8 +295,22 @@ make_testinfo(std::string class_id,
     auto has_timed_out = std::make_shared<std::atomic_bool>();
     has_timed_out->store(false);
     return {make_method_id(class_id, test_name), class_name,
-            test_name, args.dry_run, args.handle_exceptions,
-            done, has_timed_out, timeout, skipped && !args.ignore_skips, skip_message};
+            test_name, args.dry_run, args.handle_exceptions, args.resource_usage, args.perf_counters,
+            args.track_allocations, memory_budget,
+            done, has_timed_out, timeout, skipped && !args.ignore_skips, skip_message,
+            g_test_sequence};
+}
+
+testlog
+make_testlog(const unittest::core::testinfo& info)
+{
+    testlog log;
+    log.class_name = info.class_name;
+    log.test_name = info.test_name;
+    log.method_id = info.method_id;
+    log.timeout = info.timeout;
+    log.sequence = info.sequence;
+    return log;
 }
 
 void run_testfunction(const unittest::core::testinfo& info,
@@ -243,9 +339,10 @@ void run_testfunctor<def_context_type>(std::shared_ptr<def_context_type> context
                                        const std::string& test_name,
                                        bool skipped,
                                        const std::string& skip_message,
-                                       double timeout)
+                                       double timeout,
+                                       long long memory_budget)
 {
-    run_testfunctor_impl<def_context_type>(context, constructor, caller, class_id, test_name, skipped, skip_message, timeout);
+    run_testfunctor_impl<def_context_type>(context, constructor, caller, class_id, test_name, skipped, skip_message, timeout, memory_budget);
 }
 
 } // core
@@ -2,52 +2,176 @@
 #include "libunittest/teststatus.hpp"
 #include "libunittest/utilities.hpp"
 #include "libunittest/testfailure.hpp"
+#include "libunittest/testrun.hpp"
+#include <iostream>
 #include <mutex>
 #include <memory>
 #include <chrono>
 #include <vector>
 #include <map>
+#include <set>
+#include <atomic>
+#include <algorithm>
+#include <iterator>
 
 namespace unittest {
 namespace core {
 
+namespace {
+
+struct resultshard {
+    std::mutex mutex_;
+    std::vector<std::pair<long, testlog>> testlogs_;
+    long n_tests_;
+    long n_successes_;
+    long n_failures_;
+    long n_errors_;
+    long n_skipped_;
+    long n_timeouts_;
+
+    resultshard()
+        : mutex_(), testlogs_(), n_tests_(0), n_successes_(0),
+          n_failures_(0), n_errors_(0), n_skipped_(0), n_timeouts_(0)
+    {}
+};
+
+thread_local resultshard* g_result_shard = nullptr;
+
+}
+
 struct testsuite::impl {
 
-    bool keep_running_;
-    std::chrono::microseconds start_;
-    std::chrono::microseconds end_;
+    std::atomic_bool keep_running_;
+    std::atomic<std::chrono::microseconds::rep> start_;
+    std::atomic<std::chrono::microseconds::rep> end_;
     userargs arguments_;
+    std::mutex shards_mutex_;
+    std::vector<std::unique_ptr<resultshard>> shards_;
+    std::atomic<long> sequence_;
     testresults results_;
+    std::mutex classes_mutex_;
     std::vector<std::function<void()>> class_runs_;
+    std::vector<std::string> class_keys_;
     std::vector<std::string> class_names_;
+    std::vector<std::function<void()>> pending_runs_;
+    std::vector<std::pair<std::string, std::string>> pending_classes_;
     std::map<std::string, std::string> class_maps_;
     std::vector<std::pair<std::thread, std::shared_ptr<std::atomic_bool>>> lonely_threads_;
     std::map<std::string, std::string> logged_texts_;
-    std::map<std::string, std::vector<testfailure>> logged_failures_;
+    std::atomic_bool has_logged_texts_;
+    std::mutex logged_texts_mutex_;
+    std::function<void(const testlog&, testevent)> listener_;
+    std::mutex listener_mutex_;
+    std::vector<std::shared_ptr<testreporter>> reporters_;
+    std::shared_ptr<consolewriter> console_;
+    std::mutex console_mutex_;
+    bool is_console_silent_;
+    std::set<std::string> excluded_tests_;
+    std::shared_ptr<const benchbaseline> baseline_;
 
     impl()
         : keep_running_(true),
-          start_(std::chrono::microseconds::min()),
-          end_(std::chrono::microseconds::min()),
+          start_(std::chrono::microseconds::min().count()),
+          end_(std::chrono::microseconds::min().count()),
           arguments_(),
+          shards_mutex_(),
+          shards_(),
+          sequence_(0),
           results_(),
+          classes_mutex_(),
           class_runs_(),
+          class_keys_(),
           class_names_(),
+          pending_runs_(),
+          pending_classes_(),
           class_maps_(),
           lonely_threads_(),
           logged_texts_(),
-          logged_failures_()
+          has_logged_texts_(false),
+          logged_texts_mutex_(),
+          listener_(),
+          listener_mutex_(),
+          reporters_(),
+          console_(),
+          console_mutex_(),
+          is_console_silent_(false),
+          excluded_tests_(),
+          baseline_()
     {}
 
+    // pairs the class runs with the class keys and names in the order of
+    // registration and keeps them sorted by the keys
+    void
+    insert_classes()
+    {
+        while (pending_runs_.size() && pending_classes_.size()) {
+            const auto& key = pending_classes_.front().first;
+            const auto index = std::lower_bound(class_keys_.begin(), class_keys_.end(), key) - class_keys_.begin();
+            class_runs_.insert(class_runs_.begin() + index, pending_runs_.front());
+            class_keys_.insert(class_keys_.begin() + index, key);
+            class_names_.insert(class_names_.begin() + index, pending_classes_.front().second);
+            pending_runs_.erase(pending_runs_.begin());
+            pending_classes_.erase(pending_classes_.begin());
+        }
+    }
+
+    resultshard&
+    get_shard()
+    {
+        if (!g_result_shard) {
+            std::lock_guard<std::mutex> lock(shards_mutex_);
+            shards_.push_back(make_unique<resultshard>());
+            g_result_shard = shards_.back().get();
+        }
+        return *g_result_shard;
+    }
+
+    void
+    merge_shards()
+    {
+        std::lock_guard<std::mutex> lock(shards_mutex_);
+        testresults counts;
+        std::vector<std::pair<long, testlog>> testlogs;
+        for (const auto& shard : shards_) {
+            std::lock_guard<std::mutex> shard_lock(shard->mutex_);
+            counts.n_tests += shard->n_tests_;
+            counts.n_successes += shard->n_successes_;
+            counts.n_failures += shard->n_failures_;
+            counts.n_errors += shard->n_errors_;
+            counts.n_skipped += shard->n_skipped_;
+            counts.n_timeouts += shard->n_timeouts_;
+            std::move(shard->testlogs_.begin(), shard->testlogs_.end(), std::back_inserter(testlogs));
+            shard->testlogs_.clear();
+        }
+        std::sort(testlogs.begin(), testlogs.end(),
+                  [](const std::pair<long, testlog>& first, const std::pair<long, testlog>& second) { return first.first < second.first; });
+        const auto n_merged = results_.testlogs.size();
+        results_.testlogs.reserve(n_merged + testlogs.size());
+        for (auto& pair : testlogs)
+            results_.testlogs.push_back(std::move(pair.second));
+        assign_logged_texts(results_.testlogs, n_merged);
+        results_.n_tests = counts.n_tests;
+        results_.n_successes = counts.n_successes;
+        results_.n_failures = counts.n_failures;
+        results_.n_errors = counts.n_errors;
+        results_.n_skipped = counts.n_skipped;
+        results_.n_timeouts = counts.n_timeouts;
+        results_.successful = results_.n_tests==results_.n_successes;
+        if (!arguments_.dry_run)
+            results_.duration = duration_in_seconds(std::chrono::microseconds(end_.load() - start_.load()));
+    }
+
     void
-    assign_logged_texts(std::vector<testlog>& testlogs)
+    assign_logged_texts(std::vector<testlog>& testlogs,
+                        size_t index=0)
     {
-        static std::mutex assign_logged_texts_mutex_;
-        std::lock_guard<std::mutex> lock(assign_logged_texts_mutex_);
-        for (auto& log : testlogs) {
-            const auto& element = logged_texts_.find(log.method_id);
+        if (!has_logged_texts_.load())
+            return;
+        std::lock_guard<std::mutex> lock(logged_texts_mutex_);
+        for (auto log=testlogs.begin() + index; log!=testlogs.end(); ++log) {
+            const auto& element = logged_texts_.find(log->method_id);
             if (element!=logged_texts_.end())
-                log.text = element->second;
+                log->text = element->second;
         }
     }
 
@@ -90,79 +214,96 @@ testsuite::get_arguments() const
 const std::vector<std::function<void()>>&
 testsuite::get_class_runs() const
 {
-    if (impl_->class_runs_.size() != impl_->class_names_.size())
+    if (impl_->pending_runs_.size() || impl_->pending_classes_.size())
         throw std::runtime_error(__func__);
-    std::map<std::string, std::function<void()>> map;
-    for (size_t i=0; i<impl_->class_runs_.size(); ++i) {
-        map[impl_->class_names_[i]] = impl_->class_runs_[i];
-    }
-    impl_->class_runs_.clear();
-    impl_->class_runs_.reserve(map.size());
-    for (const auto& pair : map) {
-        impl_->class_runs_.push_back(pair.second);
-    }
     return impl_->class_runs_;
 }
 
+const std::vector<std::string>&
+testsuite::get_class_names() const
+{
+    return impl_->class_names_;
+}
+
 testresults
 testsuite::get_results() const
 {
-    testresults results(impl_->results_);
-    results.successful = results.n_tests==results.n_successes;
-    if (!get_arguments().dry_run)
-        results.duration = duration_in_seconds(impl_->end_ - impl_->start_);
-    impl_->assign_logged_texts(results.testlogs);
-    return results;
+    return update_results();
+}
+
+const testresults&
+testsuite::update_results() const
+{
+    impl_->merge_shards();
+    return impl_->results_;
 }
 
 void
 testsuite::make_keep_running(const testlog& log)
 {
-    static std::mutex make_keep_running_mutex_;
-    std::lock_guard<std::mutex> lock(make_keep_running_mutex_);
-    impl_->keep_running_ = keep_running(log, get_arguments().failure_stop);
+    if (!keep_running(log, get_arguments().failure_stop))
+        impl_->keep_running_.store(false);
+}
+
+bool
+testsuite::is_keep_running() const
+{
+    return impl_->keep_running_.load();
 }
 
 void
 testsuite::start_timing()
 {
-    static std::mutex start_timing_mutex_;
-    std::lock_guard<std::mutex> lock(start_timing_mutex_);
-    if (impl_->start_==std::chrono::microseconds::min())
-        impl_->start_ = unittest::core::now();
+    auto expected = std::chrono::microseconds::min().count();
+    if (impl_->start_.load()==expected)
+        impl_->start_.compare_exchange_strong(expected, unittest::core::now().count());
 }
 
 void
 testsuite::stop_timing()
 {
-    static std::mutex stop_timing_mutex_;
-    std::lock_guard<std::mutex> lock(stop_timing_mutex_);
-    impl_->end_ = unittest::core::now();
+    const auto end = unittest::core::now().count();
+    auto current = impl_->end_.load();
+    while (current < end && !impl_->end_.compare_exchange_weak(current, end));
 }
 
 void
-testsuite::collect(const testlog& log)
+testsuite::collect(testlog log)
 {
-    static std::mutex collect_mutex_;
-    std::lock_guard<std::mutex> lock(collect_mutex_);
+    if (impl_->listener_ || !impl_->reporters_.empty()) {
+        if (impl_->has_logged_texts_.load()) {
+            std::vector<testlog> testlogs = {log};
+            impl_->assign_logged_texts(testlogs);
+            log = std::move(testlogs.front());
+        }
+        if (impl_->listener_) {
+            std::lock_guard<std::mutex> lock(impl_->listener_mutex_);
+            impl_->listener_(log, testevent::finished);
+        }
+        for (const auto& reporter : impl_->reporters_)
+            reporter->report(log);
+    }
+    auto& shard = impl_->get_shard();
+    const long sequence = impl_->sequence_++;
+    std::lock_guard<std::mutex> lock(shard.mutex_);
     if (log.status != teststatus::skipped)
-        ++impl_->results_.n_tests;
+        ++shard.n_tests_;
     if (log.has_timed_out)
-        ++impl_->results_.n_timeouts;
+        ++shard.n_timeouts_;
     switch (log.status) {
-    case teststatus::success: ++impl_->results_.n_successes; break;
-    case teststatus::failure: ++impl_->results_.n_failures; break;
-    case teststatus::error: ++impl_->results_.n_errors; break;
-    default: ++impl_->results_.n_skipped; break;
+    case teststatus::success: ++shard.n_successes_; break;
+    case teststatus::failure: ++shard.n_failures_; break;
+    case teststatus::error: ++shard.n_errors_; break;
+    default: ++shard.n_skipped_; break;
     }
-    impl_->results_.testlogs.push_back(log);
+    shard.testlogs_.emplace_back(sequence, std::move(log));
 }
 
 bool
 testsuite::is_test_run(const std::string& class_name,
                        const std::string& test_name) const
 {
-    if (!impl_->keep_running_) {
+    if (!impl_->keep_running_.load()) {
         return false;
     } else {
         const std::string full_name = make_full_test_name(class_name, test_name);
@@ -173,21 +314,21 @@ testsuite::is_test_run(const std::string& class_name,
 void
 testsuite::add_class_run(const std::function<void()>& class_run)
 {
-    static std::mutex add_class_run_mutex_;
-    std::lock_guard<std::mutex> lock(add_class_run_mutex_);
-    impl_->class_runs_.push_back(class_run);
+    std::lock_guard<std::mutex> lock(impl_->classes_mutex_);
+    impl_->pending_runs_.push_back(class_run);
+    impl_->insert_classes();
 }
 
 void
 testsuite::add_class_map(const std::string& typeid_name,
                          const std::string& class_name)
 {
-    static std::mutex add_class_map_mutex_;
-    std::lock_guard<std::mutex> lock(add_class_map_mutex_);
+    std::lock_guard<std::mutex> lock(impl_->classes_mutex_);
     if (impl_->class_maps_.find(typeid_name) != impl_->class_maps_.end())
         throw testsuite_error("Testcase already registered: " + class_name);
     impl_->class_maps_[typeid_name] = class_name;
-    impl_->class_names_.push_back(class_name + typeid_name);
+    impl_->pending_classes_.push_back(std::make_pair(class_name + typeid_name, class_name));
+    impl_->insert_classes();
 }
 
 const std::map<std::string, std::string>&
@@ -215,29 +356,122 @@ void
 testsuite::log_text(const std::string& method_id,
                     const std::string& text)
 {
-    static std::mutex log_text_mutex_;
-    std::lock_guard<std::mutex> lock(log_text_mutex_);
+    // the text usually goes right into the log of the test running on this thread
+    if (testmonitor::log_text(method_id, text))
+        return;
+    std::lock_guard<std::mutex> lock(impl_->logged_texts_mutex_);
     impl_->logged_texts_[method_id] = text;
+    impl_->has_logged_texts_.store(true);
+}
+
+void
+testsuite::add_reporter(std::shared_ptr<testreporter> reporter)
+{
+    impl_->reporters_.push_back(std::move(reporter));
+}
+
+void
+testsuite::remove_reporters()
+{
+    impl_->reporters_.clear();
+}
+
+void
+testsuite::set_consolewriter(std::shared_ptr<consolewriter> writer)
+{
+    impl_->console_ = std::move(writer);
+}
+
+void
+testsuite::set_baseline(std::shared_ptr<const benchbaseline> baseline)
+{
+    impl_->baseline_ = std::move(baseline);
+}
+
+void
+testsuite::silence_console()
+{
+    // the writer is kept as is since a forked child must not drain its buffers
+    impl_->is_console_silent_ = true;
+}
+
+void
+testsuite::write_test_start(const testlog& log)
+{
+    if (impl_->is_console_silent_)
+        return;
+    if (!impl_->console_) {
+        std::lock_guard<std::mutex> lock(impl_->console_mutex_);
+        write_test_start_message(std::cout, log, impl_->arguments_.verbose);
+        std::cout << std::flush;
+    }
+}
+
+void
+testsuite::write_test_end(const testlog& log)
+{
+    if (impl_->is_console_silent_)
+        return;
+    if (impl_->console_) {
+        impl_->console_->write_end(log);
+    } else {
+        std::lock_guard<std::mutex> lock(impl_->console_mutex_);
+        write_test_end_message(std::cout, log, impl_->arguments_.verbose);
+        std::cout << std::flush;
+    }
+}
+
+void
+testsuite::write_test_timeout(const testlog& log)
+{
+    if (impl_->listener_) {
+        std::lock_guard<std::mutex> lock(impl_->listener_mutex_);
+        impl_->listener_(log, testevent::timed_out);
+    }
+    if (impl_->is_console_silent_)
+        return;
+    if (impl_->console_) {
+        impl_->console_->write_timeout(log);
+    } else {
+        std::lock_guard<std::mutex> lock(impl_->console_mutex_);
+        write_test_timeout_message(std::cout, impl_->arguments_.verbose);
+        std::cout << std::flush;
+    }
+}
+
+void
+testsuite::set_listener(std::function<void(const testlog&, testevent)> listener)
+{
+    impl_->listener_ = std::move(listener);
 }
 
 void
-testsuite::log_failure(const std::string& method_id,
-                       const unittest::testfailure& failure)
+testsuite::notify_start(const testlog& log)
+{
+    if (impl_->listener_) {
+        std::lock_guard<std::mutex> lock(impl_->listener_mutex_);
+        impl_->listener_(log, testevent::started);
+    }
+    for (const auto& reporter : impl_->reporters_)
+        reporter->start(log);
+}
+
+void
+testsuite::set_excluded_tests(const std::set<std::string>& method_ids)
+{
+    impl_->excluded_tests_ = method_ids;
+}
+
+bool
+testsuite::is_excluded(const std::string& method_id) const
 {
-    static std::mutex log_failure_mutex_;
-    std::lock_guard<std::mutex> lock(log_failure_mutex_);
-    impl_->logged_failures_[method_id].push_back(failure);
+    return impl_->excluded_tests_.find(method_id) != impl_->excluded_tests_.end();
 }
 
-std::vector<unittest::testfailure>
-testsuite::get_failures(const std::string& method_id)
+const benchbaseline*
+testsuite::get_baseline() const
 {
-    static std::mutex get_failure_mutex_;
-    std::lock_guard<std::mutex> lock(get_failure_mutex_);
-    if (impl_->logged_failures_.find(method_id) != impl_->logged_failures_.end())
-        return impl_->logged_failures_[method_id];
-    else
-        return {};
+    return impl_->baseline_.get();
 }
 
 } // core
@@ -0,0 +1,185 @@
+#include "libunittest/threadpool.hpp"
+#include "libunittest/utilities.hpp"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <exception>
+
+namespace unittest {
+namespace core {
+
+namespace {
+
+thread_local threadpool* g_current_pool = nullptr;
+thread_local size_t g_worker_index = 0;
+
+}
+
+struct threadpool::impl {
+
+    struct taskqueue {
+        std::mutex mutex_;
+        std::deque<std::function<void()>> tasks_;
+    };
+
+    std::vector<std::unique_ptr<taskqueue>> queues_;
+    taskqueue injected_;
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable work_cond_;
+    std::condition_variable done_cond_;
+    std::atomic<long> n_queued_;
+    std::atomic<long> n_unfinished_;
+    std::exception_ptr exception_;
+    bool stop_;
+
+    impl()
+        : queues_(), injected_(), threads_(), mutex_(), work_cond_(), done_cond_(),
+          n_queued_(0), n_unfinished_(0),
+          exception_(), stop_(false)
+    {}
+
+    bool
+    pop_own(size_t index, std::function<void()>& task)
+    {
+        auto& queue = *queues_[index];
+        std::lock_guard<std::mutex> lock(queue.mutex_);
+        if (queue.tasks_.empty())
+            return false;
+        task = std::move(queue.tasks_.back());
+        queue.tasks_.pop_back();
+        --n_queued_;
+        return true;
+    }
+
+    bool
+    pop_injected(std::function<void()>& task)
+    {
+        std::lock_guard<std::mutex> lock(injected_.mutex_);
+        if (injected_.tasks_.empty())
+            return false;
+        task = std::move(injected_.tasks_.front());
+        injected_.tasks_.pop_front();
+        --n_queued_;
+        return true;
+    }
+
+    bool
+    steal(size_t index, std::function<void()>& task)
+    {
+        for (size_t i=1; i<queues_.size(); ++i) {
+            auto& queue = *queues_[(index + i) % queues_.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex_);
+            if (!queue.tasks_.empty()) {
+                task = std::move(queue.tasks_.front());
+                queue.tasks_.pop_front();
+                --n_queued_;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void
+    execute(std::function<void()>& task)
+    {
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!exception_)
+                exception_ = std::current_exception();
+        }
+        task = nullptr;
+        if (--n_unfinished_ == 0) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            done_cond_.notify_all();
+        }
+    }
+
+    void
+    work(threadpool* pool, size_t index)
+    {
+        g_current_pool = pool;
+        g_worker_index = index;
+        std::function<void()> task;
+        for (;;) {
+            if (pop_own(index, task) || pop_injected(task) || steal(index, task)) {
+                execute(task);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_cond_.wait(lock, [this]() { return stop_ || n_queued_ > 0; });
+            if (stop_)
+                break;
+        }
+        g_current_pool = nullptr;
+    }
+
+};
+
+threadpool::threadpool(int n_threads)
+    : impl_(make_unique<impl>())
+{
+    if (n_threads < 1)
+        n_threads = 1;
+    for (int i=0; i<n_threads; ++i)
+        impl_->queues_.push_back(make_unique<impl::taskqueue>());
+    for (int i=0; i<n_threads; ++i)
+        impl_->threads_.push_back(std::thread(&impl::work, impl_.get(), this, i));
+}
+
+threadpool::~threadpool()
+{
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex_);
+        impl_->stop_ = true;
+    }
+    impl_->work_cond_.notify_all();
+    for (auto& thread : impl_->threads_)
+        thread.join();
+}
+
+void
+threadpool::push(std::function<void()> task)
+{
+    ++impl_->n_unfinished_;
+    {
+        auto& queue = g_current_pool==this ? *impl_->queues_[g_worker_index] : impl_->injected_;
+        std::lock_guard<std::mutex> lock(queue.mutex_);
+        queue.tasks_.push_back(std::move(task));
+        ++impl_->n_queued_;
+    }
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    impl_->work_cond_.notify_one();
+}
+
+void
+threadpool::wait()
+{
+    std::unique_lock<std::mutex> lock(impl_->mutex_);
+    impl_->done_cond_.wait(lock, [this]() { return impl_->n_unfinished_ == 0; });
+    if (impl_->exception_) {
+        auto exception = impl_->exception_;
+        impl_->exception_ = nullptr;
+        std::rethrow_exception(exception);
+    }
+}
+
+int
+threadpool::size() const
+{
+    return static_cast<int>(impl_->threads_.size());
+}
+
+threadpool*
+threadpool::current()
+{
+    return g_current_pool;
+}
+
+} // core
+} // unittest
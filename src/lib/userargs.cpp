@@ -11,7 +11,15 @@ userargs::userargs()
       handle_exceptions(true), dry_run(false), concurrent_threads(0), regex_filter(""),
       name_filter(""), test_name(""), timeout(-1), xml_filename("libunittest.xml"),
       disable_timeout(false), max_value_precision(-1), max_string_length(500),
-      suite_name("libunittest"), shuffle_seed(-1), ignore_skips(false), display_quote(false)
+      suite_name("libunittest"), shuffle_seed(-1), ignore_skips(false), display_quote(false),
+      parallel_methods(false), history_filename(""),
+      default_estimate(1), shard_index(0), shard_count(1), balance_filename(""),
+      isolate_classes(false), worker_processes(0), json_filename(""),
+      binary_filename(""), console_interval(0.1), ordered_output(false),
+      silent_output(false), resource_usage(false), perf_counters(false),
+      track_allocations(false), bench_time(0.01), bench_samples(10),
+      baseline_filename(""), save_baseline_filename(""), bench_threshold(0.05),
+      keep_timeouts(false)
 {
     register_trigger('v', "verbose", "Sets verbose output for running tests", verbose);
     register_trigger('d', "dry_run", "A dry run without actually executing any tests", dry_run);
@@ -21,7 +29,16 @@ userargs::userargs()
     register_trigger('k', "ignore_skips", "Runs tests regardless of whether they are skipped", ignore_skips);
     register_trigger('i', "no_timeouts", "Disables the measurement of any test timeouts", disable_timeout);
     register_trigger('q', "quote", "Displays a random quote and exits", display_quote);
+    register_trigger('m', "par_methods", "Runs the test methods of a class in parallel (with -p)", parallel_methods);
+    register_trigger('j', "isolate", "Runs each test class in its own child process", isolate_classes);
+    register_trigger('O', "ordered", "Writes the test results in registration order at the end", ordered_output);
+    register_trigger('S', "silent", "Writes no output for single tests, only the summary", silent_output);
+    register_trigger('R', "resources", "Accounts the resources used per test via getrusage and /proc", resource_usage);
+    register_trigger('H', "hw_counters", "Counts hardware events per test (see perf_event_paranoid)", perf_counters);
+    register_trigger('A', "allocs", "Tracks the heap allocations per test and reports leaks", track_allocations);
+    register_trigger('K', "keep", "Lets tests exceeding their timeout finish in the child process (with -j or -P)", keep_timeouts);
     register_argument('p', "number", "Runs tests in parallel with a given number of threads", concurrent_threads, false);
+    register_argument('P', "number", "Runs tests on a given number of worker processes", worker_processes, false);
     register_argument('n', "name", "A certain test to be run superseding any other run filter", test_name, false);
     register_argument('f', "string", "A run filter applied to the beginning of the test names", name_filter, false);
     register_argument('g', "regex", "A run filter based on regex applied to the test names", regex_filter, false);
@@ -30,7 +47,19 @@ userargs::userargs()
     register_argument('r', "precision", "The maximum displayed value precision", max_value_precision, false);
     register_argument('l', "length", "The maximum displayed string length", max_string_length, true);
     register_argument('o', "xmlfile", "The XML output file name", xml_filename, true);
+    register_argument('J', "jsonfile", "The JSON Lines event stream file name (e.g. /dev/fd/3)", json_filename, false);
+    register_argument('B', "binfile", "The binary results file name (see unittest-results)", binary_filename, false);
     register_argument('u', "suite", "The name of the test suite", suite_name, true);
+    register_argument('w', "histfile", "A file recording test durations across runs", history_filename, false);
+    register_argument('y', "shard", "Runs only the i-th of N shards of the test classes (i/N)", std::string(""), false);
+    register_argument('b', "snapfile", "A history file left unchanged by the shards to balance them by (with -y)", balance_filename, false);
+    register_argument('c', "interval", "The interval in seconds between writes of test results", console_interval, true);
+    register_argument('M', "benchtime", "The target time in seconds per benchmark sample", bench_time, true);
+    register_argument('N', "samples", "The number of samples per benchmark", bench_samples, true);
+    register_argument('E', "basefile", "A baseline file to compare the benchmarks against", baseline_filename, false);
+    register_argument('F', "basefile", "A baseline file to save the benchmarks to", save_baseline_filename, false);
+    register_argument('T', "threshold", "The relative slowdown of a benchmark failing it (with -E)", bench_threshold, true);
+    register_argument('a', "estimate", "The duration in seconds assumed for classes without history", default_estimate, true);
 }
 
 std::string
@@ -50,16 +79,49 @@ userargs::assign_values()
     assign_value(ignore_skips, 'k');
     assign_value(disable_timeout, 'i');
     assign_value(display_quote, 'q');
+    assign_value(parallel_methods, 'm');
+    assign_value(ordered_output, 'O');
+    assign_value(silent_output, 'S');
+    assign_value(resource_usage, 'R');
+    assign_value(perf_counters, 'H');
+    assign_value(track_allocations, 'A');
+    assign_value(isolate_classes, 'j');
+    assign_value(keep_timeouts, 'K');
     assign_value(concurrent_threads, 'p');
+    assign_value(worker_processes, 'P');
     assign_value(test_name, 'n');
     assign_value(name_filter, 'f');
     assign_value(regex_filter, 'g');
     assign_value(shuffle_seed, 'z');
     assign_value(timeout, 't');
     assign_value(xml_filename, 'o');
+    assign_value(json_filename, 'J');
+    assign_value(binary_filename, 'B');
     assign_value(max_string_length, 'l');
     assign_value(max_value_precision, 'r');
     assign_value(suite_name, 'u');
+    assign_value(history_filename, 'w');
+    assign_value(balance_filename, 'b');
+    assign_value(default_estimate, 'a');
+    assign_value(console_interval, 'c');
+    assign_value(bench_time, 'M');
+    assign_value(bench_samples, 'N');
+    assign_value(baseline_filename, 'E');
+    assign_value(save_baseline_filename, 'F');
+    assign_value(bench_threshold, 'T');
+    std::string shard;
+    assign_value(shard, 'y');
+    if (shard.size()) {
+        const auto separator = shard.find('/');
+        const auto index = shard.substr(0, separator);
+        const auto count = separator!=std::string::npos ? shard.substr(separator + 1) : "";
+        if (!is_numeric(index) || !is_numeric(count))
+            error(join("The value to '-y' must be of the form i/N, not: ", shard));
+        shard_index = to_number<int>(index);
+        shard_count = to_number<int>(count);
+        if (shard_count<1 || shard_index<0 || shard_index>=shard_count)
+            error(join("The value to '-y' must satisfy 0 <= i < N, not: ", shard));
+    }
 }
 
 void
@@ -67,7 +129,10 @@ userargs::post_parse()
 {
     if (was_used('o')) generate_xml = true;
     if (concurrent_threads<0) concurrent_threads = 0;
+    if (worker_processes<0) worker_processes = 0;
     if (max_string_length<10) max_string_length = 10;
+    if (bench_samples<1) bench_samples = 1;
+    if (bench_threshold<0) bench_threshold = 0;
     if (shuffle_seed==0) shuffle_seed = now().count() / 1000000;
 }
 
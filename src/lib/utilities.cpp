@@ -1,4 +1,6 @@
 #include "libunittest/utilities.hpp"
+#include "libunittest/threadpool.hpp"
+#include "libunittest/failuresink.hpp"
 #include <thread>
 #include <iostream>
 #include <mutex>
@@ -72,6 +74,35 @@ xml_escape(const std::string& data)
     return escaped;
 }
 
+std::string
+json_escape(const std::string& data)
+{
+    std::string escaped;
+    escaped.reserve(data.size());
+    for (auto& character : data) {
+        switch (character) {
+            case '\"':  escaped.append("\\\"");  break;
+            case '\\':  escaped.append("\\\\");  break;
+            case '\b':  escaped.append("\\b");   break;
+            case '\f':  escaped.append("\\f");   break;
+            case '\n':  escaped.append("\\n");   break;
+            case '\r':  escaped.append("\\r");   break;
+            case '\t':  escaped.append("\\t");   break;
+            default:
+                if (static_cast<unsigned char>(character) < 0x20) {
+                    const char* const digits = "0123456789abcdef";
+                    escaped.append("\\u00");
+                    escaped.append(1, digits[(character >> 4) & 0xf]);
+                    escaped.append(1, digits[character & 0xf]);
+                } else {
+                    escaped.append(1, character);
+                }
+                break;
+        }
+    }
+    return escaped;
+}
+
 std::string
 make_iso_timestamp(const std::chrono::system_clock::time_point& time_point,
                    bool local_time)
@@ -141,15 +172,8 @@ call_functions(const std::vector<std::function<void()>>& functions,
 
     int counter = 0;
     if (n_threads > 1 && n_runs > 1) {
-        while (counter < n_runs) {
-            if (n_threads > n_runs - counter)
-                n_threads = n_runs - counter;
-            std::vector<std::thread> threads(n_threads);
-            for (auto& thread : threads)
-                thread = std::thread(functions[counter++]);
-            for (auto& thread : threads)
-                thread.join();
-        }
+        threadpool pool(n_threads);
+        counter = call_functions(functions, pool);
     } else {
         for (auto& function : functions) {
             function();
@@ -160,6 +184,16 @@ call_functions(const std::vector<std::function<void()>>& functions,
     return counter;
 }
 
+int
+call_functions(const std::vector<std::function<void()>>& functions,
+               threadpool& pool)
+{
+    for (auto& function : functions)
+        pool.push(function);
+    pool.wait();
+    return functions.size();
+}
+
 std::string
 limit_string_length(const std::string& value,
                     int max_length)
@@ -185,6 +219,11 @@ string_of_tagged_text(const std::string& text, const std::string& tag)
     return id + text + id;
 }
 
+ndastag::operator std::string() const
+{
+    return string_of_tagged_text(sink ? sink->method_id() : "", "NDAS");
+}
+
 void
 make_threads_happy(std::ostream& stream,
                    std::vector<std::pair<std::thread, std::shared_ptr<std::atomic_bool>>>& threads,
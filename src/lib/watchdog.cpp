@@ -0,0 +1,231 @@
+#include "libunittest/watchdog.hpp"
+#include "libunittest/allocations.hpp"
+#include "libunittest/testsuite.hpp"
+#include "libunittest/testlog.hpp"
+#include "libunittest/testfailure.hpp"
+#include "libunittest/utilities.hpp"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <map>
+#include <vector>
+#include <algorithm>
+
+namespace unittest {
+namespace core {
+
+namespace {
+
+typedef std::chrono::steady_clock watchclock;
+
+struct teststate {
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    bool is_finished_;
+    bool is_expired_;
+    std::shared_ptr<std::atomic_bool> has_timed_out_;
+
+    explicit
+    teststate(std::shared_ptr<std::atomic_bool> has_timed_out)
+        : mutex_(), cond_(), is_finished_(false), is_expired_(false),
+          has_timed_out_(std::move(has_timed_out))
+    {}
+};
+
+struct cachedthread {
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::function<void()> test_;
+    bool is_retired_;
+
+    cachedthread()
+        : thread_(), mutex_(), cond_(), test_(), is_retired_(false)
+    {}
+};
+
+}
+
+struct watchdog::impl {
+
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::multimap<watchclock::time_point, std::shared_ptr<teststate>> deadlines_;
+    std::vector<std::shared_ptr<cachedthread>> threads_;
+    std::vector<std::shared_ptr<cachedthread>> idle_threads_;
+    std::thread watcher_;
+    bool stop_;
+
+    impl()
+        : mutex_(), cond_(), deadlines_(), threads_(), idle_threads_(),
+          watcher_(), stop_(false)
+    {}
+
+    void
+    watch()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stop_) {
+            if (deadlines_.empty()) {
+                cond_.wait(lock);
+                continue;
+            }
+            const auto next = deadlines_.begin();
+            if (watchclock::now() < next->first) {
+                cond_.wait_until(lock, next->first);
+                continue;
+            }
+            const auto state = next->second;
+            deadlines_.erase(next);
+            std::lock_guard<std::mutex> state_lock(state->mutex_);
+            if (!state->is_finished_) {
+                state->is_expired_ = true;
+                state->has_timed_out_->store(true);
+                state->cond_.notify_all();
+            }
+        }
+    }
+
+    void
+    work(std::shared_ptr<cachedthread> thread)
+    {
+        for (;;) {
+            std::function<void()> test;
+            {
+                std::unique_lock<std::mutex> lock(thread->mutex_);
+                thread->cond_.wait(lock, [&thread]() { return thread->test_ || thread->is_retired_; });
+                if (!thread->test_)
+                    return;
+                test = std::move(thread->test_);
+                thread->test_ = nullptr;
+            }
+            test();
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (thread->is_retired_)
+                return;
+            idle_threads_.push_back(thread);
+        }
+    }
+
+    std::shared_ptr<cachedthread>
+    acquire()
+    {
+        // the threads belong to the watchdog, not to the allocations of the test
+        allocationscope untracked(nullptr);
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!watcher_.joinable())
+            watcher_ = std::thread(&impl::watch, this);
+        if (!idle_threads_.empty()) {
+            auto thread = idle_threads_.back();
+            idle_threads_.pop_back();
+            return thread;
+        }
+        auto thread = std::make_shared<cachedthread>();
+        thread->thread_ = std::thread(&impl::work, this, thread);
+        threads_.push_back(thread);
+        return thread;
+    }
+
+    std::thread
+    retire(std::shared_ptr<cachedthread> thread)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        idle_threads_.erase(std::remove(idle_threads_.begin(), idle_threads_.end(), thread), idle_threads_.end());
+        threads_.erase(std::remove(threads_.begin(), threads_.end(), thread), threads_.end());
+        {
+            std::lock_guard<std::mutex> thread_lock(thread->mutex_);
+            thread->is_retired_ = true;
+        }
+        thread->cond_.notify_one();
+        return std::move(thread->thread_);
+    }
+
+};
+
+watchdog*
+watchdog::instance()
+{
+    allocationscope untracked(nullptr);
+    static watchdog instance_;
+    return &instance_;
+}
+
+watchdog::watchdog()
+    : impl_(make_unique<impl>())
+{}
+
+watchdog::~watchdog()
+{
+    std::vector<std::shared_ptr<cachedthread>> threads;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex_);
+        impl_->stop_ = true;
+        threads = impl_->threads_;
+    }
+    impl_->cond_.notify_all();
+    if (impl_->watcher_.joinable())
+        impl_->watcher_.join();
+    for (auto& thread : threads) {
+        {
+            std::lock_guard<std::mutex> lock(thread->mutex_);
+            thread->is_retired_ = true;
+        }
+        thread->cond_.notify_one();
+        thread->thread_.join();
+    }
+}
+
+void
+watchdog::run(std::function<void()> test,
+              std::shared_ptr<std::atomic_bool> done,
+              std::shared_ptr<std::atomic_bool> has_timed_out,
+              double timeout,
+              const testlog& log)
+{
+    auto state = std::make_shared<teststate>(has_timed_out);
+    auto thread = impl_->acquire();
+    {
+        std::lock_guard<std::mutex> lock(thread->mutex_);
+        thread->test_ = [test, state]() {
+            test();
+            std::lock_guard<std::mutex> lock(state->mutex_);
+            state->is_finished_ = true;
+            state->cond_.notify_all();
+        };
+    }
+    thread->cond_.notify_one();
+    const auto time = watchclock::now() + std::chrono::duration_cast<watchclock::duration>(std::chrono::duration<double>(timeout));
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex_);
+        const bool is_earliest = impl_->deadlines_.empty() || time < impl_->deadlines_.begin()->first;
+        impl_->deadlines_.insert(std::make_pair(time, state));
+        if (is_earliest)
+            impl_->cond_.notify_all();
+    }
+    bool is_expired;
+    {
+        std::unique_lock<std::mutex> lock(state->mutex_);
+        state->cond_.wait(lock, [&state]() { return state->is_finished_ || state->is_expired_; });
+        is_expired = state->is_expired_;
+    }
+    if (!is_expired) {
+        // drops the deadline right away instead of keeping the state until it passes
+        std::lock_guard<std::mutex> lock(impl_->mutex_);
+        const auto range = impl_->deadlines_.equal_range(time);
+        for (auto element=range.first; element!=range.second; ++element) {
+            if (element->second==state) {
+                impl_->deadlines_.erase(element);
+                break;
+            }
+        }
+    }
+    if (is_expired) {
+        auto suite = testsuite::instance();
+        suite->write_test_timeout(log);
+        suite->add_lonely_thread(impl_->retire(thread), done);
+    }
+}
+
+} // core
+} // unittest
@@ -0,0 +1,162 @@
+#include "libunittest/xmlreporter.hpp"
+#include "libunittest/testfailure.hpp"
+#include "libunittest/utilities.hpp"
+#include <sstream>
+#include <mutex>
+
+namespace unittest {
+namespace core {
+
+namespace {
+
+const std::streamoff g_max_buffer_size = 1 << 16;
+
+const std::chrono::microseconds g_flush_interval = std::chrono::seconds(1);
+
+const size_t g_tag_padding = 128;
+
+}
+
+struct xmlreporter::impl {
+
+    std::shared_ptr<std::ostream> stream_;
+    std::string suite_name_;
+    long long shuffle_seed_;
+    int shard_index_;
+    int shard_count_;
+    std::chrono::system_clock::time_point time_point_;
+    bool local_time_;
+    std::mutex mutex_;
+    std::ostringstream buffer_;
+    std::streampos tag_position_;
+    size_t tag_length_;
+    std::chrono::microseconds last_flush_;
+    bool finished_;
+    bool is_buffered_;
+    std::string properties_;
+
+    impl(std::shared_ptr<std::ostream> stream,
+         const std::string& suite_name,
+         long long shuffle_seed,
+         int shard_index,
+         int shard_count,
+         const std::chrono::system_clock::time_point& time_point,
+         bool local_time)
+        : stream_(std::move(stream)), suite_name_(suite_name),
+          shuffle_seed_(shuffle_seed), shard_index_(shard_index),
+          shard_count_(shard_count), time_point_(time_point),
+          local_time_(local_time), mutex_(), buffer_(), tag_position_(-1),
+          tag_length_(0), last_flush_(now()), finished_(false),
+          is_buffered_(false), properties_()
+    {
+        buffer_.setf(std::ios_base::fixed);
+    }
+
+    std::string
+    make_tag(const testresults& results)
+    {
+        std::ostringstream tag;
+        tag.setf(std::ios_base::fixed);
+        write_xml_testsuite_tag(tag, results, suite_name_, shuffle_seed_,
+                                shard_index_, shard_count_, time_point_, local_time_);
+        return tag.str();
+    }
+
+    void
+    write_head(const std::string& tag,
+               size_t padding)
+    {
+        *stream_ << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>";
+        *stream_ << "\n";
+        tag_position_ = stream_->tellp();
+        *stream_ << tag << std::string(padding, ' ') << ">";
+        *stream_ << "\n";
+        *stream_ << properties_;
+    }
+
+    void
+    flush()
+    {
+        const auto data = buffer_.str();
+        stream_->write(data.data(), data.size());
+        stream_->flush();
+        buffer_.str("");
+        last_flush_ = now();
+    }
+
+};
+
+xmlreporter::xmlreporter(std::shared_ptr<std::ostream> stream,
+                         const std::string& suite_name,
+                         long long shuffle_seed,
+                         int shard_index,
+                         int shard_count,
+                         const std::chrono::system_clock::time_point& time_point,
+                         bool local_time,
+                         const std::vector<std::pair<std::string, std::string>>& properties)
+    : impl_(unittest::core::make_unique<impl>(std::move(stream), suite_name, shuffle_seed,
+                                              shard_index, shard_count, time_point, local_time))
+{
+    std::ostringstream text;
+    write_xml_properties(text, properties);
+    impl_->properties_ = text.str();
+    // the totals cannot be filled in later without seeking, e.g. in a pipe
+    impl_->is_buffered_ = impl_->stream_->tellp() < 0;
+    if (impl_->is_buffered_)
+        return;
+    const auto tag = impl_->make_tag(testresults());
+    impl_->tag_length_ = tag.size() + g_tag_padding;
+    impl_->write_head(tag, g_tag_padding);
+    impl_->stream_->flush();
+}
+
+xmlreporter::~xmlreporter()
+{
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    if (impl_->finished_)
+        return;
+    if (impl_->is_buffered_)
+        impl_->write_head(impl_->make_tag(testresults()), 0);
+    impl_->flush();
+}
+
+void
+xmlreporter::report(const testlog& log)
+{
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    if (impl_->finished_)
+        return;
+    write_xml_testcase(impl_->buffer_, log);
+    if (impl_->is_buffered_)
+        return;
+    if (impl_->buffer_.tellp() > g_max_buffer_size || now() - impl_->last_flush_ >= g_flush_interval)
+        impl_->flush();
+}
+
+void
+xmlreporter::finish(const testresults& results)
+{
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    if (impl_->finished_)
+        return;
+    impl_->finished_ = true;
+    impl_->buffer_ << "</testsuite>";
+    impl_->buffer_ << "\n";
+    const auto tag = impl_->make_tag(results);
+    if (impl_->is_buffered_) {
+        impl_->write_head(tag, 0);
+        impl_->flush();
+        return;
+    }
+    impl_->flush();
+    const auto end = impl_->stream_->tellp();
+    if (impl_->tag_position_ < 0 || end < 0 || tag.size() > impl_->tag_length_)
+        return;
+    impl_->stream_->seekp(impl_->tag_position_);
+    *impl_->stream_ << tag << std::string(impl_->tag_length_ - tag.size(), ' ');
+    impl_->stream_->seekp(end);
+    impl_->stream_->flush();
+}
+
+} // core
+} // unittest
@@ -0,0 +1,213 @@
+/**
+ * @brief Converts, concatenates, and merges results files
+ * @file unittest_results.cpp
+ */
+#include <libunittest/argparser.hpp>
+#include <libunittest/binresults.hpp>
+#include <libunittest/resultmerge.hpp>
+#include <libunittest/xmlreporter.hpp>
+#include <libunittest/testresults.hpp>
+#include <libunittest/testfailure.hpp>
+#include <iostream>
+#include <fstream>
+#include <memory>
+#include <algorithm>
+
+namespace {
+
+struct resultsargs : unittest::core::argparser {
+
+    resultsargs()
+        : format("summary"), output(""), merge(false), inputs()
+    {
+        register_trigger('m', "merge", "Merges XML or binary results by test name, keeping the last run of retried tests", merge);
+        register_argument('f', "format", "The output format (summary, errors, xml, binary)", format, true);
+        register_argument('o', "file", "The output file name (defaults to standard output)", output, false);
+    }
+
+    std::string format;
+    std::string output;
+    bool merge;
+    std::vector<std::string> inputs;
+
+private:
+
+    std::string
+    app_name()
+    {
+        return "unittest-results";
+    }
+
+    std::string
+    description()
+    {
+        return "Converts one or more binary results files, concatenated in the given order,\n"
+               "or merges XML and binary results files of sharded or retried runs (with -m)";
+    }
+
+    void
+    assign_values()
+    {
+        assign_value(format, 'f');
+        assign_value(output, 'o');
+        assign_value(merge, 'm');
+        inputs = take_positionals();
+    }
+
+    void
+    post_parse()
+    {
+        if (format!="summary" && format!="errors" && format!="xml" && format!="binary")
+            error("The value to '-f' must be one of summary, errors, xml, binary, not: " + format);
+        if ((format=="binary" || (merge && format=="xml")) && output.empty())
+            error(unittest::join("The ", format, " format requires an output file given by '-o'", merge ? " when merging" : ""));
+        if (inputs.empty())
+            error("No input files given");
+    }
+
+};
+
+void
+add_totals(unittest::core::testresults& results,
+           const unittest::core::testresults& other)
+{
+    results.successful = results.successful && other.successful;
+    results.n_tests += other.n_tests;
+    results.n_successes += other.n_successes;
+    results.n_failures += other.n_failures;
+    results.n_errors += other.n_errors;
+    results.n_skipped += other.n_skipped;
+    results.n_timeouts += other.n_timeouts;
+    results.duration += other.duration;
+}
+
+int
+merge(const resultsargs& args)
+{
+    std::vector<std::unique_ptr<unittest::core::resultsource>> sources;
+    for (const auto& input : args.inputs)
+        sources.push_back(unittest::core::open_resultsource(input));
+    unittest::core::resultmerger merger(std::move(sources));
+    const auto& shards = merger.shards();
+    auto time_point = shards.front().time_point;
+    for (const auto& shard : shards)
+        time_point = std::min(time_point, shard.time_point);
+    const auto& suite_name = shards.front().suite_name;
+
+    std::shared_ptr<unittest::core::testreporter> reporter;
+    std::shared_ptr<unittest::core::binwriter> writer;
+    if (args.format=="xml") {
+        auto output = std::make_shared<std::ofstream>(args.output.c_str(), std::ios::binary);
+        reporter = std::make_shared<unittest::core::xmlreporter>(output, suite_name, -1, 0, 1, time_point, true,
+                                                                 unittest::core::make_shard_properties(shards));
+    } else if (args.format=="binary") {
+        auto output = std::make_shared<std::ofstream>(args.output.c_str(), std::ios::binary);
+        writer = std::make_shared<unittest::core::binwriter>(output, suite_name, -1, 0, 1, time_point);
+        reporter = writer;
+    }
+    // only failing logs are kept in memory to write the error info, binary
+    // records are copied and the summary needs no test logs at all
+    std::vector<unittest::core::testlog> failed;
+    if (writer) {
+        while (merger.next(*writer));
+    } else if (args.format=="summary") {
+        while (merger.skip());
+    } else {
+        unittest::core::testlog log;
+        while (merger.next(log)) {
+            if (reporter)
+                reporter->report(log);
+            else if (!log.successful)
+                failed.push_back(std::move(log));
+        }
+    }
+    const auto results = merger.totals();
+    if (reporter) {
+        reporter->finish(results);
+    } else {
+        std::unique_ptr<std::ofstream> file;
+        if (!args.output.empty())
+            file.reset(new std::ofstream(args.output.c_str(), std::ios::binary));
+        std::ostream& stream = file ? *file : std::cout;
+        if (args.format=="summary")
+            unittest::core::write_summary(stream, results, -1);
+        else
+            unittest::core::write_error_info(stream, failed, results.successful);
+    }
+    if (merger.n_retried() > 0)
+        std::cerr << "Dropped " << merger.n_retried() << " earlier runs of retried tests" << std::endl;
+    return results.successful ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int
+convert(const resultsargs& args)
+{
+    const bool is_single = args.inputs.size()==1;
+    std::unique_ptr<unittest::core::binreader> first(new unittest::core::binreader(args.inputs.front()));
+    const auto suite_name = first->suite_name();
+    const auto shuffle_seed = first->shuffle_seed();
+    const auto shard_index = is_single ? first->shard_index() : 0;
+    const auto shard_count = is_single ? first->shard_count() : 1;
+    const auto time_point = first->time_point();
+    first.reset();
+
+    unittest::core::testresults results;
+    if (args.format=="binary") {
+        // copies the records such that only one input is mapped at a time
+        auto output = std::make_shared<std::ofstream>(args.output.c_str(), std::ios::binary);
+        unittest::core::binwriter writer(output, suite_name, shuffle_seed, shard_index, shard_count, time_point);
+        for (const auto& input : args.inputs) {
+            unittest::core::binreader reader(input);
+            writer.append(reader);
+            add_totals(results, reader.totals());
+        }
+        writer.finish(results);
+        return results.successful ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    for (const auto& input : args.inputs) {
+        unittest::core::binreader reader(input);
+        if (args.format=="summary") {
+            add_totals(results, reader.totals());
+        } else {
+            auto part = reader.results();
+            add_totals(results, part);
+            results.testlogs.insert(results.testlogs.end(),
+                                    std::make_move_iterator(part.testlogs.begin()),
+                                    std::make_move_iterator(part.testlogs.end()));
+        }
+    }
+    std::unique_ptr<std::ofstream> file;
+    if (!args.output.empty())
+        file.reset(new std::ofstream(args.output.c_str(), std::ios::binary));
+    std::ostream& stream = file ? *file : std::cout;
+    if (args.format=="summary")
+        unittest::core::write_summary(stream, results, shuffle_seed);
+    else if (args.format=="errors")
+        unittest::core::write_error_info(stream, results.testlogs, results.successful);
+    else
+        unittest::core::write_xml(stream, results, suite_name, shuffle_seed, time_point, true, shard_index, shard_count);
+    return results.successful ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    resultsargs args;
+    try {
+        args.parse(argc, argv);
+    } catch (const unittest::core::argparser::exit_success& e) {
+        std::cout << e.what();
+        return EXIT_SUCCESS;
+    } catch (const unittest::core::argparser::exit_error& e) {
+        std::cout << "Error: " << e.what();
+        return EXIT_FAILURE;
+    }
+    try {
+        return args.merge ? merge(args) : convert(args);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 2;
+    }
+}
@@ -0,0 +1,173 @@
+#include <libunittest/all.hpp>
+#include <new>
+#include <cstdlib>
+#include <thread>
+using namespace unittest::assertions;
+using unittest::core::allocationcounts;
+using unittest::core::allocationscope;
+
+struct test_allocations : unittest::testcase<> {
+
+    static void run()
+    {
+        UNITTEST_CLASS(test_allocations)
+        UNITTEST_RUN(test_defaults)
+        UNITTEST_RUN(test_count_allocations)
+        UNITTEST_RUN(test_peak_bytes)
+        UNITTEST_RUN(test_live_bytes)
+        UNITTEST_RUN(test_freed_by_other_thread)
+        UNITTEST_RUN(test_nested_scopes)
+        UNITTEST_RUN(test_no_counts)
+        UNITTEST_RUN(test_address_space_limit)
+    }
+
+    void test_defaults()
+    {
+        const allocationcounts counts;
+        assert_false(counts.measured, SPOT);
+        assert_equal(0, counts.count, SPOT);
+        assert_equal(0, counts.bytes, SPOT);
+        assert_equal(0, counts.peak_bytes, SPOT);
+        assert_equal(0, counts.live_bytes, SPOT);
+    }
+
+    void test_count_allocations()
+    {
+        if (!unittest::core::is_allocation_tracking_supported())
+            return;
+        allocationcounts counts;
+        {
+            allocationscope scope(&counts);
+            void* first = ::operator new(100);
+            void* second = ::operator new[](50, std::nothrow);
+            ::operator delete[](second);
+            ::operator delete(first);
+        }
+        assert_true(counts.measured, SPOT);
+        assert_equal(2, counts.count, SPOT);
+        assert_greater_equal(counts.bytes, 150, SPOT);
+        assert_equal(0, counts.live_bytes, SPOT);
+    }
+
+    void test_peak_bytes()
+    {
+        if (!unittest::core::is_allocation_tracking_supported())
+            return;
+        allocationcounts counts;
+        {
+            allocationscope scope(&counts);
+            for (int i=0; i<3; ++i)
+                ::operator delete(::operator new(1000));
+        }
+        assert_equal(3, counts.count, SPOT);
+        assert_greater_equal(counts.peak_bytes, 1000, SPOT);
+        assert_lesser(counts.peak_bytes, 2000, SPOT);
+        assert_equal(0, counts.live_bytes, SPOT);
+    }
+
+    void test_live_bytes()
+    {
+        if (!unittest::core::is_allocation_tracking_supported())
+            return;
+        allocationcounts counts;
+        void* pointer;
+        {
+            allocationscope scope(&counts);
+            pointer = ::operator new(64);
+        }
+        assert_greater_equal(counts.live_bytes, 64, SPOT);
+        ::operator delete(pointer);
+        assert_greater_equal(counts.live_bytes, 64, SPOT);
+        {
+            allocationscope scope(&counts);
+            pointer = ::operator new(64);
+        }
+        allocationcounts other;
+        {
+            allocationscope scope(&other);
+            ::operator delete(pointer);
+        }
+        assert_equal(0, other.count, SPOT);
+        assert_equal(0, other.live_bytes, SPOT);
+        assert_greater_equal(counts.live_bytes, 128, SPOT);
+    }
+
+    void test_freed_by_other_thread()
+    {
+        if (!unittest::core::is_allocation_tracking_supported())
+            return;
+        allocationcounts counts;
+        void* pointer;
+        {
+            unittest::core::allocationowner owner(&counts);
+            {
+                allocationscope scope(&counts);
+                pointer = ::operator new(64);
+                ::operator delete(::operator new(32));
+            }
+            std::thread thread([pointer]() { ::operator delete(pointer); });
+            thread.join();
+            assert_equal(64, counts.live_bytes, SPOT);
+        }
+        assert_equal(2, counts.count, SPOT);
+        assert_equal(96, counts.bytes, SPOT);
+        assert_equal(0, counts.live_bytes, SPOT);
+        {
+            allocationscope scope(&counts);
+            pointer = ::operator new(16);
+        }
+        std::thread thread([pointer]() { ::operator delete(pointer); });
+        thread.join();
+        assert_equal(16, counts.live_bytes, SPOT);
+    }
+
+    void test_nested_scopes()
+    {
+        if (!unittest::core::is_allocation_tracking_supported())
+            return;
+        allocationcounts outer;
+        allocationcounts inner;
+        {
+            allocationscope outer_scope(&outer);
+            ::operator delete(::operator new(10));
+            {
+                allocationscope inner_scope(&inner);
+                ::operator delete(::operator new(10));
+                ::operator delete(::operator new(10));
+            }
+            ::operator delete(::operator new(10));
+        }
+        assert_equal(2, outer.count, SPOT);
+        assert_equal(2, inner.count, SPOT);
+    }
+
+    void test_no_counts()
+    {
+        allocationcounts counts;
+        {
+            allocationscope scope(&counts);
+            {
+                allocationscope untracked(nullptr);
+                ::operator delete(::operator new(10));
+            }
+        }
+        assert_equal(0, counts.count, SPOT);
+        assert_equal(0, counts.live_bytes, SPOT);
+    }
+
+    void test_address_space_limit()
+    {
+        // only isolated children get their address space limited
+        if (unittest::core::is_isolated_child())
+            return;
+        void* pointer;
+        {
+            unittest::core::addressspacelimit limit(1);
+            pointer = std::malloc(256 << 20);
+        }
+        assert_true(pointer!=nullptr, SPOT);
+        std::free(pointer);
+    }
+
+};
+REGISTER(test_allocations)
@@ -40,6 +40,23 @@ private:
 };
 
 
+struct client_positionals : argparser {
+    client_positionals()
+        : a(0), files()
+    {
+        register_argument('a', "aa", "aaa", a, true);
+    }
+    double a;
+    std::vector<std::string> files;
+private:
+    void assign_values()
+    {
+        assign_value(a, 'a');
+        files = take_positionals();
+    }
+};
+
+
 struct client_bad1 : argparser {
     client_bad1()
         : a(0)
@@ -104,6 +121,7 @@ struct test_argparser : unittest::testcase<> {
         UNITTEST_RUN(test_real_client_with_double_args_at_end)
         UNITTEST_RUN(test_real_client_with_missing_value)
         UNITTEST_RUN(test_real_client_with_wrong_value)
+        UNITTEST_RUN(test_client_positionals)
         UNITTEST_RUN(test_client_bad1)
         UNITTEST_RUN(test_client_bad2)
         UNITTEST_RUN(test_client_bad3)
@@ -264,6 +282,23 @@ struct test_argparser : unittest::testcase<> {
         assert_equal(true, client.c, SPOT);
     }
 
+    void test_client_positionals()
+    {
+        client_positionals client;
+        argv_[1] = (char*)"one";
+        argv_[2] = (char*)"-a";
+        argv_[3] = (char*)"-2";
+        argv_[4] = (char*)"two";
+        client.parse(5, argv_);
+        assert_equal(-2, client.a, SPOT);
+        assert_equal_containers(std::vector<std::string>{"one", "two"}, client.files, SPOT);
+        client_real real;
+        argv_[1] = (char*)"-b";
+        argv_[2] = (char*)"1";
+        argv_[3] = (char*)"one";
+        assert_throw<argparser::exit_error>([&](){ real.parse(4, argv_); }, SPOT);
+    }
+
     void test_real_client_with_double_args()
     {
         client_real client;
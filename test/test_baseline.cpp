@@ -0,0 +1,160 @@
+#include <libunittest/all.hpp>
+#include <cstdio>
+#include <fstream>
+using namespace unittest::assertions;
+using unittest::core::benchbaseline;
+using unittest::core::benchcomparison;
+
+struct test_baseline : unittest::testcase<> {
+
+    static void run()
+    {
+        UNITTEST_CLASS(test_baseline)
+        UNITTEST_RUN(test_comparison_defaults)
+        UNITTEST_RUN(test_mann_whitney_slower)
+        UNITTEST_RUN(test_mann_whitney_faster)
+        UNITTEST_RUN(test_mann_whitney_ties)
+        UNITTEST_RUN(test_mann_whitney_empty)
+        UNITTEST_RUN(test_compare_regressed)
+        UNITTEST_RUN(test_compare_within_threshold)
+        UNITTEST_RUN(test_compare_not_significant)
+        UNITTEST_RUN(test_record_and_find)
+        UNITTEST_RUN(test_save_and_load)
+        UNITTEST_RUN(test_load_missing_file)
+    }
+
+    std::string filename_;
+
+    test_baseline()
+        : filename_(unittest::join("test_baseline_", unittest::core::now().count(), ".base"))
+    {}
+
+    ~test_baseline()
+    {
+        std::remove(filename_.c_str());
+    }
+
+    static std::vector<double>
+    make_samples(double value, double step)
+    {
+        std::vector<double> samples;
+        for (int i=0; i<10; ++i)
+            samples.push_back(value + i * step);
+        return samples;
+    }
+
+    void test_comparison_defaults()
+    {
+        const benchcomparison comparison;
+        assert_false(comparison.compared, SPOT);
+        assert_equal(0, comparison.baseline_median, SPOT);
+        assert_equal(0, comparison.ratio, SPOT);
+        assert_equal(1, comparison.p_value, SPOT);
+        assert_false(comparison.regressed, SPOT);
+    }
+
+    void test_mann_whitney_slower()
+    {
+        const auto p = unittest::core::mann_whitney_p_value(make_samples(1, 0.01), make_samples(2, 0.01));
+        assert_in_range(p, 5e-5, 2e-4, SPOT);
+    }
+
+    void test_mann_whitney_faster()
+    {
+        const auto p = unittest::core::mann_whitney_p_value(make_samples(2, 0.01), make_samples(1, 0.01));
+        assert_greater(p, 0.999, SPOT);
+    }
+
+    void test_mann_whitney_ties()
+    {
+        assert_equal(1, unittest::core::mann_whitney_p_value(make_samples(1, 0), make_samples(1, 0)), SPOT);
+        const auto p = unittest::core::mann_whitney_p_value(make_samples(1, 0.01), make_samples(1, 0.01));
+        assert_in_range(p, 0.4, 0.6, SPOT);
+    }
+
+    void test_mann_whitney_empty()
+    {
+        assert_equal(1, unittest::core::mann_whitney_p_value({}, make_samples(1, 0.01)), SPOT);
+        assert_equal(1, unittest::core::mann_whitney_p_value(make_samples(1, 0.01), {}), SPOT);
+    }
+
+    void test_compare_regressed()
+    {
+        const auto comparison = unittest::core::compare_benchmark(make_samples(1, 0.01), make_samples(1.2, 0.01), 0.05, 0.01);
+        assert_true(comparison.compared, SPOT);
+        assert_approx_equal(1.045, comparison.baseline_median, 1e-9, SPOT);
+        assert_approx_equal(1.245 / 1.045, comparison.ratio, 1e-9, SPOT);
+        assert_lesser(comparison.p_value, 0.01, SPOT);
+        assert_true(comparison.regressed, SPOT);
+    }
+
+    void test_compare_within_threshold()
+    {
+        const auto comparison = unittest::core::compare_benchmark(make_samples(1, 0.01), make_samples(1.2, 0.01), 0.5, 0.01);
+        assert_true(comparison.compared, SPOT);
+        assert_lesser(comparison.p_value, 0.01, SPOT);
+        assert_false(comparison.regressed, SPOT);
+    }
+
+    void test_compare_not_significant()
+    {
+        auto samples = make_samples(1, 0.1);
+        samples[9] = 10;
+        samples[8] = 9;
+        const auto comparison = unittest::core::compare_benchmark(make_samples(1, 0.1), samples, 0.05, 0.01);
+        assert_greater(comparison.p_value, 0.01, SPOT);
+        assert_false(comparison.regressed, SPOT);
+        const auto none = unittest::core::compare_benchmark({}, samples, 0.05, 0.01);
+        assert_false(none.compared, SPOT);
+    }
+
+    void test_record_and_find()
+    {
+        benchbaseline baseline;
+        assert_equal(0u, baseline.size(), SPOT);
+        assert_true(baseline.find("peter::bench")==nullptr, SPOT);
+        baseline.record("peter::bench", {1, 2});
+        baseline.record("peter::bench", {3});
+        baseline.record("peter::empty", {});
+        assert_equal(1u, baseline.size(), SPOT);
+        const auto samples = baseline.find("peter::bench");
+        assert_true(samples!=nullptr, SPOT);
+        assert_equal(1u, samples->size(), SPOT);
+        assert_equal(3, samples->at(0), SPOT);
+    }
+
+    void test_save_and_load()
+    {
+        {
+            benchbaseline baseline;
+            baseline.record("peter::bench", {1.5e-9, 2.25e-9});
+            baseline.record("paul::bench", {0.125});
+            assert_true(baseline.save(filename_), SPOT);
+        }
+        benchbaseline baseline;
+        baseline.load(filename_);
+        assert_equal(2u, baseline.size(), SPOT);
+        const auto peter = baseline.find("peter::bench");
+        assert_true(peter!=nullptr, SPOT);
+        assert_equal(2u, peter->size(), SPOT);
+        assert_equal(1.5e-9, peter->at(0), SPOT);
+        assert_equal(2.25e-9, peter->at(1), SPOT);
+        const auto paul = baseline.find("paul::bench");
+        assert_true(paul!=nullptr, SPOT);
+        assert_equal(1u, paul->size(), SPOT);
+        assert_equal(0.125, paul->at(0), SPOT);
+        std::ifstream file(filename_);
+        std::string header;
+        std::getline(file, header);
+        assert_equal("# libunittest baseline 1", header, SPOT);
+    }
+
+    void test_load_missing_file()
+    {
+        benchbaseline baseline;
+        baseline.load(filename_ + ".missing");
+        assert_equal(0u, baseline.size(), SPOT);
+    }
+
+};
+REGISTER(test_baseline)
@@ -0,0 +1,231 @@
+#include <libunittest/all.hpp>
+#include <thread>
+#include <chrono>
+#include <cmath>
+using namespace unittest::assertions;
+using unittest::core::benchresult;
+using unittest::complexity;
+
+struct test_benchmark : unittest::testcase<> {
+
+    static void run()
+    {
+        UNITTEST_CLASS(test_benchmark)
+        UNITTEST_RUN(test_make_benchresult)
+        UNITTEST_RUN(test_make_benchresult_even)
+        UNITTEST_RUN(test_make_benchresult_empty)
+        UNITTEST_RUN(test_state_iterations)
+        UNITTEST_RUN(test_state_pause_timing)
+        UNITTEST_RUN(test_measure_benchmark)
+        UNITTEST_RUN(test_state_range)
+        UNITTEST_RUN(test_complexity_names)
+        UNITTEST_RUN(test_make_range)
+        UNITTEST_RUN(test_fit_complexity)
+        UNITTEST_RUN(test_fits_complexity)
+        UNITTEST_RUN(test_fit_complexity_empty)
+        UNITTEST_RUN(test_measure_sweep)
+        UNITTEST_RUN(test_assert_complexity)
+    }
+
+    void test_make_benchresult()
+    {
+        const auto result = unittest::core::make_benchresult({3, 1, 2}, 100, 8);
+        assert_true(result.measured, SPOT);
+        assert_equal(100, result.iterations, SPOT);
+        assert_equal(3u, result.samples.size(), SPOT);
+        assert_equal(3, result.samples[0], SPOT);
+        assert_equal(2, result.mean, SPOT);
+        assert_equal(2, result.median, SPOT);
+        assert_equal(1, result.stddev, SPOT);
+        assert_equal(1, result.min, SPOT);
+        assert_equal(0.5, result.throughput, SPOT);
+        assert_equal(4, result.bytes_per_second, SPOT);
+    }
+
+    void test_make_benchresult_even()
+    {
+        const auto result = unittest::core::make_benchresult({4, 1, 2, 5}, 1, 0);
+        assert_equal(3, result.mean, SPOT);
+        assert_equal(3, result.median, SPOT);
+        assert_equal(1, result.min, SPOT);
+        assert_equal(0, result.bytes_per_second, SPOT);
+    }
+
+    void test_make_benchresult_empty()
+    {
+        const auto result = unittest::core::make_benchresult({}, 10, 0);
+        assert_false(result.measured, SPOT);
+        assert_false(benchresult().measured, SPOT);
+    }
+
+    void test_state_iterations()
+    {
+        unittest::benchstate state(5);
+        int count = 0;
+        while (state.keep_running())
+            ++count;
+        assert_equal(5, count, SPOT);
+        assert_equal(5, state.iterations(), SPOT);
+        assert_false(state.keep_running(), SPOT);
+        assert_greater_equal(state.elapsed(), 0, SPOT);
+    }
+
+    void test_state_pause_timing()
+    {
+        const int iterations = 3;
+        const double pause = 0.005;
+        unittest::benchstate state(iterations);
+        while (state.keep_running()) {
+            state.pause_timing();
+            std::this_thread::sleep_for(std::chrono::duration<double>(pause));
+            state.resume_timing();
+        }
+        // less than half of the time slept while paused
+        assert_lesser(state.elapsed(), pause * iterations / 2, SPOT);
+    }
+
+    void test_measure_benchmark()
+    {
+        long long total = 0;
+        const auto result = unittest::core::measure_benchmark([&total](unittest::benchstate& state) {
+            state.set_bytes_per_iteration(sizeof(long long));
+            long long sum = 0;
+            while (state.keep_running()) {
+                sum += state.iterations();
+                unittest::do_not_optimize(sum);
+            }
+            unittest::clobber_memory();
+            total += sum;
+        }, 0.001, 3);
+        assert_true(result.measured, SPOT);
+        assert_equal(3u, result.samples.size(), SPOT);
+        assert_greater(result.iterations, 1, SPOT);
+        assert_greater(total, 0, SPOT);
+        assert_greater(result.mean, 0, SPOT);
+        assert_greater_equal(result.mean, result.min, SPOT);
+        assert_greater(result.throughput, 0, SPOT);
+        assert_greater(result.bytes_per_second, 0, SPOT);
+    }
+
+    void test_state_range()
+    {
+        assert_equal(0, unittest::benchstate(1).range(), SPOT);
+        unittest::benchstate state(2, 1024);
+        assert_equal(1024, state.range(), SPOT);
+        assert_equal(2, state.iterations(), SPOT);
+    }
+
+    void test_complexity_names()
+    {
+        assert_equal("O(1)", unittest::core::complexity_name(complexity::constant), SPOT);
+        assert_equal("O(n log n)", unittest::core::complexity_name(complexity::linearithmic), SPOT);
+        for (auto value : {complexity::constant, complexity::logarithmic, complexity::linear,
+                           complexity::linearithmic, complexity::quadratic}) {
+            complexity parsed = complexity::constant;
+            assert_true(unittest::core::complexity_from_name(unittest::core::complexity_name(value), parsed), SPOT);
+            assert_true(value==parsed, SPOT);
+        }
+        complexity parsed = complexity::linear;
+        assert_false(unittest::core::complexity_from_name("O(2^n)", parsed), SPOT);
+        assert_true(parsed==complexity::linear, SPOT);
+    }
+
+    void test_make_range()
+    {
+        const auto ranges = unittest::core::make_range(1, 1 << 24, 2);
+        assert_equal(25u, ranges.size(), SPOT);
+        assert_equal(1, ranges.front(), SPOT);
+        assert_equal(1 << 24, ranges.back(), SPOT);
+        const std::vector<long long> expected = {8, 64, 512, 1000};
+        assert_true(expected==unittest::core::make_range(8, 1000, 8), SPOT);
+        const std::vector<long long> single = {5};
+        assert_true(single==unittest::core::make_range(5, 5, 2), SPOT);
+        assert_true(single==unittest::core::make_range(5, 1, 2), SPOT);
+        assert_equal(1, unittest::core::make_range(0, 4, 0).front(), SPOT);
+        assert_equal(3u, unittest::core::make_range(0, 4, 0).size(), SPOT);
+    }
+
+    void test_fit_complexity()
+    {
+        const auto ranges = unittest::core::make_range(1, 1 << 20, 2);
+        for (auto value : {complexity::constant, complexity::logarithmic, complexity::linear,
+                           complexity::linearithmic, complexity::quadratic}) {
+            std::vector<double> times;
+            for (auto range : ranges) {
+                const double n = static_cast<double>(range);
+                const double log_n = std::max(std::log2(n), 1.);
+                const double f[] = {1, log_n, n, n * log_n, n * n};
+                // some overhead and noise on top of the exact function
+                const double noise = (times.size() % 2 ? 1.05 : 0.95);
+                times.push_back(1e-11 + 2e-9 * f[static_cast<unsigned int>(value)] * noise);
+            }
+            const auto sweep = unittest::core::fit_complexity(ranges, times);
+            assert_true(sweep.measured, SPOT);
+            assert_equal(unittest::core::complexity_name(value), unittest::core::complexity_name(sweep.best_fit), SPOT);
+            assert_equal(ranges.size(), sweep.ranges.size(), SPOT);
+            assert_greater(sweep.coefficient, 0, SPOT);
+            assert_lesser(sweep.rms, 0.1, SPOT);
+            assert_true(unittest::core::fits_complexity(sweep, value), SPOT);
+        }
+        const auto exact = unittest::core::fit_complexity({1, 2, 4}, {3e-9, 6e-9, 12e-9});
+        assert_true(exact.best_fit==complexity::linear, SPOT);
+        assert_approx_equal(3e-9, exact.coefficient, 1e-15, SPOT);
+        assert_approx_equal(0, exact.rms, 1e-9, SPOT);
+    }
+
+    void test_fits_complexity()
+    {
+        const auto ranges = unittest::core::make_range(64, 1 << 16, 2);
+        std::vector<double> linear;
+        std::vector<double> linearithmic;
+        for (auto range : ranges) {
+            const double n = static_cast<double>(range);
+            // leaving a cache level makes every element about a third slower
+            linear.push_back(1e-9 * n * (range >= (1 << 13) ? 1.3 : 1.));
+            linearithmic.push_back(1e-9 * n * std::log2(n));
+        }
+        const auto sweep = unittest::core::fit_complexity(ranges, linear);
+        assert_true(unittest::core::fits_complexity(sweep, complexity::linear), SPOT);
+        assert_false(unittest::core::fits_complexity(sweep, complexity::quadratic), SPOT);
+        assert_false(unittest::core::fits_complexity(sweep, complexity::constant), SPOT);
+        const auto sweep2 = unittest::core::fit_complexity(ranges, linearithmic);
+        assert_true(sweep2.best_fit==complexity::linearithmic, SPOT);
+        assert_greater(unittest::core::complexity_error(sweep2, complexity::linear), 0.2, SPOT);
+        assert_false(unittest::core::fits_complexity(sweep2, complexity::linear), SPOT);
+        assert_false(unittest::core::fits_complexity(unittest::core::sweepresult(), complexity::constant), SPOT);
+    }
+
+    void test_fit_complexity_empty()
+    {
+        assert_false(unittest::core::fit_complexity({}, {}).measured, SPOT);
+        assert_false(unittest::core::fit_complexity({1, 2}, {}).measured, SPOT);
+        assert_false(unittest::core::sweepresult().measured, SPOT);
+    }
+
+    void test_measure_sweep()
+    {
+        std::vector<long long> seen;
+        const auto sweep = unittest::core::measure_sweep([&seen](unittest::benchstate& state) {
+            if (seen.empty() || seen.back()!=state.range())
+                seen.push_back(state.range());
+            while (state.keep_running())
+                unittest::do_not_optimize(state.range());
+        }, {1, 4, 16}, 0.0001, 2);
+        assert_true(sweep.measured, SPOT);
+        assert_equal(3u, sweep.times.size(), SPOT);
+        const std::vector<long long> expected = {1, 4, 16};
+        assert_true(expected==seen, SPOT);
+        assert_greater(sweep.times[0], 0, SPOT);
+    }
+
+    void test_assert_complexity()
+    {
+        const auto sweep = unittest::core::fit_complexity({1, 2, 4, 8, 16}, {1, 4, 16, 64, 256});
+        assert_true(sweep.best_fit==complexity::quadratic, SPOT);
+        assert_complexity(complexity::quadratic, sweep, SPOT);
+        assert_throw<unittest::testfailure>([&sweep]() { assert_complexity(complexity::linearithmic, sweep); }, SPOT);
+        assert_throw<unittest::testfailure>([]() { assert_complexity(complexity::linear, unittest::core::sweepresult()); }, SPOT);
+    }
+
+};
+REGISTER(test_benchmark)
@@ -0,0 +1,291 @@
+#include <libunittest/all.hpp>
+#include <cstdio>
+#include <atomic>
+#include <fstream>
+#include <sstream>
+using namespace unittest::assertions;
+using unittest::core::binwriter;
+using unittest::core::binreader;
+using unittest::core::testresults;
+
+unittest::core::testresults make_sample_results();
+
+namespace {
+
+// a stream buffer that cannot seek, like the one of a pipe
+struct pipebuf : std::stringbuf {
+
+    pos_type
+    seekoff(off_type, std::ios_base::seekdir, std::ios_base::openmode)
+    {
+        return pos_type(off_type(-1));
+    }
+
+    pos_type
+    seekpos(pos_type, std::ios_base::openmode)
+    {
+        return pos_type(off_type(-1));
+    }
+
+};
+
+}
+
+struct test_binresults : unittest::testcase<> {
+
+    static void run()
+    {
+        UNITTEST_CLASS(test_binresults)
+        UNITTEST_RUN(test_roundtrip_suite_info)
+        UNITTEST_RUN(test_roundtrip_totals)
+        UNITTEST_RUN(test_roundtrip_matches_xml)
+        UNITTEST_RUN(test_roundtrip_non_deadly_failures)
+        UNITTEST_RUN(test_strings_are_stored_once)
+        UNITTEST_RUN(test_append_files)
+        UNITTEST_RUN(test_append_single_records)
+        UNITTEST_RUN(test_peek_names)
+        UNITTEST_RUN(test_incomplete_file)
+        UNITTEST_RUN(test_write_without_seeking)
+        UNITTEST_RUN(test_missing_file)
+        UNITTEST_RUN(test_corrupt_file)
+    }
+
+    std::string filename_;
+
+    test_binresults()
+        : filename_(make_filename())
+    {}
+
+    ~test_binresults()
+    {
+        std::remove(filename_.c_str());
+    }
+
+    static std::string
+    make_filename()
+    {
+        static std::atomic<int> counter(0);
+        return unittest::join("test_binresults_", unittest::core::now().count(), "_", counter++, ".bin");
+    }
+
+    static std::chrono::system_clock::time_point
+    time_point()
+    {
+        return std::chrono::system_clock::from_time_t(1234567890);
+    }
+
+    void write(const testresults& results,
+               bool finish=true)
+    {
+        auto stream = std::make_shared<std::ofstream>(filename_, std::ios::binary);
+        binwriter writer(stream, "peter", 42, 1, 3, time_point());
+        for (const auto& log : results.testlogs)
+            writer.report(log);
+        if (finish)
+            writer.finish(results);
+    }
+
+    void test_roundtrip_suite_info()
+    {
+        write(make_sample_results());
+        binreader reader(filename_);
+        assert_equal(3u, reader.size(), SPOT);
+        assert_equal("peter", reader.suite_name(), SPOT);
+        assert_equal(42, reader.shuffle_seed(), SPOT);
+        assert_equal(1, reader.shard_index(), SPOT);
+        assert_equal(3, reader.shard_count(), SPOT);
+        assert_true(time_point()==reader.time_point(), SPOT);
+    }
+
+    void test_roundtrip_totals()
+    {
+        const auto results = make_sample_results();
+        write(results);
+        const auto totals = binreader(filename_).totals();
+        assert_equal(results.successful, totals.successful, SPOT);
+        assert_equal(results.n_tests, totals.n_tests, SPOT);
+        assert_equal(results.n_successes, totals.n_successes, SPOT);
+        assert_equal(results.n_failures, totals.n_failures, SPOT);
+        assert_equal(results.n_errors, totals.n_errors, SPOT);
+        assert_equal(results.n_skipped, totals.n_skipped, SPOT);
+        assert_equal(results.n_timeouts, totals.n_timeouts, SPOT);
+        assert_equal(results.duration, totals.duration, SPOT);
+        assert_true(totals.testlogs.empty(), SPOT);
+    }
+
+    void test_roundtrip_matches_xml()
+    {
+        auto results = make_sample_results();
+        results.testlogs[0].text = "some text";
+        results.testlogs[1].assertion = "assert_equal";
+        results.testlogs[1].filename = "stuff.cpp";
+        results.testlogs[1].linenumber = 13;
+        results.testlogs[1].callsite = "assert_equal(1, 2)";
+        write(results);
+        std::ostringstream expected;
+        unittest::core::write_xml(expected, results, "peter", 42, time_point(), false, 1, 3);
+        std::ostringstream actual;
+        unittest::core::write_xml(actual, binreader(filename_).results(), "peter", 42, time_point(), false, 1, 3);
+        assert_equal(expected.str(), actual.str(), SPOT);
+    }
+
+    void test_roundtrip_non_deadly_failures()
+    {
+        auto results = make_sample_results();
+        results.testlogs[2].nd_failures.push_back(unittest::testfailure("assert_true", "first", "a.cpp", 1, "call1"));
+        results.testlogs[2].nd_failures.push_back(unittest::testfailure("assert_false", "second", "b.cpp", 2, "call2"));
+        write(results);
+        binreader reader(filename_);
+        assert_true(reader.log(0).nd_failures.empty(), SPOT);
+        const auto log = reader.log(2);
+        assert_equal(2u, log.nd_failures.size(), SPOT);
+        assert_equal("assert_true", log.nd_failures[0].assertion(), SPOT);
+        assert_equal("first", std::string(log.nd_failures[0].what()), SPOT);
+        assert_equal("a.cpp", log.nd_failures[0].filename(), SPOT);
+        assert_equal(1, log.nd_failures[0].linenumber(), SPOT);
+        assert_equal("call1", log.nd_failures[0].callsite(), SPOT);
+        assert_equal("second", std::string(log.nd_failures[1].what()), SPOT);
+        assert_throw<std::out_of_range>([&](){ reader.log(3); }, SPOT);
+    }
+
+    void test_strings_are_stored_once()
+    {
+        auto results = make_sample_results();
+        const std::string message(1000, 'x');
+        for (auto& log : results.testlogs)
+            log.message = message;
+        write(results);
+        std::ifstream file(filename_, std::ios::binary | std::ios::ate);
+        assert_lesser(static_cast<long>(file.tellg()), 1500, SPOT);
+        assert_equal(message, binreader(filename_).log(1).message, SPOT);
+    }
+
+    void test_append_files()
+    {
+        auto results = make_sample_results();
+        results.testlogs[1].nd_failures.push_back(unittest::testfailure("assert_true", "first", "a.cpp", 1, "call1"));
+        write(results);
+        const auto merged_name = filename_ + ".merged";
+        {
+            binreader reader(filename_);
+            auto stream = std::make_shared<std::ofstream>(merged_name, std::ios::binary);
+            binwriter writer(stream, "paul", -1, 0, 1, time_point());
+            writer.append(reader);
+            writer.append(reader);
+            writer.finish(results);
+        }
+        {
+            binreader merged(merged_name);
+            assert_equal(6u, merged.size(), SPOT);
+            assert_equal("paul", merged.suite_name(), SPOT);
+            for (size_t i=0; i<merged.size(); ++i) {
+                const auto& expected = results.testlogs[i % 3];
+                const auto log = merged.log(i);
+                assert_equal(expected.test_name, log.test_name, SPOT);
+                assert_equal(expected.message, log.message, SPOT);
+                assert_equal(expected.nd_failures.size(), log.nd_failures.size(), SPOT);
+            }
+            assert_equal("first", std::string(merged.log(4).nd_failures[0].what()), SPOT);
+        }
+        std::remove(merged_name.c_str());
+    }
+
+    void test_append_single_records()
+    {
+        auto results = make_sample_results();
+        results.testlogs[2].nd_failures.push_back(unittest::testfailure("assert_true", "first", "a.cpp", 1, "call1"));
+        write(results);
+        const auto records_name = filename_ + ".records";
+        {
+            binreader reader(filename_);
+            auto stream = std::make_shared<std::ofstream>(records_name, std::ios::binary);
+            binwriter writer(stream, "paul", -1, 0, 1, time_point());
+            writer.append(reader, 2);
+            writer.append(reader, 0);
+            assert_throw<std::out_of_range>([&](){ writer.append(reader, 3); }, SPOT);
+            writer.finish(results);
+        }
+        {
+            binreader records(records_name);
+            assert_equal(2u, records.size(), SPOT);
+            const auto first = records.log(0);
+            assert_equal("test3", first.test_name, SPOT);
+            assert_equal("message3", first.message, SPOT);
+            assert_equal(1u, first.nd_failures.size(), SPOT);
+            assert_equal("first", std::string(first.nd_failures[0].what()), SPOT);
+            const auto second = records.log(1);
+            assert_equal("test1", second.test_name, SPOT);
+            assert_equal("message1", second.message, SPOT);
+            assert_equal("", second.error_type, SPOT);
+        }
+        std::remove(records_name.c_str());
+    }
+
+    void test_peek_names()
+    {
+        auto results = make_sample_results();
+        results.testlogs.push_back(results.testlogs[1]);
+        results.testlogs.back().message = "retried";
+        write(results);
+        binreader reader(filename_);
+        unittest::core::testlog log;
+        reader.peek(1, log);
+        assert_equal("test_class", log.class_name, SPOT);
+        assert_equal("test2", log.test_name, SPOT);
+        assert_true(unittest::core::teststatus::failure==log.status, SPOT);
+        assert_false(log.successful, SPOT);
+        assert_true(log.has_timed_out, SPOT);
+        assert_equal("", log.message, SPOT);
+        assert_true(reader.is_same_name(1, 3), SPOT);
+        assert_false(reader.is_same_name(0, 1), SPOT);
+        assert_throw<std::out_of_range>([&](){ reader.peek(4, log); }, SPOT);
+    }
+
+    void test_incomplete_file()
+    {
+        write(make_sample_results(), false);
+        assert_throw<std::runtime_error>([&](){ binreader reader(filename_); }, SPOT);
+    }
+
+    void test_write_without_seeking()
+    {
+        const auto results = make_sample_results();
+        pipebuf buffer;
+        {
+            binwriter writer(std::make_shared<std::ostream>(&buffer), "peter", 42, 1, 3, time_point());
+            for (const auto& log : results.testlogs)
+                writer.report(log);
+            writer.finish(results);
+        }
+        std::ofstream(filename_, std::ios::binary) << buffer.str();
+        std::ostringstream expected;
+        unittest::core::write_xml(expected, results, "peter", 42, time_point(), false, 1, 3);
+        std::ostringstream actual;
+        unittest::core::write_xml(actual, binreader(filename_).results(), "peter", 42, time_point(), false, 1, 3);
+        assert_equal(expected.str(), actual.str(), SPOT);
+        assert_equal(results.n_tests, binreader(filename_).totals().n_tests, SPOT);
+    }
+
+    void test_missing_file()
+    {
+        assert_throw<std::runtime_error>([&](){ binreader reader(filename_ + ".missing"); }, SPOT);
+    }
+
+    void test_corrupt_file()
+    {
+        write(make_sample_results());
+        {
+            std::ofstream file(filename_, std::ios::binary | std::ios::app);
+            file << "garbage";
+        }
+        assert_throw<std::runtime_error>([&](){ binreader reader(filename_); }, SPOT);
+        {
+            std::ofstream file(filename_, std::ios::binary);
+            file << "not a binary results file at all, just a lot of plain text to fill a header";
+            file << std::string(100, ' ');
+        }
+        assert_throw<std::runtime_error>([&](){ binreader reader(filename_); }, SPOT);
+    }
+
+};
+REGISTER(test_binresults)
@@ -0,0 +1,136 @@
+#include <libunittest/all.hpp>
+#include <sstream>
+#include <thread>
+using namespace unittest::assertions;
+using unittest::core::consolewriter;
+using unittest::core::consolemode;
+
+struct test_consolewriter : unittest::testcase<> {
+
+    static void run()
+    {
+        UNITTEST_CLASS(test_consolewriter)
+        UNITTEST_RUN(test_written_at_once)
+        UNITTEST_RUN(test_verbose_lines)
+        UNITTEST_RUN(test_timeout)
+        UNITTEST_RUN(test_held_until_due)
+        UNITTEST_RUN(test_ordered)
+        UNITTEST_RUN(test_silent)
+        UNITTEST_RUN(test_threads_drained_on_destruction)
+    }
+
+    static unittest::core::testlog
+    make_log(const std::string& class_name,
+             const std::string& test_name,
+             unittest::core::teststatus status,
+             long sequence=-1)
+    {
+        unittest::core::testlog log;
+        log.class_name = class_name;
+        log.test_name = test_name;
+        log.status = status;
+        log.sequence = sequence;
+        return log;
+    }
+
+    void test_written_at_once()
+    {
+        using unittest::core::teststatus;
+        std::ostringstream stream;
+        consolewriter writer(stream, false, consolemode::buffered, 0);
+        writer.write_end(make_log("a", "t1", teststatus::success));
+        assert_equal(".", stream.str(), SPOT);
+        writer.write_end(make_log("a", "t2", teststatus::failure));
+        writer.write_end(make_log("a", "t3", teststatus::skipped));
+        assert_equal(".FS", stream.str(), SPOT);
+    }
+
+    void test_verbose_lines()
+    {
+        using unittest::core::teststatus;
+        std::ostringstream stream;
+        consolewriter writer(stream, true, consolemode::buffered, 0);
+        writer.write_end(make_log("a", "t1", teststatus::success));
+        writer.write_end(make_log("b", "t2", teststatus::error));
+        assert_equal("a::t1 ... [0s] ok\nb::t2 ... [0s] ERROR\n", stream.str(), SPOT);
+    }
+
+    void test_timeout()
+    {
+        using unittest::core::teststatus;
+        std::ostringstream stream;
+        consolewriter writer(stream, true, consolemode::buffered, 0);
+        auto log = make_log("a", "t1", teststatus::error);
+        writer.write_timeout(log);
+        log.has_timed_out = true;
+        writer.write_end(log);
+        assert_equal("a::t1 ... TIMEOUT\n", stream.str(), SPOT);
+    }
+
+    void test_held_until_due()
+    {
+        using unittest::core::teststatus;
+        std::ostringstream stream;
+        consolewriter writer(stream, false, consolemode::buffered, 3600, {}, false);
+        writer.write_end(make_log("a", "t1", teststatus::success));
+        writer.write_end(make_log("a", "t2", teststatus::failure));
+        assert_equal("", stream.str(), SPOT);
+        writer.flush();
+        assert_equal(".F", stream.str(), SPOT);
+    }
+
+    void test_ordered()
+    {
+        using unittest::core::teststatus;
+        std::ostringstream stream;
+        consolewriter writer(stream, true, consolemode::ordered, 0, {"b", "a"});
+        std::thread thread([&writer]() {
+            writer.write_end(make_log("a", "t2", teststatus::success, 4));
+            writer.write_end(make_log("b", "t1", teststatus::success, 3));
+        });
+        thread.join();
+        writer.write_end(make_log("a", "t1", teststatus::failure, 1));
+        writer.write_end(make_log("c", "t1", teststatus::success, 0));
+        writer.write_end(make_log("b", "t2", teststatus::success, 5));
+        assert_equal("", stream.str(), SPOT);
+        writer.flush();
+        const std::string expected = "b::t1 ... [0s] ok\nb::t2 ... [0s] ok\n"
+                                     "a::t1 ... [0s] FAIL\na::t2 ... [0s] ok\n"
+                                     "c::t1 ... [0s] ok\n";
+        assert_equal(expected, stream.str(), SPOT);
+    }
+
+    void test_silent()
+    {
+        using unittest::core::teststatus;
+        std::ostringstream stream;
+        {
+            consolewriter writer(stream, true, consolemode::silent, 0);
+            writer.write_end(make_log("a", "t1", teststatus::success));
+            writer.write_timeout(make_log("a", "t2", teststatus::error));
+            writer.flush();
+        }
+        assert_equal("", stream.str(), SPOT);
+    }
+
+    void test_threads_drained_on_destruction()
+    {
+        using unittest::core::teststatus;
+        std::ostringstream stream;
+        {
+            consolewriter writer(stream, false, consolemode::buffered, 0.001);
+            std::vector<std::thread> threads;
+            for (int i=0; i<4; ++i) {
+                threads.emplace_back([&writer]() {
+                    for (int j=0; j<250; ++j)
+                        writer.write_end(make_log("a", "t", teststatus::success));
+                });
+            }
+            for (auto& thread : threads)
+                thread.join();
+        }
+        assert_equal(std::string(1000, '.'), stream.str(), SPOT);
+    }
+
+};
+REGISTER(test_consolewriter)
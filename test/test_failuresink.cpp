@@ -0,0 +1,168 @@
+#include <libunittest/all.hpp>
+#include <thread>
+#include <vector>
+using namespace unittest::assertions;
+using unittest::core::failuresink;
+using unittest::core::failurescope;
+
+namespace {
+
+void
+check_in_free_function(int value)
+{
+    NDASSERT_EQUAL(42, value)
+}
+
+}
+
+struct test_failuresink : unittest::testcase<> {
+
+    static void run()
+    {
+        UNITTEST_CLASS(test_failuresink)
+        UNITTEST_RUN(test_method_id)
+        UNITTEST_RUN(test_push_and_take)
+        UNITTEST_RUN(test_push_concurrent)
+        UNITTEST_RUN(test_current_of_running_test)
+        UNITTEST_RUN(test_scope_nesting)
+        UNITTEST_RUN(test_ndas_in_free_function)
+        UNITTEST_RUN(test_ndas_in_helper_thread)
+        UNITTEST_RUN(test_ndas_in_unscoped_thread)
+        UNITTEST_RUN(test_ndas_after_test_finished)
+        UNITTEST_RUN(test_ndas_without_sink_is_deadly)
+    }
+
+    void test_method_id()
+    {
+        failuresink sink("some_id");
+        assert_equal("some_id", sink.method_id(), SPOT);
+    }
+
+    void test_push_and_take()
+    {
+        failuresink sink("");
+        assert_true(sink.take().empty(), SPOT);
+        sink.push(unittest::testfailure("first", "message"));
+        sink.push(unittest::testfailure("second", "message"));
+        const auto failures = sink.take();
+        assert_equal(2u, failures.size(), SPOT);
+        assert_equal("first", failures[0].assertion(), SPOT);
+        assert_equal("second", failures[1].assertion(), SPOT);
+        assert_true(sink.take().empty(), SPOT);
+    }
+
+    void test_push_concurrent()
+    {
+        failuresink sink("");
+        std::vector<std::thread> threads;
+        for (int i=0; i<4; ++i) {
+            threads.push_back(std::thread([&sink]() {
+                for (int j=0; j<100; ++j)
+                    sink.push(unittest::testfailure("assertion", "message"));
+            }));
+        }
+        for (auto& thread : threads)
+            thread.join();
+        assert_equal(400u, sink.take().size(), SPOT);
+    }
+
+    void test_current_of_running_test()
+    {
+        const auto sink = failuresink::current();
+        assert_true(sink!=nullptr, SPOT);
+        assert_equal(get_test_id(), sink->method_id(), SPOT);
+    }
+
+    void test_scope_nesting()
+    {
+        const auto outer = failuresink::current();
+        const auto sink = std::make_shared<failuresink>("");
+        {
+            failurescope scope(sink);
+            assert_equal(sink.get(), failuresink::current(), SPOT);
+            assert_equal(sink, failuresink::acquire(), SPOT);
+            {
+                failurescope inner(nullptr);
+                assert_true(failuresink::current()==nullptr, SPOT);
+            }
+            assert_equal(sink.get(), failuresink::current(), SPOT);
+        }
+        assert_equal(outer, failuresink::current(), SPOT);
+    }
+
+    void test_ndas_in_free_function()
+    {
+        const auto sink = std::make_shared<failuresink>("");
+        {
+            failurescope scope(sink);
+            check_in_free_function(42);
+            check_in_free_function(13);
+        }
+        const auto failures = sink->take();
+        assert_equal(1u, failures.size(), SPOT);
+        assert_equal("assert_equal", failures[0].assertion(), SPOT);
+        assert_equal("42, value", failures[0].callsite(), SPOT);
+    }
+
+    void test_ndas_in_helper_thread()
+    {
+        const auto sink = std::make_shared<failuresink>("");
+        {
+            failurescope scope(sink);
+            const auto ndas = NDAS;
+            std::thread thread([ndas]() {
+                assert_true(false, SPOT, ndas);
+            });
+            thread.join();
+            std::thread adopting([sink]() {
+                failurescope scope(sink);
+                check_in_free_function(13);
+            });
+            adopting.join();
+        }
+        assert_equal(2u, sink->take().size(), SPOT);
+    }
+
+    void test_ndas_in_unscoped_thread()
+    {
+        std::thread thread([this]() {
+            assert_true(false, SPOT, NDAS);
+            NDASSERT_EQUAL(42, 13)
+        });
+        thread.join();
+        const auto failures = unittest_ndas_sink()->take();
+        assert_equal(2u, failures.size(), SPOT);
+        assert_equal("assert_true", failures[0].assertion(), SPOT);
+        assert_equal("42, 13", failures[1].callsite(), SPOT);
+    }
+
+    void test_ndas_after_test_finished()
+    {
+        auto sink = std::make_shared<failuresink>("");
+        std::weak_ptr<failuresink> observer = sink;
+        std::unique_ptr<std::thread> thread;
+        std::atomic_bool is_finished(false);
+        {
+            failurescope scope(sink);
+            const auto ndas = NDAS;
+            thread.reset(new std::thread([ndas, &is_finished]() {
+                while (!is_finished.load())
+                    std::this_thread::yield();
+                assert_true(false, SPOT, ndas);
+            }));
+        }
+        sink.reset();
+        assert_false(observer.expired(), SPOT);
+        is_finished = true;
+        thread->join();
+        assert_true(observer.expired(), SPOT);
+    }
+
+    void test_ndas_without_sink_is_deadly()
+    {
+        failurescope scope(nullptr);
+        assert_throw<unittest::testfailure>([]() { check_in_free_function(13); }, SPOT);
+    }
+
+};
+REGISTER(test_failuresink)
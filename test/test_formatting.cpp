@@ -4,6 +4,8 @@ using namespace unittest::core;
 
 struct test_formatting : unittest::testcase<> {
 
+    UNITTEST_NOT_THREADSAFE
+
     static void run()
     {
         UNITTEST_CLASS(test_formatting)
@@ -0,0 +1,158 @@
+#include <libunittest/all.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <thread>
+#ifdef __linux__
+#include <unistd.h>
+#endif
+using namespace unittest::assertions;
+using unittest::core::testlog;
+using unittest::core::teststatus;
+
+namespace {
+
+const char* const g_fixture_variable = "UNITTEST_ISOLATION_FIXTURE";
+
+}
+
+// only runs when the test application is started by test_isolation
+struct isolation_fixture : unittest::testcase<> {
+
+    static void run()
+    {
+        if (!std::getenv(g_fixture_variable))
+            return;
+        UNITTEST_CLASS(isolation_fixture)
+        UNITTEST_RUN(test_before_crash)
+        UNITTEST_RUN(test_crash)
+        UNITTEST_RUN(test_after_crash)
+        UNITTEST_RUN_TIME(test_hang, 0.2)
+        UNITTEST_RUN(test_after_hang)
+    }
+
+    void test_before_crash()
+    {}
+
+    void test_crash()
+    {
+        std::abort();
+    }
+
+    void test_after_crash()
+    {}
+
+    void test_hang()
+    {
+        for (;;)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    void test_after_hang()
+    {}
+
+};
+REGISTER(isolation_fixture)
+
+struct test_isolation : unittest::testcase<> {
+
+    static void run()
+    {
+        UNITTEST_CLASS(test_isolation)
+        UNITTEST_RUN(test_crash_resumes_class)
+        UNITTEST_RUN(test_timeout_kills_child)
+        UNITTEST_RUN(test_worker_processes)
+    }
+
+    std::string filename_;
+
+    test_isolation()
+        : filename_(make_filename())
+    {}
+
+    ~test_isolation()
+    {
+        std::remove(filename_.c_str());
+    }
+
+    static std::string
+    make_filename()
+    {
+        static std::atomic<int> counter(0);
+        return unittest::join("test_isolation_", unittest::core::now().count(), "_", counter++, ".bin");
+    }
+
+    std::map<std::string, testlog>
+    run_fixture(const std::string& arguments)
+    {
+        std::map<std::string, testlog> logs;
+#ifdef __linux__
+        char executable[4096];
+        const ssize_t size = ::readlink("/proc/self/exe", executable, sizeof(executable) - 1);
+        assert_greater(size, 0, SPOT);
+        executable[size] = 0;
+        const auto command = unittest::join("ulimit -c 0; ", g_fixture_variable, "=1 ", executable,
+                                            " -f isolation_fixture -B ", filename_, " ", arguments,
+                                            " >/dev/null 2>&1");
+        std::system(command.c_str());
+        unittest::core::binreader reader(filename_);
+        for (size_t i=0; i<reader.size(); ++i) {
+            const auto log = reader.log(i);
+            if (log.class_name=="isolation_fixture")
+                logs[log.test_name] = log;
+        }
+#else
+        (void)arguments;
+#endif
+        return logs;
+    }
+
+    void assert_crash_resumed(const std::map<std::string, testlog>& logs)
+    {
+        assert_true(teststatus::success==logs.at("test_before_crash").status, SPOT);
+        const auto& crash = logs.at("test_crash");
+        assert_true(teststatus::error==crash.status, SPOT);
+        assert_equal("crash", crash.error_type, SPOT);
+        assert_equal("Test process terminated by signal 6 (Aborted)", crash.message, SPOT);
+        assert_true(teststatus::success==logs.at("test_after_crash").status, SPOT);
+    }
+
+    void assert_timeout_killed(const std::map<std::string, testlog>& logs)
+    {
+        const auto& hang = logs.at("test_hang");
+        assert_true(hang.has_timed_out, SPOT);
+        assert_true(teststatus::success==hang.status, SPOT);
+        assert_equal("Test process killed after exceeding the timeout of 0.2s", hang.message, SPOT);
+        assert_true(teststatus::success==logs.at("test_after_hang").status, SPOT);
+    }
+
+    void test_crash_resumes_class()
+    {
+#ifdef __linux__
+        const auto logs = run_fixture("-j");
+        assert_equal(5u, logs.size(), SPOT);
+        assert_crash_resumed(logs);
+#endif
+    }
+
+    void test_timeout_kills_child()
+    {
+#ifdef __linux__
+        assert_timeout_killed(run_fixture("-j"));
+#endif
+    }
+
+    void test_worker_processes()
+    {
+#ifdef __linux__
+        const auto logs = run_fixture("-P 2");
+        assert_equal(5u, logs.size(), SPOT);
+        assert_crash_resumed(logs);
+        assert_timeout_killed(logs);
+#endif
+    }
+
+};
+REGISTER(test_isolation)
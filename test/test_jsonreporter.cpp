@@ -0,0 +1,92 @@
+#include <libunittest/all.hpp>
+#include <sstream>
+using namespace unittest::assertions;
+using unittest::core::jsonreporter;
+
+unittest::core::testresults make_sample_results();
+
+struct test_jsonreporter : unittest::testcase<> {
+
+    static void run()
+    {
+        UNITTEST_CLASS(test_jsonreporter)
+        UNITTEST_RUN(test_suite_start)
+        UNITTEST_RUN(test_suite_start_shuffled_shard)
+        UNITTEST_RUN(test_test_events)
+        UNITTEST_RUN(test_buffered_until_finish)
+        UNITTEST_RUN(test_finish_is_idempotent)
+    }
+
+    static std::chrono::system_clock::time_point
+    time_point()
+    {
+        return std::chrono::system_clock::from_time_t(1234567890);
+    }
+
+    void test_suite_start()
+    {
+        auto stream = std::make_shared<std::ostringstream>();
+        jsonreporter reporter(stream, "peter", -1, 0, 1, time_point(), false);
+        const std::string expected = "{\"event\":\"suite_start\",\"suite\":\"peter\",\"timestamp\":\"2009-02-13T23:31:30\"}\n";
+        assert_equal(expected, stream->str(), SPOT);
+    }
+
+    void test_suite_start_shuffled_shard()
+    {
+        auto stream = std::make_shared<std::ostringstream>();
+        jsonreporter reporter(stream, "pe\"ter", 42, 1, 3, time_point(), false);
+        const std::string expected = "{\"event\":\"suite_start\",\"suite\":\"pe\\\"ter\",\"timestamp\":\"2009-02-13T23:31:30\","
+                                     "\"shuffseed\":42,\"shard\":1,\"shards\":3}\n";
+        assert_equal(expected, stream->str(), SPOT);
+    }
+
+    void test_test_events()
+    {
+        auto results = make_sample_results();
+        results.testlogs[0].text = "some\ntext";
+        auto stream = std::make_shared<std::ostringstream>();
+        jsonreporter reporter(stream, "peter", -1, 0, 1, time_point(), false);
+        reporter.start(results.testlogs[1]);
+        for (const auto& log : results.testlogs)
+            reporter.report(log);
+        reporter.finish(results);
+        std::ostringstream expected;
+        expected << "{\"event\":\"suite_start\",\"suite\":\"peter\",\"timestamp\":\"2009-02-13T23:31:30\"}\n";
+        expected << "{\"event\":\"test_start\",\"class\":\"test_class\",\"test\":\"test2\",\"timeout\":2.400000}\n";
+        expected << "{\"event\":\"test_end\",\"class\":\"test_class\",\"test\":\"test1\",\"status\":\"success\",\"duration\":1.000000,\"text\":\"some\\ntext\"}\n";
+        expected << "{\"event\":\"failure\",\"class\":\"test_class\",\"test\":\"test2\",\"type\":\"testfailure\",\"message\":\"message2\"}\n";
+        expected << "{\"event\":\"timeout\",\"class\":\"test_class\",\"test\":\"test2\",\"timeout\":2.400000}\n";
+        expected << "{\"event\":\"test_end\",\"class\":\"test_class\",\"test\":\"test2\",\"status\":\"failure\",\"duration\":2.000000}\n";
+        expected << "{\"event\":\"failure\",\"class\":\"test_class\",\"test\":\"test3\",\"type\":\"error\",\"message\":\"message3\"}\n";
+        expected << "{\"event\":\"test_end\",\"class\":\"test_class\",\"test\":\"test3\",\"status\":\"error\",\"duration\":3.000000}\n";
+        expected << "{\"event\":\"suite_end\",\"successful\":false,\"tests\":3,\"errors\":1,\"failures\":1,\"timeouts\":1,\"skipped\":0,\"time\":6.000000}\n";
+        assert_equal(expected.str(), stream->str(), SPOT);
+    }
+
+    void test_buffered_until_finish()
+    {
+        const auto results = make_sample_results();
+        auto stream = std::make_shared<std::ostringstream>();
+        jsonreporter reporter(stream, "peter", -1, 0, 1, time_point(), false);
+        const auto header = stream->str();
+        reporter.report(results.testlogs[0]);
+        assert_equal(header, stream->str(), SPOT);
+        reporter.finish(results);
+        assert_true(stream->str().find("\"test\":\"test1\"")!=std::string::npos, SPOT);
+    }
+
+    void test_finish_is_idempotent()
+    {
+        const auto results = make_sample_results();
+        auto stream = std::make_shared<std::ostringstream>();
+        jsonreporter reporter(stream, "peter", -1, 0, 1, time_point(), false);
+        reporter.finish(results);
+        const auto json = stream->str();
+        reporter.start(results.testlogs[0]);
+        reporter.report(results.testlogs[0]);
+        reporter.finish(results);
+        assert_equal(json, stream->str(), SPOT);
+    }
+
+};
+REGISTER(test_jsonreporter)
@@ -12,12 +12,16 @@ COLLECTION(test_macros_easy)
 
     TEST(test_test)
     {
-        assert_equal(unittest::join("@SPOT@", __FILE__, ":", __LINE__, "@SPOT@"), SPOT);
+        const auto spot = SPOT;
+        assert_equal(__FILE__, std::string(spot.filename));
+        assert_equal(__LINE__ - 2, spot.linenumber);
     }
 
     UNITTEST_TEST(test_unittest_test)
     {
-        assert_equal(unittest::join("@SPOT@", __FILE__, ":", __LINE__, "@SPOT@"), UNITTEST_SPOT);
+        const auto spot = UNITTEST_SPOT;
+        assert_equal(__FILE__, std::string(spot.filename));
+        assert_equal(__LINE__ - 2, spot.linenumber);
     }
 
     TEST_SKIP(test_test_skip, "ok")
@@ -174,4 +178,72 @@ COLLECTION(test_macros_easy)
         unittest::fail(UNITTEST_FUNC, "should be skipped");
     }
 
+    TEST_MEM(test_test_mem, 1 << 20)
+    {
+        const std::vector<char> buffer(1000);
+        assert_equal(1000u, buffer.size());
+    }
+
+    UNITTEST_TEST_MEM(test_unittest_test_mem, 1 << 20)
+    {
+        const std::vector<char> buffer(1000);
+        assert_equal(1000u, buffer.size());
+    }
+
+    TEST_FIXTURE_MEM(fixture, test_test_fixture_mem, 1 << 20)
+    {
+        assert_equal(42, value);
+        const std::vector<char> buffer(1000);
+    }
+
+    UNITTEST_TEST_FIXTURE_MEM(fixture, test_unittest_test_fixture_mem, 1 << 20)
+    {
+        assert_equal(42, value);
+        const std::vector<char> buffer(1000);
+    }
+
+    BENCH(bench_bench)
+    {
+        std::vector<int> values(100, 1);
+        while (state.keep_running()) {
+            int sum = 0;
+            for (auto value : values)
+                sum += value;
+            unittest::do_not_optimize(sum);
+        }
+        assert_equal(100u, values.size());
+    }
+
+    UNITTEST_BENCH_FIXTURE(fixture, bench_unittest_bench_fixture)
+    {
+        assert_equal(42, value);
+        while (state.keep_running()) {
+            state.pause_timing();
+            std::vector<int> values(10, value);
+            state.resume_timing();
+            unittest::do_not_optimize(values.front());
+        }
+    }
+
+    BENCH_SWEEP(bench_bench_sweep, 1, 64)
+    {
+        assert_in_range(state.range(), 1, 64);
+        while (state.keep_running())
+            unittest::do_not_optimize(state.range());
+    }
+
+    UNITTEST_BENCH_SWEEP_COMPLEXITY(bench_unittest_bench_sweep_complexity, 16, 512, unittest::complexity::quadratic)
+    {
+        const std::vector<int> values(static_cast<size_t>(state.range()), 1);
+        while (state.keep_running()) {
+            int sum = 0;
+            for (auto first : values) {
+                for (auto second : values) {
+                    sum += first * second;
+                    unittest::do_not_optimize(sum);
+                }
+            }
+        }
+    }
+
 }
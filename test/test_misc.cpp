@@ -1,5 +1,6 @@
 #include <libunittest/all.hpp>
 #include <exception>
+#include <type_traits>
 using namespace unittest::assertions;
 
 unittest::core::testresults make_sample_results()
@@ -56,20 +57,36 @@ struct test_misc : unittest::testcase<> {
         UNITTEST_RUN(test_write_xml_empty)
         UNITTEST_RUN(test_write_xml_filled)
         UNITTEST_RUN(test_write_xml_filled_with_nondeadly_assertion)
+        UNITTEST_RUN(test_write_xml_sharded)
         UNITTEST_RUN(test_write_summary_empty)
         UNITTEST_RUN(test_write_summary_filled)
         UNITTEST_RUN(test_write_error_info_empty)
         UNITTEST_RUN(test_write_error_info_filled)
+        UNITTEST_RUN(test_write_error_info_view)
+        UNITTEST_RUN(test_testlogview)
+        UNITTEST_RUN(test_write_xml_resources)
+        UNITTEST_RUN(test_write_xml_counters)
+        UNITTEST_RUN(test_write_xml_allocations)
+        UNITTEST_RUN(test_write_leak_info)
+        UNITTEST_RUN(test_write_xml_benchmark)
+        UNITTEST_RUN(test_write_xml_baseline)
+        UNITTEST_RUN(test_write_xml_sweep)
+        UNITTEST_RUN(test_write_bench_info)
         UNITTEST_RUN(test_write_test_start_message)
         UNITTEST_RUN(test_write_test_end_message)
         UNITTEST_RUN(test_write_test_timeout_message)
         UNITTEST_RUN(test_teststatus_integrals)
         UNITTEST_RUN(test_testlog_defaults)
+        UNITTEST_RUN(test_testlog_serialization)
+        UNITTEST_RUN(test_testlog_deserialization_error)
         UNITTEST_RUN(test_testresults_defaults)
+        UNITTEST_RUN(test_testfailure_from_fields)
         UNITTEST_RUN(test_testcase_fail_full_info)
         UNITTEST_RUN(test_testcase_fail_only_spot)
         UNITTEST_RUN(test_testcase_fail_no_user_message)
         UNITTEST_RUN(test_testcase_fail_user_message_without_spot)
+        UNITTEST_RUN(test_testcase_fail_source_records)
+        UNITTEST_RUN(test_source_records_are_trivial)
         UNITTEST_RUN(test_is_test_executed)
         UNITTEST_RUN(test_make_full_test_name)
         UNITTEST_RUN(test_collection_get_name)
@@ -77,6 +94,8 @@ struct test_misc : unittest::testcase<> {
         UNITTEST_RUN(test_keep_running_ok)
         UNITTEST_RUN(test_assertion_in_separate_thread)
         UNITTEST_RUN(test_assertion_with_message)
+        UNITTEST_RUN(test_assertion_message_is_deferred)
+        UNITTEST_RUN(test_assertion_message_on_failure)
     }
 
     void test_version()
@@ -102,6 +121,24 @@ struct test_misc : unittest::testcase<> {
         assert_equal(expected.str(), stream.str(), SPOT);
     }
 
+    void test_write_xml_sharded()
+    {
+        const unittest::core::testresults results;
+        std::ostringstream stream;
+        const time_t value = 1234567890;
+        const auto time_point = std::chrono::system_clock::from_time_t(value);
+        unittest::core::write_xml(stream, results, "libunittest", -1, time_point, false, 3, 16);
+        std::ostringstream expected;
+        expected << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+        expected << "<testsuite name=\"libunittest\" ";
+        expected << "timestamp=\"2009-02-13T23:31:30\" ";
+        expected << "tests=\"0\" errors=\"0\" ";
+        expected << "failures=\"0\" timeouts=\"0\" skipped=\"0\" ";
+        expected << "shard=\"3\" shards=\"16\" time=\"0.000000\">\n";
+        expected << "</testsuite>\n";
+        assert_equal(expected.str(), stream.str(), SPOT);
+    }
+
     void test_write_xml_filled()
     {
         const auto results = make_sample_results();
@@ -211,6 +248,189 @@ struct test_misc : unittest::testcase<> {
         assert_equal(expected.str(), stream.str(), SPOT);
     }
 
+    void test_write_error_info_view()
+    {
+        const auto results = make_sample_results();
+        std::ostringstream stream;
+        const auto view = unittest::core::make_testlogview(results, 2);
+        unittest::core::write_error_info(stream, view, view.successful());
+        std::ostringstream expected;
+        expected << "\n";
+        unittest::core::write_horizontal_bar(expected, '=');
+        expected << "\nERROR: test_class::test3 [3s]\n";
+        unittest::core::write_horizontal_bar(expected, '-');
+        expected << "\nerror: message3\n\n";
+        assert_equal(expected.str(), stream.str(), SPOT);
+    }
+
+    void test_testlogview()
+    {
+        const auto results = make_sample_results();
+        const auto all = unittest::core::make_testlogview(results);
+        assert_equal(3u, all.size(), SPOT);
+        assert_false(all.successful(), SPOT);
+        assert_true(&*all.begin()==&results.testlogs[0], SPOT);
+        const auto tail = unittest::core::make_testlogview(results, 1);
+        assert_equal(2u, tail.size(), SPOT);
+        assert_equal("test2", tail.begin()->test_name, SPOT);
+        const auto head = unittest::core::testlogview(results.testlogs.begin(), results.testlogs.begin() + 1);
+        assert_true(head.successful(), SPOT);
+        const auto beyond = unittest::core::make_testlogview(results, 42);
+        assert_equal(0u, beyond.size(), SPOT);
+        assert_true(beyond.successful(), SPOT);
+    }
+
+    void test_write_xml_resources()
+    {
+        unittest::core::testlog log;
+        log.test_name = "test";
+        log.resources.measured = true;
+        log.resources.user_time = 0.25;
+        log.resources.system_time = 0.5;
+        log.resources.max_rss = 8192;
+        log.resources.minor_faults = 1;
+        log.resources.major_faults = 2;
+        log.resources.voluntary_switches = 3;
+        log.resources.involuntary_switches = 4;
+        log.resources.read_bytes = 5;
+        log.resources.write_bytes = 6;
+        std::ostringstream stream;
+        unittest::core::write_xml_testcase(stream, log);
+        const std::string expected = "\t<testcase name=\"test\" time=\"0\" usertime=\"0.25\" systime=\"0.5\" "
+                                     "maxrss=\"8192\" minflt=\"1\" majflt=\"2\" nvcsw=\"3\" nivcsw=\"4\" "
+                                     "rchar=\"5\" wchar=\"6\">\n\t\t<skipped/>\n\t</testcase>\n";
+        assert_equal(expected, stream.str(), SPOT);
+    }
+
+    void test_write_xml_counters()
+    {
+        unittest::core::testlog log;
+        log.test_name = "test";
+        log.status = unittest::core::teststatus::success;
+        log.counters.measured = true;
+        log.counters.instructions = 1000;
+        log.counters.cycles = 500;
+        log.counters.cache_misses = 3;
+        log.counters.branch_misses = 4;
+        std::ostringstream stream;
+        unittest::core::write_xml_testcase(stream, log);
+        const std::string expected = "\t<testcase name=\"test\" time=\"0\" instructions=\"1000\" cycles=\"500\" "
+                                     "cache_misses=\"3\" branch_misses=\"4\"/>\n";
+        assert_equal(expected, stream.str(), SPOT);
+    }
+
+    void test_write_xml_allocations()
+    {
+        unittest::core::testlog log;
+        log.test_name = "test";
+        log.status = unittest::core::teststatus::success;
+        log.allocations.measured = true;
+        log.allocations.count = 3;
+        log.allocations.bytes = 96;
+        log.allocations.peak_bytes = 64;
+        log.allocations.live_bytes = -16;
+        std::ostringstream stream;
+        unittest::core::write_xml_testcase(stream, log);
+        const std::string expected = "\t<testcase name=\"test\" time=\"0\" allocs=\"3\" alloc_bytes=\"96\" "
+                                     "peak_bytes=\"64\" live_bytes=\"-16\"/>\n";
+        assert_equal(expected, stream.str(), SPOT);
+    }
+
+    void test_write_xml_benchmark()
+    {
+        unittest::core::testlog log;
+        log.test_name = "bench";
+        log.status = unittest::core::teststatus::success;
+        log.benchmark = unittest::core::make_benchresult({3, 1, 2}, 100, 0);
+        std::ostringstream stream;
+        unittest::core::write_xml_testcase(stream, log);
+        const std::string expected = "\t<testcase name=\"bench\" time=\"0\" bench_iterations=\"100\" bench_samples=\"3 1 2\" "
+                                     "bench_mean=\"2\" bench_median=\"2\" bench_stddev=\"1\" bench_min=\"1\" "
+                                     "bench_throughput=\"0.5\"/>\n";
+        assert_equal(expected, stream.str(), SPOT);
+    }
+
+    void test_write_xml_baseline()
+    {
+        unittest::core::benchcomparison comparison;
+        comparison.compared = true;
+        comparison.baseline_median = 2.5e-9;
+        comparison.ratio = 1.25;
+        comparison.p_value = 0.0001;
+        comparison.regressed = true;
+        std::ostringstream stream;
+        stream << std::fixed;
+        unittest::core::write_xml_baseline(stream, comparison);
+        stream << 0.5;
+        assert_equal(" baseline_median=\"2.5e-09\" baseline_ratio=\"1.25\" baseline_p=\"0.0001\" baseline_regressed=\"true\"0.500000",
+                     stream.str(), SPOT);
+    }
+
+    void test_write_xml_sweep()
+    {
+        const auto sweep = unittest::core::fit_complexity({1, 2, 4}, {1, 2, 4});
+        std::ostringstream stream;
+        stream << std::fixed;
+        unittest::core::write_xml_sweep(stream, sweep);
+        stream << 0.5;
+        assert_equal(" sweep_ranges=\"1 2 4\" sweep_times=\"1 2 4\" sweep_complexity=\"O(n)\" "
+                     "sweep_coefficient=\"1\" sweep_rms=\"0\"0.500000", stream.str(), SPOT);
+    }
+
+    void test_write_bench_info()
+    {
+        std::vector<unittest::core::testlog> logs(2);
+        logs[0].class_name = "stuff";
+        logs[0].test_name = "bench";
+        logs[0].status = unittest::core::teststatus::success;
+        logs[0].benchmark = unittest::core::make_benchresult({3, 1, 2}, 100, 4);
+        logs[1].test_name = "test";
+        logs[1].status = unittest::core::teststatus::success;
+        std::ostringstream stream;
+        unittest::core::write_bench_info(stream, logs);
+        assert_equal("\nBENCH: stuff::bench mean=2s median=2s stddev=1s min=1s throughput=0.5/s (2 bytes/s) [3x100]\n\n",
+                     stream.str(), SPOT);
+        std::ostringstream stream2;
+        unittest::core::write_bench_info(stream2, std::vector<unittest::core::testlog>(logs.begin() + 1, logs.end()));
+        assert_equal("", stream2.str(), SPOT);
+        logs[0].baseline.compared = true;
+        logs[0].baseline.baseline_median = 2.5;
+        logs[0].baseline.ratio = 0.8;
+        logs[0].baseline.p_value = 0.5;
+        std::ostringstream stream3;
+        unittest::core::write_bench_info(stream3, logs);
+        assert_equal("\nBENCH: stuff::bench mean=2s median=2s stddev=1s min=1s throughput=0.5/s (2 bytes/s) [3x100] "
+                     "baseline=2.5s ratio=0.8 p=0.5\n\n", stream3.str(), SPOT);
+        logs[1].sweep = unittest::core::fit_complexity({1, 2, 4}, {1, 2, 4});
+        std::ostringstream stream4;
+        unittest::core::write_bench_info(stream4, std::vector<unittest::core::testlog>(logs.begin() + 1, logs.end()));
+        assert_equal("\nSWEEP: test O(n) coefficient=1s rms=0 [3 ranges, 1..4]\n\n", stream4.str(), SPOT);
+    }
+
+    void test_write_leak_info()
+    {
+        std::vector<unittest::core::testlog> logs(4);
+        for (auto& log : logs) {
+            log.class_name = "stuff";
+            log.status = unittest::core::teststatus::success;
+            log.allocations.measured = true;
+            log.allocations.live_bytes = 32;
+        }
+        logs[0].test_name = "test_leak";
+        logs[1].test_name = "test_freed";
+        logs[1].allocations.live_bytes = 0;
+        logs[2].test_name = "test_failed";
+        logs[2].status = unittest::core::teststatus::failure;
+        logs[3].test_name = "test_untracked";
+        logs[3].allocations.measured = false;
+        std::ostringstream stream;
+        unittest::core::write_leak_info(stream, logs);
+        assert_equal("\nLEAK: stuff::test_leak (32 bytes still allocated)\n\n", stream.str(), SPOT);
+        std::ostringstream stream2;
+        unittest::core::write_leak_info(stream2, std::vector<unittest::core::testlog>(logs.begin() + 1, logs.end()));
+        assert_equal("", stream2.str(), SPOT);
+    }
+
     void test_write_test_start_message()
     {
         unittest::core::testlog log;
@@ -274,6 +494,104 @@ struct test_misc : unittest::testcase<> {
         assert_true(unittest::core::teststatus::skipped==log.status, SPOT);
         assert_equal("", log.message, SPOT);
         assert_equal(0, log.duration, SPOT);
+        assert_equal<long>(-1, log.sequence, SPOT);
+    }
+
+    void test_testlog_serialization()
+    {
+        unittest::core::testlog log;
+        log.class_name = "test_class";
+        log.test_name = "test:1";
+        log.successful = false;
+        log.status = unittest::core::teststatus::failure;
+        log.error_type = "testfailure";
+        log.message = "message\nwith 12:colons";
+        log.duration = 0.1;
+        log.has_timed_out = true;
+        log.timeout = 2.5;
+        log.assertion = "assert_equal";
+        log.method_id = "test_class_id";
+        log.text = "";
+        log.filename = "file.cpp";
+        log.linenumber = 42;
+        log.callsite = "here";
+        log.sequence = 7;
+        log.resources.measured = true;
+        log.resources.user_time = 0.125;
+        log.resources.involuntary_switches = 3;
+        log.resources.write_bytes = 1 << 20;
+        log.counters.measured = true;
+        log.counters.instructions = 123456;
+        log.counters.tlb_misses = 9;
+        log.allocations.measured = true;
+        log.allocations.count = 5;
+        log.allocations.peak_bytes = 4096;
+        log.allocations.live_bytes = -8;
+        log.benchmark = unittest::core::make_benchresult({0.5, 0.25}, 64, 0);
+        log.baseline.compared = true;
+        log.baseline.ratio = 1.5;
+        log.baseline.p_value = 0.001;
+        log.baseline.regressed = true;
+        log.sweep = unittest::core::fit_complexity({1, 2, 4}, {1, 4, 16});
+        log.nd_failures.push_back(unittest::testfailure("assert_true", "false", "other.cpp", 13, ""));
+        unittest::core::testlog restored;
+        assert_true(unittest::core::deserialize_testlog(unittest::core::serialize_testlog(log), restored), SPOT);
+        assert_equal(log.class_name, restored.class_name, SPOT);
+        assert_equal(log.test_name, restored.test_name, SPOT);
+        assert_equal(log.successful, restored.successful, SPOT);
+        assert_true(log.status==restored.status, SPOT);
+        assert_equal(log.error_type, restored.error_type, SPOT);
+        assert_equal(log.message, restored.message, SPOT);
+        assert_equal(log.duration, restored.duration, SPOT);
+        assert_equal(log.has_timed_out, restored.has_timed_out, SPOT);
+        assert_equal(log.timeout, restored.timeout, SPOT);
+        assert_equal(log.assertion, restored.assertion, SPOT);
+        assert_equal(log.method_id, restored.method_id, SPOT);
+        assert_equal(log.text, restored.text, SPOT);
+        assert_equal(log.filename, restored.filename, SPOT);
+        assert_equal(log.linenumber, restored.linenumber, SPOT);
+        assert_equal(log.callsite, restored.callsite, SPOT);
+        assert_equal(log.sequence, restored.sequence, SPOT);
+        assert_equal(log.resources.measured, restored.resources.measured, SPOT);
+        assert_equal(log.resources.user_time, restored.resources.user_time, SPOT);
+        assert_equal(log.resources.involuntary_switches, restored.resources.involuntary_switches, SPOT);
+        assert_equal(log.resources.write_bytes, restored.resources.write_bytes, SPOT);
+        assert_equal(log.counters.measured, restored.counters.measured, SPOT);
+        assert_equal(log.counters.instructions, restored.counters.instructions, SPOT);
+        assert_equal(log.counters.cycles, restored.counters.cycles, SPOT);
+        assert_equal(log.counters.tlb_misses, restored.counters.tlb_misses, SPOT);
+        assert_equal(log.allocations.measured, restored.allocations.measured, SPOT);
+        assert_equal(log.allocations.count, restored.allocations.count, SPOT);
+        assert_equal(log.allocations.peak_bytes, restored.allocations.peak_bytes, SPOT);
+        assert_equal(log.allocations.live_bytes, restored.allocations.live_bytes, SPOT);
+        assert_equal(log.benchmark.measured, restored.benchmark.measured, SPOT);
+        assert_equal(log.benchmark.iterations, restored.benchmark.iterations, SPOT);
+        assert_equal(log.benchmark.mean, restored.benchmark.mean, SPOT);
+        assert_equal(log.benchmark.stddev, restored.benchmark.stddev, SPOT);
+        assert_equal(2u, restored.benchmark.samples.size(), SPOT);
+        assert_equal(0.25, restored.benchmark.samples[1], SPOT);
+        assert_equal(log.baseline.compared, restored.baseline.compared, SPOT);
+        assert_equal(log.baseline.ratio, restored.baseline.ratio, SPOT);
+        assert_equal(log.baseline.p_value, restored.baseline.p_value, SPOT);
+        assert_equal(log.baseline.regressed, restored.baseline.regressed, SPOT);
+        assert_equal(log.sweep.measured, restored.sweep.measured, SPOT);
+        assert_true(log.sweep.best_fit==restored.sweep.best_fit, SPOT);
+        assert_equal(log.sweep.coefficient, restored.sweep.coefficient, SPOT);
+        assert_equal(log.sweep.rms, restored.sweep.rms, SPOT);
+        assert_true(log.sweep.ranges==restored.sweep.ranges, SPOT);
+        assert_true(log.sweep.times==restored.sweep.times, SPOT);
+        assert_equal(1u, restored.nd_failures.size(), SPOT);
+        assert_equal("false", unittest::join(restored.nd_failures[0].what()), SPOT);
+        assert_equal("other.cpp", restored.nd_failures[0].filename(), SPOT);
+        assert_equal(13, restored.nd_failures[0].linenumber(), SPOT);
+    }
+
+    void test_testlog_deserialization_error()
+    {
+        unittest::core::testlog log;
+        const auto data = unittest::core::serialize_testlog(log);
+        assert_false(unittest::core::deserialize_testlog(data.substr(0, data.size() / 2), log), SPOT);
+        assert_false(unittest::core::deserialize_testlog("peter", log), SPOT);
     }
 
     void test_testresults_defaults()
@@ -289,6 +607,45 @@ struct test_misc : unittest::testcase<> {
         assert_equal<unsigned>(0, results.testlogs.size(), SPOT);
     }
 
+    void test_testfailure_from_fields()
+    {
+        const unittest::testfailure failure("assert_something", "a test failure", "Here", 13, "There");
+        assert_equal("a test failure", unittest::join(failure.what()), SPOT);
+        assert_equal("assert_something", failure.assertion(), SPOT);
+        assert_equal("Here", failure.filename(), SPOT);
+        assert_equal(13, failure.linenumber(), SPOT);
+        assert_equal("There", failure.callsite(), SPOT);
+    }
+
+    void test_testcase_fail_source_records()
+    {
+        const unittest::core::sourcespot spot = {"Here", 13};
+        const unittest::core::sourcecall call = {"value, 42"};
+        bool caught = false;
+        try {
+            unittest::fail("assert_something", "a test failure", spot, call, "Some ", 42);
+        } catch (const unittest::testfailure& e) {
+            assert_equal("a test failure - Some 42", unittest::join(e.what()), SPOT);
+            assert_equal("assert_something", e.assertion(), SPOT);
+            assert_equal("Here", e.filename(), SPOT);
+            assert_equal(13, e.linenumber(), SPOT);
+            assert_equal("value, 42", e.callsite(), SPOT);
+            caught = true;
+        }
+        if (!caught)
+            throw unittest::testfailure(UNITTEST_FUNC, "fail() did not throw 'testfailure'");
+    }
+
+    void test_source_records_are_trivial()
+    {
+        assert_true(std::is_trivial<unittest::core::sourcespot>::value, SPOT);
+        assert_true(std::is_trivial<unittest::core::sourcecall>::value, SPOT);
+        const auto spot = SPOT;
+        assert_equal(__FILE__, std::string(spot.filename), SPOT);
+        assert_equal(__LINE__ - 2, spot.linenumber, SPOT);
+        assert_equal(unittest::core::failuresink::current(), NDAS.sink.get(), SPOT);
+    }
+
     void test_testcase_fail_full_info()
     {
         const std::string assertion("assert_something");
@@ -443,6 +800,29 @@ struct test_misc : unittest::testcase<> {
       ASSERT_TRUE_MSG(true, "message" << 42);
     }
 
+    void test_assertion_message_is_deferred()
+    {
+        int n_formatted = 0;
+        auto count = [&n_formatted]() { return ++n_formatted; };
+        for (int i=0; i<10; ++i)
+            ASSERT_EQUAL_MSG(i, i, "formatted " << count() << " times");
+        assert_equal(0, n_formatted, SPOT);
+    }
+
+    void test_assertion_message_on_failure()
+    {
+        const int value = 42;
+        bool caught = false;
+        try {
+            ASSERT_EQUAL_MSG(13, value, "value = " << value);
+        } catch (const unittest::testfailure& e) {
+            assert_equal("13 not equal to 42 - value = 42", unittest::join(e.what()), SPOT);
+            assert_equal("13, value", e.callsite(), SPOT);
+            caught = true;
+        }
+        assert_true(caught, SPOT);
+    }
+
 };
 
 REGISTER(test_misc)
@@ -0,0 +1,93 @@
+#include <libunittest/all.hpp>
+using namespace unittest::assertions;
+using unittest::core::perfcounts;
+
+struct test_perfcounters : unittest::testcase<> {
+
+    static void run()
+    {
+        UNITTEST_CLASS(test_perfcounters)
+        UNITTEST_RUN(test_defaults)
+        UNITTEST_RUN(test_difference)
+        UNITTEST_RUN(test_difference_scaled)
+        UNITTEST_RUN(test_difference_not_running)
+        UNITTEST_RUN(test_read_counters)
+    }
+
+    static perfcounts
+    make_counts(long long value,
+                long long time_enabled,
+                long long time_running)
+    {
+        perfcounts counts;
+        counts.measured = true;
+        counts.instructions = value;
+        counts.cycles = 2 * value;
+        counts.cache_misses = 3 * value;
+        counts.branch_misses = 4 * value;
+        counts.tlb_misses = -1;
+        counts.time_enabled = time_enabled;
+        counts.time_running = time_running;
+        return counts;
+    }
+
+    void test_defaults()
+    {
+        const perfcounts counts;
+        assert_false(counts.measured, SPOT);
+        assert_equal(-1, counts.instructions, SPOT);
+        assert_equal(-1, counts.cycles, SPOT);
+        assert_equal(-1, counts.cache_misses, SPOT);
+        assert_equal(-1, counts.branch_misses, SPOT);
+        assert_equal(-1, counts.tlb_misses, SPOT);
+    }
+
+    void test_difference()
+    {
+        const auto counts = unittest::core::perf_difference(make_counts(10, 100, 100), make_counts(30, 200, 200));
+        assert_true(counts.measured, SPOT);
+        assert_equal(20, counts.instructions, SPOT);
+        assert_equal(40, counts.cycles, SPOT);
+        assert_equal(60, counts.cache_misses, SPOT);
+        assert_equal(80, counts.branch_misses, SPOT);
+        assert_equal(-1, counts.tlb_misses, SPOT);
+        assert_equal(100, counts.time_enabled, SPOT);
+        assert_equal(100, counts.time_running, SPOT);
+    }
+
+    void test_difference_scaled()
+    {
+        const auto counts = unittest::core::perf_difference(make_counts(10, 100, 100), make_counts(30, 300, 200));
+        assert_true(counts.measured, SPOT);
+        assert_equal(40, counts.instructions, SPOT);
+        assert_equal(80, counts.cycles, SPOT);
+        assert_equal(-1, counts.tlb_misses, SPOT);
+    }
+
+    void test_difference_not_running()
+    {
+        const auto counts = unittest::core::perf_difference(make_counts(10, 100, 100), make_counts(10, 200, 100));
+        assert_false(counts.measured, SPOT);
+        const auto counts2 = unittest::core::perf_difference(perfcounts(), make_counts(10, 200, 200));
+        assert_false(counts2.measured, SPOT);
+    }
+
+    void test_read_counters()
+    {
+        std::string reason;
+        if (unittest::core::probe_perf_counters(&reason)) {
+            const auto start = unittest::core::read_perf_counters();
+            volatile long value = 0;
+            for (long i=0; i<100000; ++i)
+                value = value + i;
+            const auto counts = unittest::core::perf_difference(start, unittest::core::read_perf_counters());
+            if (counts.measured)
+                assert_greater(counts.instructions, 100000, SPOT);
+        } else {
+            assert_false(reason.empty(), SPOT);
+            assert_false(unittest::core::read_perf_counters().measured, SPOT);
+        }
+    }
+
+};
+REGISTER(test_perfcounters)
@@ -0,0 +1,137 @@
+#include <libunittest/all.hpp>
+#include <fstream>
+#include <vector>
+#include <cstdio>
+using namespace unittest::assertions;
+using unittest::core::resourceusage;
+
+struct test_resourceusage : unittest::testcase<> {
+
+    static void run()
+    {
+        UNITTEST_CLASS(test_resourceusage)
+        UNITTEST_RUN(test_defaults)
+        UNITTEST_RUN(test_difference)
+        UNITTEST_RUN(test_difference_not_measured)
+        UNITTEST_RUN(test_measure_cpu_time)
+        UNITTEST_RUN(test_measure_page_faults)
+        UNITTEST_RUN(test_measure_written_bytes)
+        UNITTEST_RUN(test_measure_without_self_read)
+    }
+
+    void test_defaults()
+    {
+        const resourceusage usage;
+        assert_false(usage.measured, SPOT);
+        assert_equal(0, usage.user_time, SPOT);
+        assert_equal(0, usage.system_time, SPOT);
+        assert_equal(0, usage.max_rss, SPOT);
+        assert_equal(0, usage.minor_faults, SPOT);
+        assert_equal(0, usage.major_faults, SPOT);
+        assert_equal(0, usage.voluntary_switches, SPOT);
+        assert_equal(0, usage.involuntary_switches, SPOT);
+        assert_equal(0, usage.read_bytes, SPOT);
+        assert_equal(0, usage.write_bytes, SPOT);
+        assert_equal(0, usage.counter_bytes, SPOT);
+    }
+
+    void test_difference()
+    {
+        resourceusage start;
+        start.measured = true;
+        start.user_time = 1;
+        start.system_time = 2;
+        start.max_rss = 4096;
+        start.minor_faults = 10;
+        start.major_faults = 1;
+        start.voluntary_switches = 5;
+        start.involuntary_switches = 6;
+        start.read_bytes = 100;
+        start.write_bytes = 200;
+        start.counter_bytes = 10;
+        resourceusage end = start;
+        end.user_time = 1.5;
+        end.system_time = 2.25;
+        end.max_rss = 8192;
+        end.minor_faults = 15;
+        end.involuntary_switches = 9;
+        end.read_bytes = 150;
+        end.write_bytes = 1200;
+        const auto usage = unittest::core::resource_difference(start, end);
+        assert_true(usage.measured, SPOT);
+        assert_equal(0.5, usage.user_time, SPOT);
+        assert_equal(0.25, usage.system_time, SPOT);
+        assert_equal(4096, usage.max_rss, SPOT);
+        assert_equal(5, usage.minor_faults, SPOT);
+        assert_equal(0, usage.major_faults, SPOT);
+        assert_equal(0, usage.voluntary_switches, SPOT);
+        assert_equal(3, usage.involuntary_switches, SPOT);
+        assert_equal(40, usage.read_bytes, SPOT);
+        assert_equal(1000, usage.write_bytes, SPOT);
+    }
+
+    void test_difference_not_measured()
+    {
+        resourceusage start;
+        resourceusage end;
+        end.measured = true;
+        end.user_time = 1;
+        const auto usage = unittest::core::resource_difference(start, end);
+        assert_false(usage.measured, SPOT);
+        assert_equal(0, usage.user_time, SPOT);
+    }
+
+    void test_measure_cpu_time()
+    {
+#ifndef _MSC_VER
+        const auto start = unittest::core::measure_resources();
+        assert_true(start.measured, SPOT);
+        volatile double value = 0;
+        resourceusage usage;
+        for (int i=0; i<1000 && usage.user_time + usage.system_time <= 0; ++i) {
+            for (int j=0; j<100000; ++j)
+                value = value + j;
+            usage = unittest::core::resource_difference(start, unittest::core::measure_resources());
+        }
+        assert_greater(usage.user_time + usage.system_time, 0, SPOT);
+#endif
+    }
+
+    void test_measure_page_faults()
+    {
+#ifndef _MSC_VER
+        const auto start = unittest::core::measure_resources();
+        std::vector<char> memory(1 << 24);
+        for (size_t i=0; i<memory.size(); i+=4096)
+            memory[i] = 1;
+        const auto usage = unittest::core::resource_difference(start, unittest::core::measure_resources());
+        assert_greater(usage.minor_faults + usage.major_faults, 0, SPOT);
+#endif
+    }
+
+    void test_measure_written_bytes()
+    {
+#ifdef __linux__
+        const std::string filename = "test_resourceusage.tmp";
+        const auto start = unittest::core::measure_resources();
+        {
+            std::ofstream file(filename, std::ios::binary);
+            file << std::string(1 << 16, 'x') << std::flush;
+        }
+        const auto usage = unittest::core::resource_difference(start, unittest::core::measure_resources());
+        std::remove(filename.c_str());
+        assert_greater_equal(usage.write_bytes, 1 << 16, SPOT);
+#endif
+    }
+
+    void test_measure_without_self_read()
+    {
+#ifdef __linux__
+        const auto start = unittest::core::measure_resources();
+        const auto usage = unittest::core::resource_difference(start, unittest::core::measure_resources());
+        assert_equal(0, usage.read_bytes, SPOT);
+#endif
+    }
+
+};
+REGISTER(test_resourceusage)
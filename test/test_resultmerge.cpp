@@ -0,0 +1,339 @@
+#include <libunittest/all.hpp>
+#include <cstdio>
+#include <atomic>
+#include <fstream>
+#include <sstream>
+using namespace unittest::assertions;
+using unittest::core::testlog;
+using unittest::core::testresults;
+using unittest::core::teststatus;
+using unittest::core::shardinfo;
+
+unittest::core::testresults make_sample_results();
+
+struct test_resultmerge : unittest::testcase<> {
+
+    static void run()
+    {
+        UNITTEST_CLASS(test_resultmerge)
+        UNITTEST_RUN(test_xml_roundtrip)
+        UNITTEST_RUN(test_xml_roundtrip_details)
+        UNITTEST_RUN(test_xml_shard_info)
+        UNITTEST_RUN(test_binary_roundtrip)
+        UNITTEST_RUN(test_merge_orders_by_name)
+        UNITTEST_RUN(test_merge_keeps_last_run)
+        UNITTEST_RUN(test_merge_mixed_formats)
+        UNITTEST_RUN(test_merge_into_binary)
+        UNITTEST_RUN(test_merge_skips_repeated_runs)
+        UNITTEST_RUN(test_shard_properties)
+        UNITTEST_RUN(test_not_a_results_file)
+    }
+
+    std::vector<std::string> filenames_;
+
+    ~test_resultmerge()
+    {
+        for (const auto& filename : filenames_)
+            std::remove(filename.c_str());
+    }
+
+    std::string make_filename(const std::string& extension)
+    {
+        static std::atomic<int> counter(0);
+        filenames_.push_back(unittest::join("test_resultmerge_", unittest::core::now().count(), "_", counter++, extension));
+        return filenames_.back();
+    }
+
+    static std::chrono::system_clock::time_point
+    time_point()
+    {
+        return std::chrono::system_clock::from_time_t(1234567890);
+    }
+
+    static testlog
+    make_log(const std::string& class_name,
+             const std::string& test_name,
+             teststatus status)
+    {
+        testlog log;
+        log.class_name = class_name;
+        log.test_name = test_name;
+        log.status = status;
+        log.successful = status==teststatus::success || status==teststatus::skipped;
+        if (status==teststatus::failure) {
+            log.error_type = "testfailure";
+            log.message = "failed";
+        }
+        return log;
+    }
+
+    static testresults
+    make_results(const std::vector<testlog>& testlogs)
+    {
+        testresults results;
+        for (const auto& log : testlogs) {
+            if (log.status!=teststatus::skipped) ++results.n_tests;
+            if (log.status==teststatus::success) ++results.n_successes;
+            if (log.status==teststatus::failure) ++results.n_failures;
+            if (log.status==teststatus::skipped) ++results.n_skipped;
+        }
+        results.successful = results.n_tests==results.n_successes;
+        results.duration = 1;
+        results.testlogs = testlogs;
+        return results;
+    }
+
+    std::string write_xml(const testresults& results,
+                          long long shuffle_seed=-1,
+                          int shard_index=0,
+                          int shard_count=1)
+    {
+        const auto filename = make_filename(".xml");
+        std::ofstream file(filename);
+        unittest::core::write_xml(file, results, "peter", shuffle_seed, time_point(), true, shard_index, shard_count);
+        return filename;
+    }
+
+    std::string write_binary(const testresults& results,
+                             long long shuffle_seed=-1)
+    {
+        const auto filename = make_filename(".bin");
+        auto stream = std::make_shared<std::ofstream>(filename, std::ios::binary);
+        unittest::core::binwriter writer(stream, "peter", shuffle_seed, 0, 1, time_point());
+        for (const auto& log : results.testlogs)
+            writer.report(log);
+        writer.finish(results);
+        return filename;
+    }
+
+    static std::string
+    to_xml(const testresults& results)
+    {
+        std::ostringstream stream;
+        unittest::core::write_xml(stream, results, "peter", -1, time_point(), false);
+        return stream.str();
+    }
+
+    void test_xml_roundtrip()
+    {
+        const auto results = make_sample_results();
+        const auto merged = unittest::core::merge_results({write_xml(results)});
+        assert_equal(to_xml(results), to_xml(merged), SPOT);
+    }
+
+    void test_xml_roundtrip_details()
+    {
+        auto results = make_sample_results();
+        results.testlogs[0].class_name = "a<&>\"'b";
+        results.testlogs[0].text = "some\ntext";
+        results.testlogs[1].assertion = "assert_equal";
+        results.testlogs[1].filename = "stuff.cpp";
+        results.testlogs[1].linenumber = 13;
+        results.testlogs[1].callsite = "assert_equal(1, 2)";
+        results.testlogs[1].resources.measured = true;
+        results.testlogs[1].resources.user_time = 0.5;
+        results.testlogs[1].resources.minor_faults = 42;
+        results.testlogs[1].resources.write_bytes = 4096;
+        results.testlogs[2].counters.measured = true;
+        results.testlogs[2].counters.instructions = 1000;
+        results.testlogs[2].counters.cycles = 2000;
+        results.testlogs[2].allocations.measured = true;
+        results.testlogs[2].allocations.count = 7;
+        results.testlogs[2].allocations.live_bytes = 48;
+        results.testlogs[2].benchmark = unittest::core::make_benchresult({0.5, 1.5}, 10, 0);
+        results.testlogs[2].baseline.compared = true;
+        results.testlogs[2].baseline.baseline_median = 0.75;
+        results.testlogs[2].baseline.ratio = 1.25;
+        results.testlogs[2].baseline.p_value = 0.25;
+        results.testlogs[1].sweep = unittest::core::fit_complexity({1, 2, 4}, {1, 2, 4});
+        results.testlogs[2].nd_failures.push_back(unittest::testfailure("assert_true", "first", "a.cpp", 1, "call1"));
+        auto skipped = make_log("test_class", "test4", teststatus::skipped);
+        skipped.text = "skip";
+        results.testlogs.push_back(skipped);
+        ++results.n_skipped;
+        const auto merged = unittest::core::merge_results({write_xml(results)});
+        assert_equal(to_xml(results), to_xml(merged), SPOT);
+        assert_equal("call1", merged.testlogs[2].nd_failures.at(0).callsite(), SPOT);
+        assert_equal(1, merged.testlogs[2].nd_failures.at(0).linenumber(), SPOT);
+        assert_true(merged.testlogs[1].resources.measured, SPOT);
+        assert_equal(42, merged.testlogs[1].resources.minor_faults, SPOT);
+        assert_false(merged.testlogs[0].resources.measured, SPOT);
+        assert_true(merged.testlogs[2].counters.measured, SPOT);
+        assert_equal(2000, merged.testlogs[2].counters.cycles, SPOT);
+        assert_equal(-1, merged.testlogs[2].counters.tlb_misses, SPOT);
+        assert_true(merged.testlogs[2].allocations.measured, SPOT);
+        assert_equal(7, merged.testlogs[2].allocations.count, SPOT);
+        assert_equal(48, merged.testlogs[2].allocations.live_bytes, SPOT);
+        assert_true(merged.testlogs[2].benchmark.measured, SPOT);
+        assert_equal(10, merged.testlogs[2].benchmark.iterations, SPOT);
+        assert_equal(1, merged.testlogs[2].benchmark.mean, SPOT);
+        assert_equal(2u, merged.testlogs[2].benchmark.samples.size(), SPOT);
+        assert_true(merged.testlogs[2].baseline.compared, SPOT);
+        assert_equal(1.25, merged.testlogs[2].baseline.ratio, SPOT);
+        assert_false(merged.testlogs[2].baseline.regressed, SPOT);
+        assert_true(merged.testlogs[1].sweep.measured, SPOT);
+        assert_true(merged.testlogs[1].sweep.best_fit==unittest::complexity::linear, SPOT);
+        assert_equal(1, merged.testlogs[1].sweep.coefficient, SPOT);
+        assert_equal(3u, merged.testlogs[1].sweep.ranges.size(), SPOT);
+        assert_equal(4, merged.testlogs[1].sweep.ranges[2], SPOT);
+        assert_equal(4, merged.testlogs[1].sweep.times[2], SPOT);
+        assert_false(merged.testlogs[2].sweep.measured, SPOT);
+    }
+
+    void test_xml_shard_info()
+    {
+        std::vector<shardinfo> shards;
+        const auto filename = write_xml(make_sample_results(), 42, 1, 3);
+        unittest::core::merge_results({filename}, &shards);
+        assert_equal(1u, shards.size(), SPOT);
+        assert_equal(filename, shards[0].filename, SPOT);
+        assert_equal("peter", shards[0].suite_name, SPOT);
+        assert_equal(42, shards[0].shuffle_seed, SPOT);
+        assert_equal(1, shards[0].shard_index, SPOT);
+        assert_equal(3, shards[0].shard_count, SPOT);
+        assert_equal(3, shards[0].totals.n_tests, SPOT);
+        assert_true(time_point()==shards[0].time_point, SPOT);
+    }
+
+    void test_binary_roundtrip()
+    {
+        const auto results = make_sample_results();
+        const auto merged = unittest::core::merge_results({write_binary(results)});
+        assert_equal(to_xml(results), to_xml(merged), SPOT);
+    }
+
+    void test_merge_orders_by_name()
+    {
+        const auto first = make_results({make_log("b", "2", teststatus::success), make_log("a", "1", teststatus::success)});
+        const auto second = make_results({make_log("c", "1", teststatus::success), make_log("a", "2", teststatus::skipped)});
+        const auto merged = unittest::core::merge_results({write_xml(first), write_xml(second)});
+        std::vector<std::string> names;
+        for (const auto& log : merged.testlogs)
+            names.push_back(log.class_name + "." + log.test_name);
+        assert_equal_containers(std::vector<std::string>{"a.1", "a.2", "b.2", "c.1"}, names, SPOT);
+        assert_equal(3, merged.n_tests, SPOT);
+        assert_equal(3, merged.n_successes, SPOT);
+        assert_equal(1, merged.n_skipped, SPOT);
+        assert_true(merged.successful, SPOT);
+    }
+
+    void test_merge_keeps_last_run()
+    {
+        const auto first = make_results({make_log("a", "1", teststatus::failure), make_log("a", "2", teststatus::success)});
+        const auto second = make_results({make_log("a", "1", teststatus::success)});
+        std::vector<std::unique_ptr<unittest::core::resultsource>> sources;
+        sources.push_back(unittest::core::open_resultsource(write_xml(first)));
+        sources.push_back(unittest::core::open_resultsource(write_xml(second)));
+        unittest::core::resultmerger merger(std::move(sources));
+        testlog log;
+        assert_true(merger.next(log), SPOT);
+        assert_equal("1", log.test_name, SPOT);
+        assert_equal(true, log.successful, SPOT);
+        assert_true(merger.next(log), SPOT);
+        assert_equal("2", log.test_name, SPOT);
+        assert_false(merger.next(log), SPOT);
+        assert_equal(1, merger.n_retried(), SPOT);
+        const auto totals = merger.totals();
+        assert_equal(2, totals.n_tests, SPOT);
+        assert_equal(0, totals.n_failures, SPOT);
+        assert_true(totals.successful, SPOT);
+    }
+
+    void test_merge_mixed_formats()
+    {
+        const auto first = make_results({make_log("a", "1", teststatus::success)});
+        const auto second = make_results({make_log("a", "1", teststatus::failure), make_log("b", "1", teststatus::success)});
+        const auto merged = unittest::core::merge_results({write_binary(first), write_xml(second)});
+        assert_equal(2u, merged.testlogs.size(), SPOT);
+        assert_true(teststatus::failure==merged.testlogs[0].status, SPOT);
+        assert_equal(1, merged.n_failures, SPOT);
+        assert_false(merged.successful, SPOT);
+    }
+
+    void test_merge_into_binary()
+    {
+        const auto first = make_results({make_log("b", "1", teststatus::failure), make_log("a", "1", teststatus::success)});
+        const auto second = make_results({make_log("b", "1", teststatus::success), make_log("c", "1", teststatus::skipped)});
+        const auto third = make_results({make_log("a", "2", teststatus::failure)});
+        const std::vector<std::string> filenames = {write_binary(first), write_xml(second), write_binary(third)};
+        const auto expected = unittest::core::merge_results(filenames);
+        std::vector<std::unique_ptr<unittest::core::resultsource>> sources;
+        for (const auto& filename : filenames)
+            sources.push_back(unittest::core::open_resultsource(filename));
+        unittest::core::resultmerger merger(std::move(sources));
+        const auto filename = make_filename(".bin");
+        {
+            auto stream = std::make_shared<std::ofstream>(filename, std::ios::binary);
+            unittest::core::binwriter writer(stream, "peter", -1, 0, 1, time_point());
+            while (merger.next(writer));
+            writer.finish(merger.totals());
+        }
+        assert_equal(1, merger.n_retried(), SPOT);
+        auto merged = unittest::core::binreader(filename).results();
+        merged.duration = expected.duration;
+        assert_equal(to_xml(expected), to_xml(merged), SPOT);
+    }
+
+    void test_merge_skips_repeated_runs()
+    {
+        const auto first = make_results({make_log("a", "1", teststatus::failure), make_log("b", "1", teststatus::success),
+                                         make_log("a", "1", teststatus::error), make_log("a", "1", teststatus::success)});
+        const auto second = make_results({make_log("b", "1", teststatus::failure)});
+        for (const auto& filename : {write_binary(first), write_xml(first)}) {
+            std::vector<std::unique_ptr<unittest::core::resultsource>> sources;
+            sources.push_back(unittest::core::open_resultsource(filename));
+            sources.push_back(unittest::core::open_resultsource(write_binary(second)));
+            unittest::core::resultmerger merger(std::move(sources));
+            assert_true(merger.skip(), SPOT);
+            assert_true(merger.skip(), SPOT);
+            assert_false(merger.skip(), SPOT);
+            assert_equal(3, merger.n_retried(), SPOT);
+            const auto totals = merger.totals();
+            assert_equal(2, totals.n_tests, SPOT);
+            assert_equal(1, totals.n_successes, SPOT);
+            assert_equal(1, totals.n_failures, SPOT);
+            assert_false(totals.successful, SPOT);
+        }
+    }
+
+    void test_shard_properties()
+    {
+        std::vector<shardinfo> shards(2);
+        shards[0].filename = "one.xml";
+        shards[0].suite_name = "peter";
+        shards[0].shuffle_seed = 42;
+        shards[0].shard_index = 0;
+        shards[0].shard_count = 2;
+        shards[0].totals.n_tests = 3;
+        shards[1].filename = "two.xml";
+        shards[1].suite_name = "paul";
+        const auto properties = unittest::core::make_shard_properties(shards);
+        std::ostringstream stream;
+        unittest::core::write_xml_properties(stream, properties);
+        std::ostringstream expected;
+        expected << "\t<properties>\n";
+        expected << "\t\t<property name=\"shard.0.file\" value=\"one.xml\"/>\n";
+        expected << "\t\t<property name=\"shard.0.suite\" value=\"peter\"/>\n";
+        expected << "\t\t<property name=\"shard.0.shuffseed\" value=\"42\"/>\n";
+        expected << "\t\t<property name=\"shard.0.shard\" value=\"0/2\"/>\n";
+        expected << "\t\t<property name=\"shard.0.tests\" value=\"3\"/>\n";
+        expected << "\t\t<property name=\"shard.1.file\" value=\"two.xml\"/>\n";
+        expected << "\t\t<property name=\"shard.1.suite\" value=\"paul\"/>\n";
+        expected << "\t\t<property name=\"shard.1.tests\" value=\"0\"/>\n";
+        expected << "\t</properties>\n";
+        assert_equal(expected.str(), stream.str(), SPOT);
+    }
+
+    void test_not_a_results_file()
+    {
+        const auto filename = make_filename(".txt");
+        {
+            std::ofstream file(filename);
+            file << "just some text";
+        }
+        assert_throw<std::runtime_error>([&](){ unittest::core::open_resultsource(filename); }, SPOT);
+        assert_throw<std::runtime_error>([&](){ unittest::core::open_resultsource(filename + ".missing"); }, SPOT);
+    }
+
+};
+REGISTER(test_resultmerge)
@@ -0,0 +1,81 @@
+#include <libunittest/all.hpp>
+using namespace unittest::assertions;
+using unittest::core::testhistory;
+using unittest::core::testlog;
+using unittest::core::teststatus;
+
+struct test_sharding : unittest::testcase<> {
+
+    static void run()
+    {
+        UNITTEST_CLASS(test_sharding)
+        UNITTEST_RUN(test_hash_shard_is_stable)
+        UNITTEST_RUN(test_hash_shard_single)
+        UNITTEST_RUN(test_balance_shards)
+        UNITTEST_RUN(test_select_shard_partitions)
+        UNITTEST_RUN(test_select_shard_single)
+    }
+
+    std::vector<std::string> class_names_;
+
+    test_sharding()
+        : class_names_({"paul", "peter", "mary", "john", "ringo", "george"})
+    {}
+
+    void test_hash_shard_is_stable()
+    {
+        assert_equal(5, unittest::core::hash_shard("", 16), SPOT);
+        assert_equal(12, unittest::core::hash_shard("a", 16), SPOT);
+    }
+
+    void test_hash_shard_single()
+    {
+        assert_equal(0, unittest::core::hash_shard("peter", 1), SPOT);
+        assert_equal(0, unittest::core::hash_shard("peter", 0), SPOT);
+    }
+
+    void test_balance_shards()
+    {
+        testhistory history;
+        const std::vector<double> durations = {4., 3., 3., 2., 2., 2.};
+        for (size_t i=0; i<class_names_.size(); ++i) {
+            testlog log;
+            log.class_name = class_names_[i];
+            log.test_name = "test";
+            log.status = teststatus::success;
+            log.duration = durations[i];
+            history.record(log);
+        }
+        const auto shards = unittest::core::balance_shards(class_names_, history, 2, 1.);
+        const std::vector<int> expected = {0, 1, 1, 0, 1, 0};
+        assert_equal_containers(expected, shards, SPOT);
+    }
+
+    void test_select_shard_partitions()
+    {
+        const testhistory history;
+        for (auto balanced : {false, true}) {
+            std::vector<size_t> all;
+            for (int shard=0; shard<3; ++shard) {
+                std::vector<size_t> schedule = {5, 4, 3, 2, 1, 0};
+                unittest::core::select_shard(schedule, class_names_, history, shard, 3, balanced, 1.);
+                all.insert(all.end(), schedule.begin(), schedule.end());
+            }
+            std::sort(all.begin(), all.end());
+            const std::vector<size_t> expected = {0, 1, 2, 3, 4, 5};
+            assert_equal_containers(expected, all, SPOT);
+        }
+    }
+
+    void test_select_shard_single()
+    {
+        const testhistory history;
+        std::vector<size_t> schedule = {2, 0, 1};
+        unittest::core::select_shard(schedule, class_names_, history, 0, 1, false, 1.);
+        const std::vector<size_t> expected = {2, 0, 1};
+        assert_equal_containers(expected, schedule, SPOT);
+    }
+
+};
+
+REGISTER(test_sharding)
@@ -0,0 +1,206 @@
+#include <libunittest/all.hpp>
+#include <cstdio>
+#include <fstream>
+using namespace unittest::assertions;
+using unittest::core::testrecord;
+using unittest::core::testhistory;
+using unittest::core::testlog;
+using unittest::core::teststatus;
+
+struct test_testhistory : unittest::testcase<> {
+
+    static void run()
+    {
+        UNITTEST_CLASS(test_testhistory)
+        UNITTEST_RUN(test_testrecord_defaults)
+        UNITTEST_RUN(test_testrecord_add)
+        UNITTEST_RUN(test_testrecord_add_skipped)
+        UNITTEST_RUN(test_testrecord_percentile)
+        UNITTEST_RUN(test_record_and_find)
+        UNITTEST_RUN(test_save_and_load)
+        UNITTEST_RUN(test_compact_keeps_appended_runs)
+        UNITTEST_RUN(test_load_missing_file)
+        UNITTEST_RUN(test_expected_class_duration)
+        UNITTEST_RUN(test_class_names_with_colons)
+        UNITTEST_RUN(test_order_longest_first)
+    }
+
+    std::string filename_;
+
+    test_testhistory()
+        : filename_(unittest::join("test_testhistory_", unittest::core::now().count(), ".hist"))
+    {}
+
+    ~test_testhistory()
+    {
+        std::remove(filename_.c_str());
+    }
+
+    testlog make_log(const std::string& test_name, teststatus status, double duration)
+    {
+        testlog log;
+        log.class_name = "peter";
+        log.test_name = test_name;
+        log.status = status;
+        log.duration = duration;
+        return log;
+    }
+
+    void test_testrecord_defaults()
+    {
+        testrecord record;
+        assert_equal(0, record.n_runs, SPOT);
+        assert_equal(0, record.n_timeouts, SPOT);
+        assert_equal(0, record.average, SPOT);
+        assert_equal(0, record.percentile(0.5), SPOT);
+    }
+
+    void test_testrecord_add()
+    {
+        testrecord record;
+        record.add(1., teststatus::success, false);
+        assert_equal(1, record.n_runs, SPOT);
+        assert_equal(1, record.n_successes, SPOT);
+        assert_approx_equal(1., record.average, 1e-12, SPOT);
+        record.add(2., teststatus::failure, true);
+        record.add(3., teststatus::error, false);
+        assert_equal(3, record.n_runs, SPOT);
+        assert_equal(1, record.n_failures, SPOT);
+        assert_equal(1, record.n_errors, SPOT);
+        assert_equal(1, record.n_timeouts, SPOT);
+        assert_approx_equal(3., record.last, 1e-12, SPOT);
+        assert_in_range(record.average, 1., 3., SPOT);
+    }
+
+    void test_testrecord_add_skipped()
+    {
+        testrecord record;
+        record.add(1., teststatus::skipped, false);
+        assert_equal(0, record.n_runs, SPOT);
+    }
+
+    void test_testrecord_percentile()
+    {
+        testrecord record;
+        for (int i=0; i<90; ++i)
+            record.add(0.001, teststatus::success, false);
+        for (int i=0; i<10; ++i)
+            record.add(1., teststatus::success, false);
+        assert_in_range(record.percentile(0.5), 0.001, 0.0015, SPOT);
+        assert_in_range(record.percentile(0.99), 1., 1.5, SPOT);
+    }
+
+    void test_record_and_find()
+    {
+        testhistory history;
+        assert_true(history.find("peter::test") == nullptr, SPOT);
+        history.record(make_log("test", teststatus::success, 0.5));
+        history.record(make_log("skipped", teststatus::skipped, 0.));
+        assert_equal(1u, history.size(), SPOT);
+        assert_true(history.find("peter::test") != nullptr, SPOT);
+        assert_approx_equal(0.5, history.find("peter::test")->average, 1e-12, SPOT);
+    }
+
+    void test_save_and_load()
+    {
+        {
+            testhistory history;
+            history.load(filename_);
+            history.record(make_log("test1", teststatus::success, 0.5));
+            history.record(make_log("test2", teststatus::failure, 0.25));
+            history.save(filename_);
+        }
+        {
+            testhistory history;
+            history.load(filename_);
+            history.record(make_log("test1", teststatus::success, 0.5));
+            history.save(filename_);
+        }
+        testhistory history;
+        history.load(filename_);
+        assert_equal(2u, history.size(), SPOT);
+        assert_equal(2, history.find("peter::test1")->n_runs, SPOT);
+        assert_equal(1, history.find("peter::test2")->n_failures, SPOT);
+        assert_approx_equal(0.25, history.find("peter::test2")->average, 1e-9, SPOT);
+    }
+
+    void test_compact_keeps_appended_runs()
+    {
+        {
+            testhistory history;
+            for (int i=0; i<1100; ++i)
+                history.record(make_log("test1", teststatus::success, 0.5));
+            history.save(filename_);
+        }
+        testhistory history;
+        history.load(filename_);
+        {
+            testhistory other;
+            other.record(make_log("test2", teststatus::success, 0.5));
+            other.save(filename_);
+        }
+        history.record(make_log("test1", teststatus::success, 0.5));
+        history.save(filename_);
+        std::ifstream file(filename_);
+        const std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        assert_equal(std::string::npos, content.find("\nE\t"), SPOT);
+        testhistory loaded;
+        loaded.load(filename_);
+        assert_equal(1101, loaded.find("peter::test1")->n_runs, SPOT);
+        assert_equal(1, loaded.find("peter::test2")->n_runs, SPOT);
+    }
+
+    void test_load_missing_file()
+    {
+        testhistory history;
+        history.load(filename_ + ".missing");
+        assert_equal(0u, history.size(), SPOT);
+    }
+
+    void test_expected_class_duration()
+    {
+        testhistory history;
+        assert_lesser(history.expected_class_duration("peter"), 0., SPOT);
+        history.record(make_log("test1", teststatus::success, 0.5));
+        history.record(make_log("test2", teststatus::failure, 0.25));
+        assert_approx_equal(0.75, history.expected_class_duration("peter"), 1e-12, SPOT);
+        assert_lesser(history.expected_class_duration("pete"), 0., SPOT);
+    }
+
+    void test_class_names_with_colons()
+    {
+        {
+            testhistory history;
+            auto log = make_log("test<a::b>", teststatus::success, 0.5);
+            log.class_name = "paul::mary";
+            history.record(log);
+            log = make_log("test", teststatus::success, 0.25);
+            log.class_name = "paul::mary";
+            history.record(log);
+            assert_approx_equal(0.75, history.expected_class_duration("paul::mary"), 1e-12, SPOT);
+            assert_lesser(history.expected_class_duration("paul::mary::test<a"), 0., SPOT);
+            history.save(filename_);
+        }
+        testhistory history;
+        history.load(filename_);
+        assert_equal("paul::mary", history.find("paul::mary::test<a::b>")->class_name, SPOT);
+        assert_approx_equal(0.75, history.expected_class_duration("paul::mary"), 1e-9, SPOT);
+        assert_lesser(history.expected_class_duration("paul"), 0., SPOT);
+    }
+
+    void test_order_longest_first()
+    {
+        testhistory history;
+        history.record(make_log("test", teststatus::success, 0.5));
+        const std::vector<std::string> class_names = {"paul", "peter", "mary", "john"};
+        std::vector<size_t> schedule = {3, 2, 1, 0};
+        const auto estimates = order_longest_first(schedule, class_names, history, 0.25);
+        const std::vector<size_t> exp_schedule = {1, 3, 2, 0};
+        assert_equal_containers(exp_schedule, schedule, SPOT);
+        const std::vector<double> exp_estimates = {0.5, 0.25, 0.25, 0.25};
+        assert_equal_containers(exp_estimates, estimates, SPOT);
+    }
+
+};
+
+REGISTER(test_testhistory)
@@ -1,6 +1,14 @@
 #include <libunittest/all.hpp>
 using namespace unittest::assertions;
 
+struct threadsafe_class {};
+
+struct not_threadsafe_class {
+    UNITTEST_NOT_THREADSAFE
+};
+
+struct derived_not_threadsafe_class : not_threadsafe_class {};
+
 struct test_testrun : unittest::testcase<> {
 
     static void run()
@@ -8,6 +16,9 @@ struct test_testrun : unittest::testcase<> {
         UNITTEST_CLASS(test_testrun)
         UNITTEST_RUN(test_make_method_id)
         UNITTEST_RUN(test_update_local_timeout)
+        UNITTEST_RUN(test_is_threadsafe)
+        UNITTEST_RUN(test_get_method_threadpool)
+        UNITTEST_RUN(test_log_text_of_monitored_test)
     }
 
     void test_make_method_id()
@@ -28,6 +39,77 @@ struct test_testrun : unittest::testcase<> {
         assert_equal(2, local_timeout, SPOT);
     }
 
+    void test_is_threadsafe()
+    {
+        assert_true(unittest::core::is_threadsafe<threadsafe_class>::value, SPOT);
+        assert_false(unittest::core::is_threadsafe<not_threadsafe_class>::value, SPOT);
+        assert_false(unittest::core::is_threadsafe<derived_not_threadsafe_class>::value, SPOT);
+    }
+
+    void test_get_method_threadpool()
+    {
+        if (!unittest::core::testsuite::instance()->get_arguments().parallel_methods)
+            assert_true(unittest::core::get_method_threadpool()==nullptr, SPOT);
+        std::atomic<unittest::core::threadpool*> pool(nullptr);
+        std::thread thread([&pool]() { pool = unittest::core::get_method_threadpool(); });
+        thread.join();
+        assert_true(pool.load()==nullptr, SPOT);
+    }
+
+    void test_log_text_of_monitored_test()
+    {
+        using unittest::core::testmonitor;
+        assert_true(testmonitor::log_text(get_test_id(), "text"), SPOT);
+        assert_false(testmonitor::log_text("no_such_method", "text"), SPOT);
+        bool is_logged = true;
+        std::thread thread([this, &is_logged]() { is_logged = testmonitor::log_text(get_test_id(), "text"); });
+        thread.join();
+        assert_false(is_logged, SPOT);
+    }
+
 };
 
 REGISTER(test_testrun)
+
+struct test_testrun_not_threadsafe : unittest::testcase<> {
+
+    UNITTEST_NOT_THREADSAFE
+
+    static void run()
+    {
+        UNITTEST_CLASS(test_testrun_not_threadsafe)
+        UNITTEST_RUN(test_runs_alone_1)
+        UNITTEST_RUN(test_runs_alone_2)
+        UNITTEST_RUN(test_runs_alone_3)
+    }
+
+    static std::atomic<int> n_running_;
+
+    void assert_runs_alone()
+    {
+        const int n_running = ++n_running_;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        --n_running_;
+        assert_equal(1, n_running, SPOT);
+    }
+
+    void test_runs_alone_1()
+    {
+        assert_runs_alone();
+    }
+
+    void test_runs_alone_2()
+    {
+        assert_runs_alone();
+    }
+
+    void test_runs_alone_3()
+    {
+        assert_runs_alone();
+    }
+
+};
+
+std::atomic<int> test_testrun_not_threadsafe::n_running_(0);
+
+REGISTER(test_testrun_not_threadsafe)
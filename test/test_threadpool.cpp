@@ -0,0 +1,95 @@
+#include <libunittest/all.hpp>
+#include <mutex>
+#include <set>
+using namespace unittest::assertions;
+using unittest::core::threadpool;
+
+struct test_threadpool : unittest::testcase<> {
+
+    static void run()
+    {
+        UNITTEST_CLASS(test_threadpool)
+        UNITTEST_RUN(test_size)
+        UNITTEST_RUN(test_push_and_wait)
+        UNITTEST_RUN(test_push_from_worker)
+        UNITTEST_RUN(test_current)
+        UNITTEST_RUN(test_exception_is_rethrown)
+        UNITTEST_RUN(test_wait_reuses_threads)
+    }
+
+    void test_size()
+    {
+        threadpool pool1(3);
+        assert_equal(3, pool1.size(), SPOT);
+        threadpool pool2(0);
+        assert_equal(1, pool2.size(), SPOT);
+    }
+
+    void test_push_and_wait()
+    {
+        threadpool pool(4);
+        std::atomic<int> counter(0);
+        for (int i=0; i<100; ++i)
+            pool.push([&counter]() { ++counter; });
+        pool.wait();
+        assert_equal(100, counter.load(), SPOT);
+    }
+
+    void test_push_from_worker()
+    {
+        threadpool pool(2);
+        std::atomic<int> counter(0);
+        for (int i=0; i<10; ++i) {
+            pool.push([&pool, &counter]() {
+                for (int j=0; j<10; ++j)
+                    pool.push([&counter]() { ++counter; });
+            });
+        }
+        pool.wait();
+        assert_equal(100, counter.load(), SPOT);
+    }
+
+    void test_current()
+    {
+        std::atomic<threadpool*> current(nullptr);
+        std::thread thread([&current]() { current = threadpool::current(); });
+        thread.join();
+        assert_true(current.load()==nullptr, SPOT);
+        threadpool pool(2);
+        pool.push([&current]() { current = threadpool::current(); });
+        pool.wait();
+        assert_true(current.load()==&pool, SPOT);
+    }
+
+    void test_exception_is_rethrown()
+    {
+        threadpool pool(2);
+        pool.push([]() { throw std::runtime_error("peter"); });
+        auto functor = [&pool]() { pool.wait(); };
+        assert_throw<std::runtime_error>(functor, SPOT);
+        std::atomic<int> counter(0);
+        pool.push([&counter]() { ++counter; });
+        pool.wait();
+        assert_equal(1, counter.load(), SPOT);
+    }
+
+    void test_wait_reuses_threads()
+    {
+        threadpool pool(2);
+        std::mutex mutex;
+        std::set<std::thread::id> ids;
+        for (int round=0; round<5; ++round) {
+            for (int i=0; i<4; ++i) {
+                pool.push([&mutex, &ids]() {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    ids.insert(std::this_thread::get_id());
+                });
+            }
+            pool.wait();
+        }
+        assert_in_range(ids.size(), 1u, 2u, SPOT);
+    }
+
+};
+
+REGISTER(test_threadpool)
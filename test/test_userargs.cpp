@@ -26,6 +26,21 @@ struct test_userargs : unittest::testcase<> {
         UNITTEST_RUN(test_disable_timeout)
         UNITTEST_RUN(test_max_string_length)
         UNITTEST_RUN(test_max_value_precision)
+        UNITTEST_RUN(test_parallel_methods)
+        UNITTEST_RUN(test_history_filename)
+        UNITTEST_RUN(test_default_estimate)
+        UNITTEST_RUN(test_shard)
+        UNITTEST_RUN(test_shard_errors)
+        UNITTEST_RUN(test_isolate_classes)
+        UNITTEST_RUN(test_keep_timeouts)
+        UNITTEST_RUN(test_worker_processes)
+        UNITTEST_RUN(test_json_filename)
+        UNITTEST_RUN(test_console_output)
+        UNITTEST_RUN(test_resource_usage)
+        UNITTEST_RUN(test_perf_counters)
+        UNITTEST_RUN(test_track_allocations)
+        UNITTEST_RUN(test_bench_settings)
+        UNITTEST_RUN(test_baseline_settings)
         UNITTEST_RUN(test_verbose_failure_stop)
         UNITTEST_RUN(test_verbose_generate_xml)
         UNITTEST_RUN(test_failure_stop_generate_xml)
@@ -357,6 +372,196 @@ struct test_userargs : unittest::testcase<> {
         assert_equal("libunittest", args.suite_name, SPOT);
     }
 
+    void test_parallel_methods()
+    {
+        userargs args1;
+        assert_equal(false, args1.parallel_methods, SPOT);
+        arguments_[1] = (char*)"-m";
+        userargs args2;
+        args2.parse(2, arguments_);
+        assert_equal(true, args2.parallel_methods, SPOT);
+        assert_equal(0, args2.concurrent_threads, SPOT);
+    }
+
+    void test_history_filename()
+    {
+        userargs args1;
+        assert_equal("", args1.history_filename, SPOT);
+        arguments_[1] = (char*)"-w";
+        arguments_[2] = (char*)"durations.hist";
+        userargs args2;
+        args2.parse(3, arguments_);
+        assert_equal("durations.hist", args2.history_filename, SPOT);
+    }
+
+    void test_default_estimate()
+    {
+        userargs args1;
+        assert_equal(1., args1.default_estimate, SPOT);
+        arguments_[1] = (char*)"-a";
+        arguments_[2] = (char*)"0.5";
+        userargs args2;
+        args2.parse(3, arguments_);
+        assert_equal(0.5, args2.default_estimate, SPOT);
+    }
+
+    void test_shard()
+    {
+        userargs args1;
+        assert_equal(0, args1.shard_index, SPOT);
+        assert_equal(1, args1.shard_count, SPOT);
+        assert_equal("", args1.balance_filename, SPOT);
+        arguments_[1] = (char*)"-y";
+        arguments_[2] = (char*)"3/16";
+        arguments_[3] = (char*)"-b";
+        arguments_[4] = (char*)"snapshot.hist";
+        userargs args2;
+        args2.parse(5, arguments_);
+        assert_equal(3, args2.shard_index, SPOT);
+        assert_equal(16, args2.shard_count, SPOT);
+        assert_equal("snapshot.hist", args2.balance_filename, SPOT);
+    }
+
+    void test_shard_errors()
+    {
+        const std::vector<char*> values = {
+                (char*)"3", (char*)"3/", (char*)"a/b", (char*)"16/16", (char*)"-1/4", (char*)"0/0"
+        };
+        for (auto value : values) {
+            arguments_[1] = (char*)"-y";
+            arguments_[2] = value;
+            userargs args;
+            assert_throw<argparser::exit_error>([&](){ args.parse(3, arguments_); }, SPOT);
+        }
+    }
+
+    void test_isolate_classes()
+    {
+        userargs args1;
+        assert_equal(false, args1.isolate_classes, SPOT);
+        arguments_[1] = (char*)"-j";
+        userargs args2;
+        args2.parse(2, arguments_);
+        assert_equal(true, args2.isolate_classes, SPOT);
+    }
+
+    void test_keep_timeouts()
+    {
+        userargs args1;
+        assert_equal(false, args1.keep_timeouts, SPOT);
+        arguments_[1] = (char*)"-K";
+        userargs args2;
+        args2.parse(2, arguments_);
+        assert_equal(true, args2.keep_timeouts, SPOT);
+    }
+
+    void test_worker_processes()
+    {
+        userargs args1;
+        assert_equal(0, args1.worker_processes, SPOT);
+        arguments_[1] = (char*)"-P";
+        arguments_[2] = (char*)"4";
+        userargs args2;
+        args2.parse(3, arguments_);
+        assert_equal(4, args2.worker_processes, SPOT);
+        arguments_[2] = (char*)"-2";
+        userargs args3;
+        args3.parse(3, arguments_);
+        assert_equal(0, args3.worker_processes, SPOT);
+    }
+
+    void test_json_filename()
+    {
+        userargs args1;
+        assert_equal("", args1.json_filename, SPOT);
+        arguments_[1] = (char*)"-J";
+        arguments_[2] = (char*)"/dev/fd/3";
+        userargs args2;
+        args2.parse(3, arguments_);
+        assert_equal("/dev/fd/3", args2.json_filename, SPOT);
+        assert_equal(false, args2.generate_xml, SPOT);
+    }
+
+    void test_console_output()
+    {
+        userargs args1;
+        assert_equal(0.1, args1.console_interval, SPOT);
+        assert_equal(false, args1.ordered_output, SPOT);
+        assert_equal(false, args1.silent_output, SPOT);
+        arguments_[1] = (char*)"-c";
+        arguments_[2] = (char*)"0.5";
+        arguments_[3] = (char*)"-OS";
+        userargs args2;
+        args2.parse(4, arguments_);
+        assert_equal(0.5, args2.console_interval, SPOT);
+        assert_equal(true, args2.ordered_output, SPOT);
+        assert_equal(true, args2.silent_output, SPOT);
+    }
+
+    void test_resource_usage()
+    {
+        userargs args1;
+        assert_equal(false, args1.resource_usage, SPOT);
+        arguments_[1] = (char*)"-R";
+        userargs args2;
+        args2.parse(2, arguments_);
+        assert_equal(true, args2.resource_usage, SPOT);
+    }
+
+    void test_perf_counters()
+    {
+        userargs args1;
+        assert_equal(false, args1.perf_counters, SPOT);
+        arguments_[1] = (char*)"-H";
+        userargs args2;
+        args2.parse(2, arguments_);
+        assert_equal(true, args2.perf_counters, SPOT);
+    }
+
+    void test_track_allocations()
+    {
+        userargs args1;
+        assert_equal(false, args1.track_allocations, SPOT);
+        arguments_[1] = (char*)"-A";
+        userargs args2;
+        args2.parse(2, arguments_);
+        assert_equal(true, args2.track_allocations, SPOT);
+    }
+
+    void test_bench_settings()
+    {
+        userargs args1;
+        assert_equal(0.01, args1.bench_time, SPOT);
+        assert_equal(10, args1.bench_samples, SPOT);
+        arguments_[1] = (char*)"-M";
+        arguments_[2] = (char*)"0.5";
+        arguments_[3] = (char*)"-N";
+        arguments_[4] = (char*)"0";
+        userargs args2;
+        args2.parse(5, arguments_);
+        assert_equal(0.5, args2.bench_time, SPOT);
+        assert_equal(1, args2.bench_samples, SPOT);
+    }
+
+    void test_baseline_settings()
+    {
+        userargs args1;
+        assert_equal("", args1.baseline_filename, SPOT);
+        assert_equal("", args1.save_baseline_filename, SPOT);
+        assert_equal(0.05, args1.bench_threshold, SPOT);
+        arguments_[1] = (char*)"-E";
+        arguments_[2] = (char*)"old.base";
+        arguments_[3] = (char*)"-F";
+        arguments_[4] = (char*)"new.base";
+        arguments_[5] = (char*)"-T";
+        arguments_[6] = (char*)"0.1";
+        userargs args2;
+        args2.parse(7, arguments_);
+        assert_equal("old.base", args2.baseline_filename, SPOT);
+        assert_equal("new.base", args2.save_baseline_filename, SPOT);
+        assert_equal(0.1, args2.bench_threshold, SPOT);
+    }
+
     void test_verbose_failure_stop()
     {
         const std::vector<char*> values = {(char*)"-vs", (char*)"-sv"};
@@ -17,6 +17,7 @@ struct test_utilities : unittest::testcase<> {
         UNITTEST_RUN(test_write_horizontal_bar)
         UNITTEST_RUN(test_duration_in_seconds)
         UNITTEST_RUN(test_xml_escape)
+        UNITTEST_RUN(test_json_escape)
         UNITTEST_RUN(test_make_iso_timestamp)
         UNITTEST_RUN(test_call_functions_empty_vector)
         UNITTEST_RUN(test_call_functions_vector_size_one)
@@ -159,6 +160,19 @@ struct test_utilities : unittest::testcase<> {
         assert_equal("&gt;", function(">"), SPOT);
     }
 
+    void test_json_escape()
+    {
+        auto function = unittest::core::json_escape;
+        assert_equal("", function(""), SPOT);
+        assert_equal("stuff", function("stuff"), SPOT);
+        assert_equal("blöd", function("blöd"), SPOT);
+        assert_equal("\\\"", function("\""), SPOT);
+        assert_equal("\\\\", function("\\"), SPOT);
+        assert_equal("a\\nb\\tc\\r", function("a\nb\tc\r"), SPOT);
+        assert_equal("\\u0001\\u001f", function("\x01\x1f"), SPOT);
+        assert_equal("<&'>", function("<&'>"), SPOT);
+    }
+
     void test_make_iso_timestamp()
     {
         auto function = unittest::core::make_iso_timestamp;
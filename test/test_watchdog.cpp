@@ -0,0 +1,96 @@
+#include <libunittest/all.hpp>
+#include <thread>
+#include <vector>
+using namespace unittest::assertions;
+using unittest::core::watchdog;
+
+struct test_watchdog : unittest::testcase<> {
+
+    static void run()
+    {
+        UNITTEST_CLASS(test_watchdog)
+        UNITTEST_RUN(test_instance)
+        UNITTEST_RUN(test_run_finished)
+        UNITTEST_RUN(test_run_concurrent)
+        UNITTEST_RUN(test_run_expired)
+    }
+
+    void test_instance()
+    {
+        assert_true(watchdog::instance()!=nullptr, SPOT);
+        assert_equal(watchdog::instance(), watchdog::instance(), SPOT);
+    }
+
+    void test_run_finished()
+    {
+        for (int i=0; i<10; ++i) {
+            auto done = std::make_shared<std::atomic_bool>(false);
+            auto has_timed_out = std::make_shared<std::atomic_bool>(false);
+            int value = 0;
+            watchdog::instance()->run([&value, done]() { value = 42; done->store(true); },
+                                      done, has_timed_out, 10);
+            assert_equal(42, value, SPOT);
+            assert_true(done->load(), SPOT);
+            assert_false(has_timed_out->load(), SPOT);
+        }
+    }
+
+    void test_run_concurrent()
+    {
+        const int n_threads = 8;
+        std::vector<std::shared_ptr<std::atomic_bool>> timed_out;
+        std::vector<std::thread> threads;
+        for (int i=0; i<n_threads; ++i) {
+            auto has_timed_out = std::make_shared<std::atomic_bool>(false);
+            timed_out.push_back(has_timed_out);
+            threads.push_back(std::thread([i, has_timed_out]() {
+                auto done = std::make_shared<std::atomic_bool>(false);
+                watchdog::instance()->run([done]() {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                    done->store(true);
+                }, done, has_timed_out, 10 + i);
+            }));
+        }
+        for (auto& thread : threads)
+            thread.join();
+        for (const auto& has_timed_out : timed_out)
+            assert_false(has_timed_out->load(), SPOT);
+    }
+
+    void test_run_expired()
+    {
+        auto release = std::make_shared<std::atomic_bool>(false);
+        auto started = std::make_shared<std::atomic_bool>(false);
+        auto expired_id = std::make_shared<std::thread::id>();
+        auto done = std::make_shared<std::atomic_bool>(false);
+        auto has_timed_out = std::make_shared<std::atomic_bool>(false);
+        watchdog::instance()->run([release, started, expired_id, done]() {
+            *expired_id = std::this_thread::get_id();
+            started->store(true);
+            while (!release->load())
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            done->store(true);
+        }, done, has_timed_out, 0.01);
+        assert_true(has_timed_out->load(), SPOT);
+        assert_false(done->load(), SPOT);
+        while (!started->load())
+            std::this_thread::yield();
+        for (int i=0; i<3; ++i) {
+            auto next_done = std::make_shared<std::atomic_bool>(false);
+            auto next_timed_out = std::make_shared<std::atomic_bool>(false);
+            std::thread::id next_id;
+            watchdog::instance()->run([&next_id, next_done]() {
+                next_id = std::this_thread::get_id();
+                next_done->store(true);
+            }, next_done, next_timed_out, 10);
+            assert_true(next_done->load(), SPOT);
+            assert_false(next_timed_out->load(), SPOT);
+            assert_true(next_id!=*expired_id, SPOT);
+        }
+        release->store(true);
+        while (!done->load())
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+};
+REGISTER(test_watchdog)
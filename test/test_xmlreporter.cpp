@@ -0,0 +1,123 @@
+#include <libunittest/all.hpp>
+#include <sstream>
+#include <regex>
+using namespace unittest::assertions;
+using unittest::core::xmlreporter;
+
+unittest::core::testresults make_sample_results();
+
+namespace {
+
+// a stream buffer that cannot seek, like the one of a pipe
+struct pipebuf : std::stringbuf {
+
+    pos_type
+    seekoff(off_type, std::ios_base::seekdir, std::ios_base::openmode)
+    {
+        return pos_type(off_type(-1));
+    }
+
+    pos_type
+    seekpos(pos_type, std::ios_base::openmode)
+    {
+        return pos_type(off_type(-1));
+    }
+
+};
+
+}
+
+struct test_xmlreporter : unittest::testcase<> {
+
+    static void run()
+    {
+        UNITTEST_CLASS(test_xmlreporter)
+        UNITTEST_RUN(test_header_written_on_construction)
+        UNITTEST_RUN(test_testcases_flushed_without_finish)
+        UNITTEST_RUN(test_finish_matches_write_xml)
+        UNITTEST_RUN(test_finish_is_idempotent)
+        UNITTEST_RUN(test_finish_without_seeking)
+    }
+
+    static std::chrono::system_clock::time_point
+    time_point()
+    {
+        return std::chrono::system_clock::from_time_t(1234567890);
+    }
+
+    static std::string
+    remove_padding(const std::string& xml)
+    {
+        return std::regex_replace(xml, std::regex("\" +>"), "\">");
+    }
+
+    void test_header_written_on_construction()
+    {
+        auto stream = std::make_shared<std::stringstream>();
+        xmlreporter reporter(stream, "peter", -1, 0, 1, time_point(), false);
+        std::ostringstream expected;
+        expected << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+        expected << "<testsuite name=\"peter\" timestamp=\"2009-02-13T23:31:30\" ";
+        expected << "tests=\"0\" errors=\"0\" failures=\"0\" timeouts=\"0\" skipped=\"0\" time=\"0.000000\">\n";
+        assert_equal(expected.str(), remove_padding(stream->str()), SPOT);
+    }
+
+    void test_testcases_flushed_without_finish()
+    {
+        const auto results = make_sample_results();
+        auto stream = std::make_shared<std::stringstream>();
+        {
+            xmlreporter reporter(stream, "peter", -1, 0, 1, time_point(), false);
+            for (const auto& log : results.testlogs)
+                reporter.report(log);
+        }
+        const auto xml = stream->str();
+        assert_true(xml.find("name=\"test1\"")!=std::string::npos, SPOT);
+        assert_true(xml.find("name=\"test3\"")!=std::string::npos, SPOT);
+        assert_true(xml.find("</testsuite>")==std::string::npos, SPOT);
+    }
+
+    void test_finish_matches_write_xml()
+    {
+        const auto results = make_sample_results();
+        auto stream = std::make_shared<std::stringstream>();
+        xmlreporter reporter(stream, "peter", 42, 1, 3, time_point(), false);
+        for (const auto& log : results.testlogs)
+            reporter.report(log);
+        reporter.finish(results);
+        std::ostringstream expected;
+        unittest::core::write_xml(expected, results, "peter", 42, time_point(), false, 1, 3);
+        assert_equal(expected.str(), remove_padding(stream->str()), SPOT);
+    }
+
+    void test_finish_is_idempotent()
+    {
+        const auto results = make_sample_results();
+        auto stream = std::make_shared<std::stringstream>();
+        xmlreporter reporter(stream, "peter", -1, 0, 1, time_point(), false);
+        reporter.finish(results);
+        const auto xml = stream->str();
+        reporter.report(results.testlogs.front());
+        reporter.finish(results);
+        assert_equal(xml, stream->str(), SPOT);
+    }
+
+    void test_finish_without_seeking()
+    {
+        const auto results = make_sample_results();
+        pipebuf buffer;
+        auto stream = std::make_shared<std::ostream>(&buffer);
+        {
+            xmlreporter reporter(stream, "peter", 42, 1, 3, time_point(), false);
+            for (const auto& log : results.testlogs)
+                reporter.report(log);
+            assert_equal("", buffer.str(), SPOT);
+            reporter.finish(results);
+        }
+        std::ostringstream expected;
+        unittest::core::write_xml(expected, results, "peter", 42, time_point(), false, 1, 3);
+        assert_equal(expected.str(), buffer.str(), SPOT);
+    }
+
+};
+REGISTER(test_xmlreporter)